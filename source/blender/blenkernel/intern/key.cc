@@ -17,8 +17,11 @@
 #include "BLI_endian_switch.h"
 #include "BLI_math_matrix.h"
 #include "BLI_math_vector.h"
+#include "BLI_math_vector_types.hh"
 #include "BLI_string_utils.hh"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "BLT_translation.hh"
 
@@ -1389,6 +1392,85 @@ static void keyblock_free_per_block_weights(Key *key,
   MEM_freeN(per_keyblock_weights);
 }
 
+/**
+ * Same as #key_evaluate_relative for meshes. The muted and zero weight blocks are skipped and the
+ * other blocks are accumulated in parallel over ranges of vertices, with contiguous loops that
+ * the compiler vectorizes.
+ */
+static void key_evaluate_relative_mesh(const int tot,
+                                       char *out,
+                                       Key *key,
+                                       KeyBlock *actkb,
+                                       float **per_keyblock_weights)
+{
+  using namespace blender;
+
+  struct RelativeBlock {
+    const float *from;
+    const float *ref;
+    float weight;
+    const float *weights;
+  };
+
+  cp_key(0, tot, tot, out, key, actkb, key->refkey, nullptr, KEY_MODE_DUMMY);
+
+  Vector<RelativeBlock> blocks;
+  Vector<char *> freedata;
+  int keyblock_index;
+  LISTBASE_FOREACH_INDEX (KeyBlock *, kb, &key->block, keyblock_index) {
+    if (kb == key->refkey || (kb->flag & KEYBLOCK_MUTE) || kb->curval == 0.0f ||
+        kb->totelem != tot)
+    {
+      continue;
+    }
+
+    /* reference now can be any block */
+    const KeyBlock *refb = static_cast<const KeyBlock *>(BLI_findlink(&key->block, kb->relative));
+    if (refb == nullptr) {
+      continue;
+    }
+
+    char *freefrom;
+    const char *from = key_block_get_data(key, actkb, kb, &freefrom);
+    if (freefrom) {
+      freedata.append(freefrom);
+    }
+
+    /* For meshes, use the original values instead of the bmesh values to
+     * maintain a constant offset. */
+    blocks.append({reinterpret_cast<const float *>(from),
+                   static_cast<const float *>(refb->data),
+                   kb->curval,
+                   per_keyblock_weights ? per_keyblock_weights[keyblock_index] : nullptr});
+  }
+
+  if (!blocks.is_empty()) {
+    float *dst = reinterpret_cast<float *>(out);
+    threading::parallel_for(IndexRange(tot), 1024, [&](const IndexRange range) {
+      for (const RelativeBlock &block : blocks) {
+        if (block.weights) {
+          for (const int i : range) {
+            const float weight = block.weights[i] * block.weight;
+            for (int j = i * 3; j < i * 3 + 3; j++) {
+              dst[j] += (block.from[j] - block.ref[j]) * weight;
+            }
+          }
+        }
+        else {
+          /* The coordinates of the range are contiguous floats. */
+          for (int j = range.first() * 3, end = range.one_after_last() * 3; j < end; j++) {
+            dst[j] += (block.from[j] - block.ref[j]) * block.weight;
+          }
+        }
+      }
+    });
+  }
+
+  for (char *data : freedata) {
+    MEM_freeN(data);
+  }
+}
+
 static void do_mesh_key(Object *ob, Key *key, char *out, const int tot)
 {
   KeyBlock *k[4], *actkb = BKE_keyblock_from_object(ob);
@@ -1399,8 +1481,7 @@ static void do_mesh_key(Object *ob, Key *key, char *out, const int tot)
     WeightsArrayCache cache = {0, nullptr};
     float **per_keyblock_weights;
     per_keyblock_weights = keyblock_get_per_block_weights(ob, key, &cache);
-    key_evaluate_relative(
-        0, tot, tot, (char *)out, key, actkb, per_keyblock_weights, KEY_MODE_DUMMY);
+    key_evaluate_relative_mesh(tot, out, key, actkb, per_keyblock_weights);
     keyblock_free_per_block_weights(key, per_keyblock_weights, &cache);
   }
   else {
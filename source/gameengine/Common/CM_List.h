@@ -27,6 +27,8 @@
 #pragma once
 
 #include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 template<class Item, class List> inline bool CM_ListRemoveIfFound(List &list, const Item &item)
 {
@@ -46,3 +48,155 @@ template<class Item, class List> inline bool CM_ListAddIfNotFound(List &list, co
   }
   return false;
 }
+
+/** List of unique pointers with constant time search, insertion and removal, in insertion order.
+ * The slot of each item is kept in a hash map. A removed item leaves a null slot skipped by the
+ * iteration, the null slots are compacted when they outnumber the items.
+ */
+template<class Item> class CM_IndexedList {
+ private:
+  std::vector<Item> m_items;
+  std::unordered_map<Item, unsigned int> m_slots;
+  /// Slot of the first item, the previous slots are null.
+  unsigned int m_first;
+
+  void Compact()
+  {
+    unsigned int slot = 0;
+    for (unsigned int i = m_first, size = m_items.size(); i < size; ++i) {
+      const Item item = m_items[i];
+      if (item) {
+        m_items[slot] = item;
+        m_slots[item] = slot;
+        ++slot;
+      }
+    }
+    m_items.resize(slot);
+    m_first = 0;
+  }
+
+ public:
+  /// Iterator over the items, skipping the null slots.
+  class const_iterator {
+   private:
+    typename std::vector<Item>::const_iterator m_pos;
+    typename std::vector<Item>::const_iterator m_end;
+
+    void SkipRemoved()
+    {
+      while (m_pos != m_end && !*m_pos) {
+        ++m_pos;
+      }
+    }
+
+   public:
+    const_iterator(typename std::vector<Item>::const_iterator pos,
+                   typename std::vector<Item>::const_iterator end)
+        : m_pos(pos), m_end(end)
+    {
+      SkipRemoved();
+    }
+
+    const_iterator &operator++()
+    {
+      ++m_pos;
+      SkipRemoved();
+      return *this;
+    }
+
+    const Item &operator*() const
+    {
+      return *m_pos;
+    }
+
+    bool operator!=(const const_iterator &other) const
+    {
+      return m_pos != other.m_pos;
+    }
+  };
+
+  CM_IndexedList() : m_first(0)
+  {
+  }
+
+  /// Return false if the item is already in the list.
+  bool Add(const Item &item)
+  {
+    if (Contains(item)) {
+      return false;
+    }
+
+    if ((m_items.size() - m_slots.size()) > m_slots.size()) {
+      Compact();
+    }
+
+    m_slots.emplace(item, m_items.size());
+    m_items.push_back(item);
+    return true;
+  }
+
+  /// Return false if the item is not in the list, the iterators stay valid.
+  bool Remove(const Item &item)
+  {
+    const typename std::unordered_map<Item, unsigned int>::iterator it = m_slots.find(item);
+    if (it == m_slots.end()) {
+      return false;
+    }
+
+    m_items[it->second] = nullptr;
+    m_slots.erase(it);
+
+    // Keep the front item valid, the list can be consumed from the front in insertion order.
+    while (m_first < m_items.size() && !m_items[m_first]) {
+      ++m_first;
+    }
+    return true;
+  }
+
+  bool Contains(const Item &item) const
+  {
+    return (m_slots.find(item) != m_slots.end());
+  }
+
+  void Clear()
+  {
+    m_items.clear();
+    m_slots.clear();
+    m_first = 0;
+  }
+
+  const Item &front() const
+  {
+    return m_items[m_first];
+  }
+
+  unsigned int size() const
+  {
+    return m_slots.size();
+  }
+
+  bool empty() const
+  {
+    return m_slots.empty();
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(m_items.begin() + m_first, m_items.end());
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator(m_items.end(), m_items.end());
+  }
+};
+
+template<class Item> inline bool CM_ListRemoveIfFound(CM_IndexedList<Item> &list, const Item &item)
+{
+  return list.Remove(item);
+}
+
+template<class Item> inline bool CM_ListAddIfNotFound(CM_IndexedList<Item> &list, const Item &item)
+{
+  return list.Add(item);
+}
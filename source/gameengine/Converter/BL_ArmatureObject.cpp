@@ -31,17 +31,23 @@
 
 #include "BL_ArmatureObject.h"
 
+#include <unordered_map>
+
 #include "ANIM_action.hh"
 #include "BKE_action.hh"
 #include "BKE_armature.hh"
 #include "BKE_constraint.h"
 #include "BKE_context.hh"
 #include "BKE_object_types.hh"
+#include "BKE_scene.hh"
+#include "BLI_math_matrix.h"
 #include "BLI_math_rotation.h"
+#include "BLI_math_vector.h"
 #include "DNA_armature_types.h"
 #include "RNA_access.hh"
 
 #include "BL_Action.h"
+#include "BL_ActionManager.h"
 #include "BL_SceneConverter.h"
 #include "KX_Globals.h"
 
@@ -126,18 +132,20 @@
 // Only allowed for Poses with identical channels.
 static void game_blend_poses(bPose *dst, bPose *src, float srcweight, short mode)
 {
-  float dstweight;
-
-  if (mode == BL_Action::ACT_BLEND_BLEND) {
-    dstweight = 1.0f - srcweight;
-  }
-  else if (mode == BL_Action::ACT_BLEND_ADD) {
-    dstweight = 1.0f;
-  }
-  else {
-    dstweight = 1.0f;
+  /* A zero weight keeps the destination pose. */
+  if (srcweight == 0.0f) {
+    dst->ctime = src->ctime;
+    return;
   }
 
+  /* The mode is tested once, the loc, size and euler blending of each channel are then plain
+   * vector operations:
+   * - blend: dst * (1 - w) + src * w, for the size too as 1 + (dst - 1) * (1 - w) + (src - 1) * w
+   *   is the same interpolation.
+   * - add: dst + src * w, the size adding its offset from 1.
+   */
+  const bool blend = (mode == BL_Action::ACT_BLEND_BLEND);
+
   bPoseChannel *schan = (bPoseChannel *)src->chanbase.first;
   for (bPoseChannel *dchan = (bPoseChannel *)dst->chanbase.first; dchan;
        dchan = (bPoseChannel *)dchan->next, schan = (bPoseChannel *)schan->next) {
@@ -152,7 +160,7 @@ static void game_blend_poses(bPose *dst, bPose *src, float srcweight, short mode
       normalize_qt(dquat);
       normalize_qt(squat);
 
-      if (mode == BL_Action::ACT_BLEND_BLEND) {
+      if (blend) {
         interp_qt_qtqt(dchan->quat, dquat, squat, srcweight);
       }
       else {
@@ -163,18 +171,26 @@ static void game_blend_poses(bPose *dst, bPose *src, float srcweight, short mode
       normalize_qt(dchan->quat);
     }
 
-    for (unsigned short i = 0; i < 3; i++) {
-      /* blending for loc and scale are pretty self-explanatory... */
-      dchan->loc[i] = (dchan->loc[i] * dstweight) + (schan->loc[i] * srcweight);
-      dchan->size[i] = 1.0f + ((dchan->size[i] - 1.0f) * dstweight) +
-                       ((schan->size[i] - 1.0f) * srcweight);
-
+    if (blend) {
+      interp_v3_v3v3(dchan->loc, dchan->loc, schan->loc, srcweight);
+      interp_v3_v3v3(dchan->size, dchan->size, schan->size, srcweight);
       /* euler-rotation interpolation done here instead... */
       // FIXME: are these results decent?
       if (schan->rotmode) {
-        dchan->eul[i] = (dchan->eul[i] * dstweight) + (schan->eul[i] * srcweight);
+        interp_v3_v3v3(dchan->eul, dchan->eul, schan->eul, srcweight);
+      }
+    }
+    else {
+      float soffset[3];
+      copy_v3_v3(soffset, schan->size);
+      add_v3_fl(soffset, -1.0f);
+      madd_v3_v3fl(dchan->loc, schan->loc, srcweight);
+      madd_v3_v3fl(dchan->size, soffset, srcweight);
+      if (schan->rotmode) {
+        madd_v3_v3fl(dchan->eul, schan->eul, srcweight);
       }
     }
+
     for (bConstraint *dcon = (bConstraint *)dchan->constraints.first,
                      *scon = (bConstraint *)schan->constraints.first;
          dcon && scon;
@@ -196,6 +212,16 @@ BL_ArmatureObject::BL_ArmatureObject()
 
 BL_ArmatureObject::~BL_ArmatureObject()
 {
+  // Free the actions before the pose pool, they give their poses back to it.
+  if (m_actionManager) {
+    delete m_actionManager;
+    m_actionManager = nullptr;
+  }
+
+  for (bPose *pose : m_posePool) {
+    BKE_pose_free(pose);
+  }
+
   m_poseChannels->Release();
   m_controlledConstraints->Release();
 
@@ -380,6 +406,10 @@ void BL_ArmatureObject::ProcessReplica()
 
   m_objArma = m_pBlenderObject;
 
+  // The pooled poses and the channel states belong to the original object.
+  m_posePool.clear();
+  m_channelStates.clear();
+
   LoadChannels();
 }
 
@@ -414,6 +444,100 @@ bool BL_ArmatureObject::UnlinkObject(SCA_IObject *clientobj)
   return res;
 }
 
+bool BL_ArmatureObject::ChannelState::Equals(const bPoseChannel *pchan) const
+{
+  return equals_v3v3(m_loc, pchan->loc) && equals_v3v3(m_size, pchan->size) &&
+         equals_v3v3(m_eul, pchan->eul) && equals_v4v4(m_quat, pchan->quat) &&
+         equals_v3v3(m_rotAxis, pchan->rotAxis) && m_rotAngle == pchan->rotAngle &&
+         m_rotmode == pchan->rotmode;
+}
+
+void BL_ArmatureObject::ChannelState::Store(const bPoseChannel *pchan)
+{
+  copy_v3_v3(m_loc, pchan->loc);
+  copy_v3_v3(m_size, pchan->size);
+  copy_v3_v3(m_eul, pchan->eul);
+  copy_qt_qt(m_quat, pchan->quat);
+  copy_v3_v3(m_rotAxis, pchan->rotAxis);
+  m_rotAngle = pchan->rotAngle;
+  m_rotmode = pchan->rotmode;
+}
+
+void BL_ArmatureObject::StoreChannelStates()
+{
+  bPose *pose = m_objArma->pose;
+
+  m_channelStates.clear();
+  std::unordered_map<const bPoseChannel *, int> indices;
+  LISTBASE_FOREACH (bPoseChannel *, pchan, &pose->chanbase) {
+    // Constraints and IK depend on other bones and objects, the whole pose is always evaluated.
+    if (pchan->constraints.first) {
+      m_channelStates.clear();
+      return;
+    }
+
+    // The channels are sorted from the roots to the children.
+    const auto it = indices.find(pchan->parent);
+    ChannelState state;
+    state.m_channel = pchan;
+    state.m_parent = (it != indices.end()) ? it->second : -1;
+    state.m_dirty = false;
+    state.Store(pchan);
+
+    indices[pchan] = m_channelStates.size();
+    m_channelStates.push_back(state);
+  }
+
+  copy_v3_v3(m_cyclicOffset, pose->cyclic_offset);
+}
+
+bool BL_ArmatureObject::EvaluateChangedChains(Depsgraph *depsgraph, Scene *scene)
+{
+  bPose *pose = m_objArma->pose;
+  const bArmature *arm = static_cast<bArmature *>(m_objArma->data);
+
+  if (m_channelStates.empty() || arm->edbo || (arm->flag & ARM_RESTPOS) ||
+      (pose->flag & POSE_RECALC) || !equals_v3v3(m_cyclicOffset, pose->cyclic_offset))
+  {
+    return false;
+  }
+
+  // Check that the channels are the ones of the states, they could have been rebuilt.
+  unsigned int index = 0;
+  LISTBASE_FOREACH (bPoseChannel *, pchan, &pose->chanbase) {
+    if (index == m_channelStates.size() || m_channelStates[index].m_channel != pchan ||
+        pchan->constraints.first)
+    {
+      return false;
+    }
+    ++index;
+  }
+  if (index != m_channelStates.size()) {
+    return false;
+  }
+
+  const float ctime = BKE_scene_ctime_get(scene);
+  for (ChannelState &state : m_channelStates) {
+    bPoseChannel *pchan = state.m_channel;
+    state.m_dirty = !state.Equals(pchan) ||
+                    (state.m_parent != -1 && m_channelStates[state.m_parent].m_dirty);
+    if (!state.m_dirty) {
+      continue;
+    }
+
+    state.Store(pchan);
+    BKE_pose_where_is_bone(depsgraph, scene, m_objArma, pchan, ctime, true);
+    // Deform matrix, as computed at the end of BKE_pose_where_is.
+    if (pchan->bone) {
+      float imat[4][4];
+      invert_m4_m4(imat, pchan->bone->arm_mat);
+      mul_m4_m4m4(pchan->chan_mat, pchan->pose_mat, imat);
+    }
+  }
+
+  return true;
+}
+
 void BL_ArmatureObject::ApplyPose()
 {
   if (m_lastapplyframe != m_lastframe) {
@@ -426,7 +550,11 @@ void BL_ArmatureObject::ApplyPose()
     UpdateBlenderObjectMatrix(m_objArma);
     bContext *C = KX_GetActiveEngine()->GetContext();
     Depsgraph *depsgraph = CTX_data_depsgraph_on_load(C);
-    BKE_pose_where_is(depsgraph, GetScene()->GetBlenderScene(), m_objArma);
+    Scene *scene = GetScene()->GetBlenderScene();
+    if (!EvaluateChangedChains(depsgraph, scene)) {
+      BKE_pose_where_is(depsgraph, scene, m_objArma);
+      StoreChannelStates();
+    }
     // restore ourself
     memcpy(m_objArma->runtime->object_to_world.ptr(), m_object_to_world, sizeof(m_object_to_world));
     m_lastapplyframe = m_lastframe;
@@ -467,26 +595,37 @@ Object *BL_ArmatureObject::GetOrigArmatureObject()
   return m_origObjArma;
 }
 
-void BL_ArmatureObject::GetPose(bPose **pose) const
+void BL_ArmatureObject::GetPose(bPose **pose)
 {
-  /* If the caller supplies a null pose, create a new one. */
+  /* If the caller supplies a null pose, take one from the pool. */
   /* Otherwise, copy the armature's pose channels into the caller-supplied pose */
 
   if (!*pose) {
-    /* probably not to good of an idea to
-     * duplicate everything, but it clears up
-     * a crash and memory leakage when
-     * &SCA_ActionActuator::m_pose is freed
-     */
-    BKE_pose_copy_data(pose, m_objArma->pose, 1);
-  }
-  else {
-    if (*pose == m_objArma->pose) {
-      // no need to copy if the pointers are the same
+    if (m_posePool.empty()) {
+      /* probably not to good of an idea to
+       * duplicate everything, but it clears up
+       * a crash and memory leakage when
+       * &SCA_ActionActuator::m_pose is freed
+       */
+      BKE_pose_copy_data(pose, m_objArma->pose, 1);
       return;
     }
 
-    extract_pose_from_pose(*pose, m_objArma->pose);
+    *pose = m_posePool.back();
+    m_posePool.pop_back();
+  }
+  else if (*pose == m_objArma->pose) {
+    // no need to copy if the pointers are the same
+    return;
+  }
+
+  extract_pose_from_pose(*pose, m_objArma->pose);
+}
+
+void BL_ArmatureObject::ReleasePose(bPose *pose)
+{
+  if (pose) {
+    m_posePool.push_back(pose);
   }
 }
 
@@ -37,7 +37,10 @@
 
 struct AnimationEvalContext;
 struct Bone;
+struct Depsgraph;
+struct Scene;
 struct bPose;
+struct bPoseChannel;
 struct Object;
 class MT_Matrix4x4;
 class BL_SceneConverter;
@@ -64,6 +67,38 @@ class BL_ArmatureObject : public KX_GameObject {
 
   double m_lastapplyframe;
 
+  /// Transform of a pose channel at the last pose evaluation.
+  struct ChannelState {
+    bPoseChannel *m_channel;
+    /// Index of the parent channel state, -1 for root channels.
+    int m_parent;
+    /// The channel or one of its parents changed in the last evaluation.
+    bool m_dirty;
+    float m_loc[3];
+    float m_size[3];
+    float m_eul[3];
+    float m_quat[4];
+    float m_rotAxis[3];
+    float m_rotAngle;
+    short m_rotmode;
+
+    bool Equals(const bPoseChannel *pchan) const;
+    void Store(const bPoseChannel *pchan);
+  };
+
+  /// Channel transforms used to evaluate only the changed bone chains in ApplyPose.
+  std::vector<ChannelState> m_channelStates;
+  float m_cyclicOffset[3];
+
+  /// Pose copies not used by any action, reused instead of allocating a pose per action.
+  std::vector<bPose *> m_posePool;
+
+  /** Evaluate only the channels whose transform changed since the last evaluation and
+   * their children. Return false when the whole pose must be evaluated.
+   */
+  bool EvaluateChangedChains(Depsgraph *depsgraph, Scene *scene);
+  void StoreChannelStates();
+
  public:
   BL_ArmatureObject();
   virtual ~BL_ArmatureObject();
@@ -77,7 +112,11 @@ class BL_ArmatureObject : public KX_GameObject {
 
   double GetLastFrame();
 
-  void GetPose(bPose **pose) const;
+  /** Copy the pose channels into the given pose, if the pose is null a pose is taken
+   * from the pool and must be given back with ReleasePose.
+   */
+  void GetPose(bPose **pose);
+  void ReleasePose(bPose *pose);
   /// Never edit this, only for accessing names.
   bPose *GetPose() const;
   void ApplyPose();
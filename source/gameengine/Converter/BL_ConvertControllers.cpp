@@ -184,7 +184,9 @@ void BL_ConvertControllers(struct Object *blenderobject,
       converter->RegisterGameController(gamecontroller, bcontr);
 
 #ifdef WITH_PYTHON
-      // When libloading, this is delayed to KX_Scene::MergeScene_LogicBrick to avoid GIL issues
+      /* When libloading, this is delayed to KX_Scene::MergeScene_LogicBrick to avoid GIL issues.
+       * The code is shared with the other scripts of same text and read from the code cache
+       * if the script was compiled in a previous run. */
       if (!libloading && bcontr->type == CONT_PYTHON) {
         SCA_PythonController *pyctrl = static_cast<SCA_PythonController *>(gamecontroller);
         /* not strictly needed but gives syntax errors early on and
@@ -101,7 +101,10 @@ void BL_Converter::SceneSlot::Merge(const BL_SceneConverter *converter)
 }
 
 BL_Converter::BL_Converter(Main *maggie, KX_KetsjiEngine *engine)
-    : m_maggie(maggie), m_ketsjiEngine(engine), m_alwaysUseExpandFraming(false)
+    : m_maxMergesPerFrame(0),
+      m_maggie(maggie),
+      m_ketsjiEngine(engine),
+      m_alwaysUseExpandFraming(false)
 {
   BKE_main_id_tag_all(maggie, ID_TAG_DOIT, false);  // avoid re-tagging later on
   m_threadinfo.m_pool = BLI_task_pool_create(nullptr, TASK_PRIORITY_LOW);
@@ -292,7 +295,7 @@ Main *BL_Converter::GetMainDynamicPath(const std::string &path) const
   return nullptr;
 }
 
-void BL_Converter::MergeAsyncLoads()
+void BL_Converter::MergeQueuedLoads(unsigned int maxMerges)
 {
   std::vector<KX_Scene *> *merge_scenes;
 
@@ -301,7 +304,12 @@ void BL_Converter::MergeAsyncLoads()
 
   m_threadinfo.m_mutex.Lock();
 
-  for (mit = m_mergequeue.begin(); mit != m_mergequeue.end(); ++mit) {
+  // The oldest loads first, the others are merged in the next frames.
+  const std::vector<KX_LibLoadStatus *>::iterator mend =
+      (maxMerges == 0 || maxMerges >= m_mergequeue.size()) ? m_mergequeue.end() :
+                                                             m_mergequeue.begin() + maxMerges;
+
+  for (mit = m_mergequeue.begin(); mit != mend; ++mit) {
     merge_scenes = (std::vector<KX_Scene *> *)(*mit)->GetData();
 
     for (sit = merge_scenes->begin(); sit != merge_scenes->end(); ++sit) {
@@ -315,17 +323,32 @@ void BL_Converter::MergeAsyncLoads()
     (*mit)->Finish();
   }
 
-  m_mergequeue.clear();
+  m_mergequeue.erase(m_mergequeue.begin(), mend);
 
   m_threadinfo.m_mutex.Unlock();
 }
 
+void BL_Converter::MergeAsyncLoads()
+{
+  MergeQueuedLoads(m_maxMergesPerFrame);
+}
+
 void BL_Converter::FinalizeAsyncLoads()
 {
   // Finish all loading libraries.
   BLI_task_pool_work_and_wait(m_threadinfo.m_pool);
   // Merge all libraries data in the current scene, to avoid memory leak of unmerged scenes.
-  MergeAsyncLoads();
+  MergeQueuedLoads(0);
+}
+
+unsigned int BL_Converter::GetMaxMergesPerFrame() const
+{
+  return m_maxMergesPerFrame;
+}
+
+void BL_Converter::SetMaxMergesPerFrame(unsigned int maxMerges)
+{
+  m_maxMergesPerFrame = maxMerges;
 }
 
 void BL_Converter::AddScenesToMergeQueue(KX_LibLoadStatus *status)
@@ -538,6 +561,9 @@ KX_LibLoadStatus *BL_Converter::LinkBlendFile(BlendHandle *bpy_openlib,
     // Handle any text datablocks
     if (options & LIB_LOAD_LOAD_SCRIPTS) {
       addImportMain(main_newlib);
+      /* Compile the imported scripts here with the GIL, an asynchronous conversion can't and
+       * their first import would otherwise compile them in the game. */
+      compilePythonModules(main_newlib);
     }
 #endif
 
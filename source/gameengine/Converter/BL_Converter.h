@@ -84,6 +84,8 @@ class BL_Converter {
   // Saved KX_LibLoadStatus objects
   std::map<std::string, KX_LibLoadStatus *> m_status_map;
   std::vector<KX_LibLoadStatus *> m_mergequeue;
+  /// Maximum number of asynchronous loads merged per frame, 0 for no limit.
+  unsigned int m_maxMergesPerFrame;
 
   Main *m_maggie;
   std::vector<Main *> m_DynamicMaggie;
@@ -91,6 +93,9 @@ class BL_Converter {
   KX_KetsjiEngine *m_ketsjiEngine;
   bool m_alwaysUseExpandFraming;
 
+  /// Merge at most maxMerges loads from the merge queue, 0 for all.
+  void MergeQueuedLoads(unsigned int maxMerges);
+
  public:
   BL_Converter(Main *maggie, KX_KetsjiEngine *engine);
   virtual ~BL_Converter();
@@ -143,10 +148,14 @@ class BL_Converter {
 
   void MergeScene(KX_Scene *to, KX_Scene *from);
 
+  /// Merge the asynchronous loads converted, limited by the maximum merges per frame.
   void MergeAsyncLoads();
   void FinalizeAsyncLoads();
   void AddScenesToMergeQueue(KX_LibLoadStatus *status);
 
+  unsigned int GetMaxMergesPerFrame() const;
+  void SetMaxMergesPerFrame(unsigned int maxMerges);
+
   void PrintStats();
 
   // LibLoad Options.
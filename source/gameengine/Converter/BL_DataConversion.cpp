@@ -940,6 +940,7 @@ static KX_GameObject *BL_gameobject_from_blenderobject(Object *ob,
       gameobj = fontobj;
 
       kxscene->GetFontList()->Add(CM_AddRef(fontobj));
+      kxscene->AddModifiedFont(fontobj);
       break;
     }
 
@@ -1611,7 +1612,9 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
       kxscene->GetPhysicsEnvironment()->SetNumTimeSubSteps(blenderscene->gm.physubstep);
   }
 
-  // Create physics information.
+  // Create physics information, the triangle mesh BVHs are built in parallel at the end.
+  PHY_IPhysicsEnvironment *physicsEnv = kxscene->GetPhysicsEnvironment();
+  physicsEnv->BeginObjectsConversion();
   for (unsigned short i = 0; i < 2; ++i) {
     const bool processCompoundChildren = (i == 1);
     for (KX_GameObject *gameobj : sumolist) {
@@ -1634,6 +1637,7 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
           gameobj, blenderobject, meshobj, kxscene, layerMask, converter, processCompoundChildren);
     }
   }
+  physicsEnv->EndObjectsConversion();
 
   // create physics joints
   for (KX_GameObject *gameobj : sumolist) {
@@ -1822,6 +1826,9 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
     }
   }
 
+  // New objects were added to the scene object list.
+  kxscene->GetActivityCullingGrid().Invalidate();
+
   // cleanup converted set of group objects
   convertedlist->Release();
   sumolist->Release();
@@ -48,7 +48,9 @@ DEV_Joystick::DEV_Joystick(short index)
       m_buttonmax(-1),
       m_isinit(0),
       m_istrig_axis(0),
-      m_istrig_button(0)
+      m_istrig_button(0),
+      m_replay(false),
+      m_replayButtons(0)
 {
   for (int i = 0; i < JOYAXIS_MAX; i++)
     m_axis_array[i] = 0;
@@ -169,20 +171,31 @@ bool DEV_Joystick::aAxisIsPositive(int axis_single)
 
 bool DEV_Joystick::aAnyButtonPressIsPositive(void)
 {
-#ifdef WITH_SDL
   /* this is needed for the "all events" option
    * so we know if there are no buttons pressed */
   for (int i = 0; i < m_buttonmax; i++) {
-    if (SDL_GameControllerGetButton(m_private->m_gamecontroller, (SDL_GameControllerButton)i)) {
+    if (pGetButton(i)) {
       return true;
     }
   }
-#endif
   return false;
 }
 
 bool DEV_Joystick::aButtonPressIsPositive(int button)
 {
+  return pGetButton(button);
+}
+
+bool DEV_Joystick::aButtonReleaseIsPositive(int button)
+{
+  return !pGetButton(button);
+}
+
+bool DEV_Joystick::pGetButton(int button)
+{
+  if (m_replay) {
+    return (button >= 0 && button < 32 && (m_replayButtons & (1u << button)));
+  }
 #ifdef WITH_SDL
   if (SDL_GameControllerGetButton(m_private->m_gamecontroller, (SDL_GameControllerButton)button)) {
     return true;
@@ -191,15 +204,61 @@ bool DEV_Joystick::aButtonPressIsPositive(int button)
   return false;
 }
 
-bool DEV_Joystick::aButtonReleaseIsPositive(int button)
+void DEV_Joystick::GetState(State &state)
 {
-#ifdef WITH_SDL
-  if (!(SDL_GameControllerGetButton(m_private->m_gamecontroller,
-                                    (SDL_GameControllerButton)button))) {
-    return true;
+  for (int i = 0; i < JOYAXIS_MAX; i++) {
+    state.m_axis[i] = m_axis_array[i];
   }
-#endif
-  return false;
+
+  state.m_buttons = 0;
+  for (int i = 0; i < m_buttonmax && i < 32; i++) {
+    if (pGetButton(i)) {
+      state.m_buttons |= (1u << i);
+    }
+  }
+
+  state.m_trigAxis = m_istrig_axis;
+  state.m_trigButton = m_istrig_button;
+}
+
+bool DEV_Joystick::SetReplayStates(const State *const (&states)[JOYINDEX_MAX],
+                                   short (&addrem)[JOYINDEX_MAX])
+{
+  bool remap = false;
+
+  for (int i = 0; i < JOYINDEX_MAX; i++) {
+    const State *state = states[i];
+    DEV_Joystick *joy = m_instance[i];
+
+    if (!state) {
+      if (joy) {
+        joy->ReleaseInstance(i);
+        addrem[i] = 2;
+        remap = true;
+      }
+      continue;
+    }
+
+    if (!joy) {
+      // A replayed joystick never opens a device.
+      joy = m_instance[i] = new DEV_Joystick(i);
+      joy->m_replay = true;
+      joy->m_isinit = true;
+      joy->m_axismax = JOYAXIS_MAX;
+      joy->m_buttonmax = JOYBUT_MAX;
+      addrem[i] = 1;
+      remap = true;
+    }
+
+    for (int j = 0; j < JOYAXIS_MAX; j++) {
+      joy->m_axis_array[j] = state->m_axis[j];
+    }
+    joy->m_replayButtons = state->m_buttons;
+    joy->m_istrig_axis = state->m_trigAxis;
+    joy->m_istrig_button = state->m_trigButton;
+  }
+
+  return remap;
 }
 
 bool DEV_Joystick::CreateJoystickDevice(void)
@@ -315,7 +374,7 @@ void DEV_Joystick::DestroyJoystickDevice(void)
 int DEV_Joystick::Connected(void)
 {
 #ifdef WITH_SDL
-  if (m_isinit && SDL_GameControllerGetAttached(m_private->m_gamecontroller)) {
+  if (m_isinit && (m_replay || SDL_GameControllerGetAttached(m_private->m_gamecontroller))) {
     return 1;
   }
 #endif
@@ -357,8 +416,12 @@ int DEV_Joystick::pAxisTest(int axisnum)
 
 const std::string DEV_Joystick::GetName()
 {
+  if (m_replay) {
+    return "Replay";
+  }
 #ifdef WITH_SDL
-  return SDL_GameControllerName(m_private->m_gamecontroller);
+  const char *name = SDL_GameControllerName(m_private->m_gamecontroller);
+  return name ? name : "";
 #else  /* WITH_SDL */
   return "";
 #endif /* WITH_SDL */
@@ -92,6 +92,11 @@ class DEV_Joystick
   bool m_istrig_axis;
   bool m_istrig_button;
 
+  /** is the joystick replaying recorded states instead of reading a device ? */
+  bool m_replay;
+  /** bit field of the pressed buttons when replaying */
+  unsigned int m_replayButtons;
+
 #ifdef WITH_SDL
   /**
    * event callbacks
@@ -121,13 +126,35 @@ class DEV_Joystick
    */
   int pGetAxis(int axisnum, int udlr);
 
+  /**
+   * returns true if the button is pressed
+   */
+  bool pGetButton(int button);
+
   DEV_Joystick(short index);
 
   ~DEV_Joystick();
 
  public:
+  /**
+   * State of a joystick during a logic frame, used to record and replay the inputs.
+   */
+  struct State {
+    int m_axis[JOYAXIS_MAX];
+    /// Bit field of the pressed buttons.
+    unsigned int m_buttons;
+    bool m_trigAxis;
+    bool m_trigButton;
+  };
+
   static DEV_Joystick *GetInstance(short joyindex);
   static bool HandleEvents(short (&addrem)[JOYINDEX_MAX]);
+  /**
+   * Replace the devices by joysticks replaying the states, a null state means no joystick
+   * at this index. Return true if joysticks were added or removed like HandleEvents.
+   */
+  static bool SetReplayStates(const State *const (&states)[JOYINDEX_MAX],
+                              short (&addrem)[JOYINDEX_MAX]);
   void ReleaseInstance(short joyindex);
   static void Init();
   static void Close();
@@ -164,6 +191,11 @@ class DEV_Joystick
     return m_istrig_button;
   }
 
+  /**
+   * Fill the current state of the joystick
+   */
+  void GetState(State &state);
+
   /**
    * Force Feedback - Vibration
    * We could add many optional arguments to these functions to take into account different sort of
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <unordered_map>
+
 #include "EXP_Value.h"
 
 class EXP_BaseListValue : public EXP_PropValue {
@@ -32,6 +34,33 @@ class EXP_BaseListValue : public EXP_PropValue {
   VectorType m_pValueArray;
   bool m_bReleaseContents;
 
+  struct IndexEntry {
+    /// Slot of the item in the array.
+    unsigned int m_slot;
+    /// Name of the item in the name index, the item could be freed when it is removed.
+    std::string m_name;
+  };
+
+  /// The items are indexed by pointer and name, an indexed list contains each item once.
+  bool m_indexed;
+  mutable std::unordered_map<EXP_Value *, IndexEntry> m_slots;
+  /// Items per name, built on demand.
+  mutable std::unordered_multimap<std::string, EXP_Value *> m_names;
+  mutable bool m_namesValid;
+  /// Null slots left by the items removed from an indexed list, until the list is compacted.
+  unsigned int m_numRemoved;
+  /// First null slot left by a removal.
+  unsigned int m_firstRemoved;
+
+  void IndexValue(unsigned int slot);
+  void UnindexValue(EXP_Value *val);
+  /// Update the slots of the items from the given slot.
+  void IndexSlots(unsigned int start);
+  void RebuildIndex();
+  void UpdateNameIndex() const;
+  /// Remove the null slots left by the removed items, keeping the order of the list.
+  void Compact();
+
   void SetValue(int i, EXP_Value *val);
   EXP_Value *GetValue(int i);
   EXP_Value *FindValue(const std::string &name) const;
@@ -50,6 +79,13 @@ class EXP_BaseListValue : public EXP_PropValue {
   virtual std::string GetText();
 
   void SetReleaseOnDestruct(bool bReleaseContents);
+  /** Index the items to search, find by name and remove them in constant time.
+   * A removed item leaves a null slot, the slots are compacted in order on the next access
+   * by index or iteration.
+   */
+  void SetIndexed(bool indexed);
+  /// Update the name index after the value was renamed.
+  void UpdateValueName(EXP_Value *val);
 
   void Remove(int i);
   void Resize(int num);
@@ -65,6 +65,7 @@ template<class ItemType> class EXP_ListValue : public EXP_BaseListValue {
 
   virtual EXP_ListValue<ItemType> *GetReplica()
   {
+    Compact();
     EXP_ListValue<ItemType> *replica = new EXP_ListValue<ItemType>(*this);
 
     replica->ProcessReplica();
@@ -76,6 +77,7 @@ template<class ItemType> class EXP_ListValue : public EXP_BaseListValue {
     for (unsigned int i = 0; i < numelements; i++) {
       replica->m_pValueArray[i] = m_pValueArray[i]->GetReplica();
     }
+    replica->RebuildIndex();
 
     return replica;
   }
@@ -92,6 +94,7 @@ template<class ItemType> class EXP_ListValue : public EXP_BaseListValue {
 
   ItemType *FindIf(std::function<bool(ItemType *)> function)
   {
+    Compact();
     for (EXP_Value *val : m_pValueArray) {
       ItemType *item = static_cast<ItemType *>(val);
       if (function(item)) {
@@ -146,19 +149,23 @@ template<class ItemType> class EXP_ListValue : public EXP_BaseListValue {
 
   ItemType *GetFront()
   {
+    Compact();
     return static_cast<ItemType *>(m_pValueArray.front());
   }
   ItemType *GetBack()
   {
+    Compact();
     return static_cast<ItemType *>(m_pValueArray.back());
   }
 
   const_iterator begin()
   {
+    Compact();
     return const_iterator(m_pValueArray.begin());
   }
   const_iterator end()
   {
+    Compact();
     return const_iterator(m_pValueArray.end());
   }
 };
@@ -114,6 +114,12 @@ class EXP_Value : public EXP_PyObjectPlus, public CM_RefCount<EXP_Value> {
   static PyObject *pyattr_get_name(EXP_PyObjectPlus *self, const EXP_PYATTRIBUTE_DEF *attrdef);
 
   virtual PyObject *ConvertKeysToPython(void);
+
+  /** Get the property named by a python string, returns nullptr if there is no such property.
+   * Interned strings, e.g. the string literals of scripts, are looked up in a small cache
+   * indexed by the string object.
+   */
+  EXP_Value *GetPropertyFromPython(PyObject *key);
 #endif  // WITH_PYTHON
 
   /// Expression Calculation
@@ -167,8 +173,53 @@ class EXP_Value : public EXP_PyObjectPlus, public CM_RefCount<EXP_Value> {
   virtual void DestructFromPython();
 
  private:
+  /// The transparent comparator allows lookup without string allocation.
+  typedef std::map<std::string, EXP_Value *, std::less<>> PropertyMap;
+
   /// Properties for user/game etc.
-  std::map<std::string, EXP_Value *> m_properties;
+  PropertyMap m_properties;
+
+#ifdef WITH_PYTHON
+  /// Direct mapped cache of property iterators indexed by python string, see GetPropertyFromPython().
+  class PropertyCache {
+   public:
+    enum { SIZE = 8 };
+
+    struct Entry {
+      PyObject *m_key;
+      PropertyMap::iterator m_it;
+    };
+
+    /// Allocated on first lookup.
+    Entry *m_entries;
+
+    PropertyCache() : m_entries(nullptr)
+    {
+    }
+    /// The iterators belong to the property map of the copied value, they are never copied.
+    PropertyCache(const PropertyCache &other) : m_entries(nullptr)
+    {
+    }
+    PropertyCache &operator=(const PropertyCache &other)
+    {
+      Clear();
+      return *this;
+    }
+    ~PropertyCache()
+    {
+      delete[] m_entries;
+    }
+
+    /// Invalidate all entries, needed when a property is erased.
+    void Clear()
+    {
+      delete[] m_entries;
+      m_entries = nullptr;
+    }
+  };
+
+  PropertyCache m_propertyCache;
+#endif  // WITH_PYTHON
 };
 
 /** EXP_PropValue is a EXP_Value derived class, that implements the identification (String name)
@@ -178,7 +229,24 @@ class EXP_Value : public EXP_PyObjectPlus, public CM_RefCount<EXP_Value> {
  */
 class EXP_PropValue : public EXP_Value {
  public:
-  EXP_PropValue()
+  /// Receiver of the modifications of a value, e.g. the owner of a property.
+  class Observer {
+   public:
+    virtual ~Observer()
+    {
+    }
+
+    /// Called when the value is modified in place, e.g. by SetValue.
+    virtual void ValueModified(EXP_PropValue *value) = 0;
+  };
+
+  EXP_PropValue() : m_observer(nullptr)
+  {
+  }
+
+  /// The observer is not copied, it observes only the original value.
+  EXP_PropValue(const EXP_PropValue &other)
+      : EXP_Value(other), m_strNewName(other.m_strNewName), m_observer(nullptr)
   {
   }
 
@@ -186,6 +254,16 @@ class EXP_PropValue : public EXP_Value {
   {
   }
 
+  void SetObserver(Observer *observer)
+  {
+    m_observer = observer;
+  }
+
+  Observer *GetObserver() const
+  {
+    return m_observer;
+  }
+
   virtual void SetName(const std::string &name)
   {
     m_strNewName = name;
@@ -198,4 +276,13 @@ class EXP_PropValue : public EXP_Value {
 
  protected:
   std::string m_strNewName;
+  Observer *m_observer;
+
+  /// To call when the value is modified in place.
+  void TagModified()
+  {
+    if (m_observer) {
+      m_observer->ValueModified(this);
+    }
+  }
 };
@@ -21,12 +21,18 @@
 
 #include "EXP_ListValue.h"
 
-EXP_BaseListValue::EXP_BaseListValue() : m_bReleaseContents(true)
+EXP_BaseListValue::EXP_BaseListValue()
+    : m_bReleaseContents(true),
+      m_indexed(false),
+      m_namesValid(false),
+      m_numRemoved(0),
+      m_firstRemoved(0)
 {
 }
 
 EXP_BaseListValue::~EXP_BaseListValue()
 {
+  Compact();
   if (m_bReleaseContents) {
     for (EXP_Value *item : m_pValueArray) {
       item->Release();
@@ -34,18 +40,136 @@ EXP_BaseListValue::~EXP_BaseListValue()
   }
 }
 
+void EXP_BaseListValue::IndexValue(unsigned int slot)
+{
+  EXP_Value *val = m_pValueArray[slot];
+  BLI_assert(m_slots.find(val) == m_slots.end());
+
+  IndexEntry &entry = m_slots[val];
+  entry.m_slot = slot;
+  if (m_namesValid) {
+    entry.m_name = val->GetName();
+    m_names.emplace(entry.m_name, val);
+  }
+}
+
+void EXP_BaseListValue::UnindexValue(EXP_Value *val)
+{
+  const std::unordered_map<EXP_Value *, IndexEntry>::iterator it = m_slots.find(val);
+  if (m_namesValid) {
+    // Don't use the value, it could be already freed.
+    const auto range = m_names.equal_range(it->second.m_name);
+    for (auto nameIt = range.first; nameIt != range.second; ++nameIt) {
+      if (nameIt->second == val) {
+        m_names.erase(nameIt);
+        break;
+      }
+    }
+  }
+  m_slots.erase(it);
+}
+
+void EXP_BaseListValue::IndexSlots(unsigned int start)
+{
+  for (unsigned int i = start, size = m_pValueArray.size(); i < size; ++i) {
+    m_slots[m_pValueArray[i]].m_slot = i;
+  }
+}
+
+void EXP_BaseListValue::RebuildIndex()
+{
+  Compact();
+  m_slots.clear();
+  m_names.clear();
+  m_namesValid = false;
+
+  if (m_indexed) {
+    m_slots.reserve(m_pValueArray.size());
+    for (unsigned int i = 0, size = m_pValueArray.size(); i < size; ++i) {
+      if (m_pValueArray[i]) {
+        m_slots[m_pValueArray[i]].m_slot = i;
+      }
+    }
+  }
+}
+
+void EXP_BaseListValue::UpdateNameIndex() const
+{
+  if (m_namesValid) {
+    return;
+  }
+
+  m_names.clear();
+  m_names.reserve(m_slots.size());
+  for (std::pair<EXP_Value *const, IndexEntry> &pair : m_slots) {
+    pair.second.m_name = pair.first->GetName();
+    m_names.emplace(pair.second.m_name, pair.first);
+  }
+  m_namesValid = true;
+}
+
+void EXP_BaseListValue::Compact()
+{
+  if (m_numRemoved == 0) {
+    return;
+  }
+
+  unsigned int slot = m_firstRemoved;
+  for (unsigned int i = m_firstRemoved + 1, size = m_pValueArray.size(); i < size; ++i) {
+    EXP_Value *val = m_pValueArray[i];
+    if (val) {
+      m_pValueArray[slot] = val;
+      m_slots[val].m_slot = slot;
+      ++slot;
+    }
+  }
+  m_pValueArray.resize(slot);
+  m_numRemoved = 0;
+}
+
 void EXP_BaseListValue::SetValue(int i, EXP_Value *val)
 {
+  Compact();
+  if (m_indexed) {
+    EXP_Value *old = m_pValueArray[i];
+    if (old) {
+      UnindexValue(old);
+    }
+    m_pValueArray[i] = val;
+    if (val) {
+      IndexValue(i);
+    }
+    return;
+  }
+
   m_pValueArray[i] = val;
 }
 
 EXP_Value *EXP_BaseListValue::GetValue(int i)
 {
+  Compact();
   return m_pValueArray[i];
 }
 
 EXP_Value *EXP_BaseListValue::FindValue(const std::string &name) const
 {
+  if (m_indexed) {
+    UpdateNameIndex();
+    /* Return the first item of the list using this name, as the linear search does. The
+     * null slots of the removed items don't change the order of the slots. */
+    EXP_Value *result = nullptr;
+    unsigned int resultSlot = 0;
+    const auto range = m_names.equal_range(name);
+    for (auto it = range.first; it != range.second; ++it) {
+      const unsigned int slot = m_slots.at(it->second).m_slot;
+      if (!result || slot < resultSlot) {
+        result = it->second;
+        resultSlot = slot;
+      }
+    }
+    return result;
+  }
+
   const VectorTypeConstIterator it = std::find_if(
       m_pValueArray.begin(), m_pValueArray.end(), [&name](EXP_Value *item) {
         return item->GetName() == name;
@@ -59,21 +183,55 @@ EXP_Value *EXP_BaseListValue::FindValue(const std::string &name) const
 
 bool EXP_BaseListValue::SearchValue(EXP_Value *val) const
 {
+  if (m_indexed) {
+    return (m_slots.find(val) != m_slots.end());
+  }
   return (std::find(m_pValueArray.begin(), m_pValueArray.end(), val) != m_pValueArray.end());
 }
 
 void EXP_BaseListValue::Add(EXP_Value *value)
 {
+  // Don't let the null slots grow over the number of items when the list is never accessed.
+  if (m_numRemoved > m_slots.size()) {
+    Compact();
+  }
+
   m_pValueArray.push_back(value);
+  if (m_indexed) {
+    IndexValue(m_pValueArray.size() - 1);
+  }
 }
 
 void EXP_BaseListValue::Insert(unsigned int i, EXP_Value *value)
 {
+  Compact();
   m_pValueArray.insert(m_pValueArray.begin() + i, value);
+  if (m_indexed) {
+    IndexValue(i);
+    IndexSlots(i + 1);
+  }
 }
 
 bool EXP_BaseListValue::RemoveValue(EXP_Value *val)
 {
+  if (m_indexed) {
+    const std::unordered_map<EXP_Value *, IndexEntry>::iterator it = m_slots.find(val);
+    if (it == m_slots.end()) {
+      return false;
+    }
+
+    const unsigned int slot = it->second.m_slot;
+    UnindexValue(val);
+
+    // Keep the order of the list, the null slot is removed at the next compaction.
+    m_pValueArray[slot] = nullptr;
+    if (m_numRemoved == 0 || slot < m_firstRemoved) {
+      m_firstRemoved = slot;
+    }
+    ++m_numRemoved;
+    return true;
+  }
+
   bool result = false;
   for (VectorTypeIterator it = m_pValueArray.begin(); it != m_pValueArray.end();) {
     if (*it == val) {
@@ -104,6 +262,8 @@ bool EXP_BaseListValue::CheckEqual(EXP_Value *first, EXP_Value *second)
 
 std::string EXP_BaseListValue::GetText()
 {
+  Compact();
+
   std::string strListRep = "[";
   std::string commastr = "";
 
@@ -127,27 +287,72 @@ void EXP_BaseListValue::SetReleaseOnDestruct(bool bReleaseContents)
   m_bReleaseContents = bReleaseContents;
 }
 
+void EXP_BaseListValue::SetIndexed(bool indexed)
+{
+  m_indexed = indexed;
+  RebuildIndex();
+}
+
+void EXP_BaseListValue::UpdateValueName(EXP_Value *val)
+{
+  if (!m_indexed || !m_namesValid) {
+    return;
+  }
+
+  const std::unordered_map<EXP_Value *, IndexEntry>::iterator it = m_slots.find(val);
+  if (it == m_slots.end()) {
+    return;
+  }
+
+  const auto range = m_names.equal_range(it->second.m_name);
+  for (auto nameIt = range.first; nameIt != range.second; ++nameIt) {
+    if (nameIt->second == val) {
+      m_names.erase(nameIt);
+      break;
+    }
+  }
+  it->second.m_name = val->GetName();
+  m_names.emplace(it->second.m_name, val);
+}
+
 void EXP_BaseListValue::Remove(int i)
 {
+  Compact();
+  if (m_indexed && m_pValueArray[i]) {
+    UnindexValue(m_pValueArray[i]);
+  }
   m_pValueArray.erase(m_pValueArray.begin() + i);
+  if (m_indexed) {
+    IndexSlots(i);
+  }
 }
 
 void EXP_BaseListValue::Resize(int num)
 {
+  Compact();
+  if (m_indexed) {
+    for (int i = num, size = m_pValueArray.size(); i < size; ++i) {
+      if (m_pValueArray[i]) {
+        UnindexValue(m_pValueArray[i]);
+      }
+    }
+  }
   m_pValueArray.resize(num);
 }
 
 void EXP_BaseListValue::ReleaseAndRemoveAll()
 {
+  Compact();
   for (EXP_Value *item : m_pValueArray) {
     item->Release();
   }
   m_pValueArray.clear();
+  RebuildIndex();
 }
 
 int EXP_BaseListValue::GetCount() const
 {
-  return m_pValueArray.size();
+  return m_pValueArray.size() - m_numRemoved;
 }
 
 #ifdef WITH_PYTHON
@@ -469,7 +674,11 @@ PyObject *EXP_BaseListValue::Pyreverse()
     return nullptr;
   }
 
+  Compact();
   std::reverse(m_pValueArray.begin(), m_pValueArray.end());
+  if (m_indexed) {
+    IndexSlots(0);
+  }
   Py_RETURN_NONE;
 }
 
@@ -576,6 +785,7 @@ PyObject *EXP_BaseListValue::Pyfilter(PyObject *args)
   EXP_ListValue<EXP_Value> *result = new EXP_ListValue<EXP_Value>();
   result->SetReleaseOnDestruct(false);
 
+  Compact();
   for (EXP_Value *item : m_pValueArray) {
     if (strlen(namestr) == 0 || std::regex_match(item->GetName(), namereg)) {
       if (strlen(propstr) == 0) {
@@ -606,7 +816,7 @@ PyObject *EXP_BaseListValue::Pyfrom_id(PyObject *value)
 
   int numelem = GetCount();
   for (int i = 0; i < numelem; i++) {
-    if (reinterpret_cast<uintptr_t>(m_pValueArray[i]->m_proxy) == id) {
+    if (reinterpret_cast<uintptr_t>(GetValue(i)->m_proxy) == id) {
       return GetValue(i)->GetProxy();
     }
   }
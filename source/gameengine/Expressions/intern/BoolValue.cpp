@@ -41,6 +41,7 @@ EXP_BoolValue::EXP_BoolValue(bool innie, const std::string &name) : m_bool(innie
 void EXP_BoolValue::SetValue(EXP_Value *newval)
 {
   m_bool = (newval->GetNumber() != 0);
+  TagModified();
 }
 
 EXP_Value *EXP_BoolValue::Calc(VALUE_OPERATOR op, EXP_Value *val)
@@ -20,6 +20,8 @@
 
 #include "EXP_Value.h"
 
+#include <string_view>
+
 #include "EXP_BoolValue.h"
 #include "EXP_ErrorValue.h"
 #include "EXP_FloatValue.h"
@@ -168,7 +170,7 @@ void EXP_Value::SetProperty(const std::string &name, EXP_Value *ioProperty)
 /// <inName>.
 EXP_Value *EXP_Value::GetProperty(const std::string &inName)
 {
-  std::map<std::string, EXP_Value *>::iterator it = m_properties.find(inName);
+  PropertyMap::iterator it = m_properties.find(inName);
   if (it != m_properties.end()) {
     return it->second;
   }
@@ -203,10 +205,13 @@ float EXP_Value::GetPropertyNumber(const std::string &inName, float defnumber)
 /// if property was not found or could not be removed.
 bool EXP_Value::RemoveProperty(const std::string &inName)
 {
-  std::map<std::string, EXP_Value *>::iterator it = m_properties.find(inName);
+  PropertyMap::iterator it = m_properties.find(inName);
   if (it != m_properties.end()) {
     (*it).second->Release();
     m_properties.erase(it);
+#ifdef WITH_PYTHON
+    m_propertyCache.Clear();
+#endif
     return true;
   }
 
@@ -236,6 +241,9 @@ void EXP_Value::ClearProperties()
 
   // Delete property array.
   m_properties.clear();
+#ifdef WITH_PYTHON
+  m_propertyCache.Clear();
+#endif
 }
 
 /// Get property number <inIndex>.
@@ -370,6 +378,45 @@ EXP_Value *EXP_Value::ConvertPythonToValue(PyObject *pyobj,
   return vallie;
 }
 
+EXP_Value *EXP_Value::GetPropertyFromPython(PyObject *key)
+{
+  Py_ssize_t size;
+  const char *str = PyUnicode_AsUTF8AndSize(key, &size);
+  if (!str) {
+    return nullptr;
+  }
+  const std::string_view name(str, size);
+
+  // Only interned strings are likely to be looked up again with the same object.
+  if (!PyUnicode_CHECK_INTERNED(key)) {
+    PropertyMap::iterator it = m_properties.find(name);
+    return (it != m_properties.end()) ? it->second : nullptr;
+  }
+
+  if (!m_propertyCache.m_entries) {
+    m_propertyCache.m_entries = new PropertyCache::Entry[PropertyCache::SIZE]();
+  }
+
+  PropertyCache::Entry &entry =
+      m_propertyCache.m_entries[(((uintptr_t)key) >> 4) % PropertyCache::SIZE];
+  /* The key is not referenced, its address could have been reused by another string
+   * so the name is still compared, but the map search is avoided. */
+  if (entry.m_key == key && entry.m_it->first == name) {
+    return entry.m_it->second;
+  }
+
+  PropertyMap::iterator it = m_properties.find(name);
+  if (it == m_properties.end()) {
+    return nullptr;
+  }
+
+  // Map iterators are only invalidated by erasure which clears the cache.
+  entry.m_key = key;
+  entry.m_it = it;
+
+  return it->second;
+}
+
 PyObject *EXP_Value::ConvertKeysToPython(void)
 {
   PyObject *pylist = PyList_New(m_properties.size());
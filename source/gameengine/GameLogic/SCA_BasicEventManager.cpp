@@ -35,19 +35,74 @@
 
 #include "SCA_BasicEventManager.h"
 
+#include "BLI_task.h"
+
 #include "SCA_ISensor.h"
 
+/// Number of sensor queries run by a task, a ray test is too short to be a task alone.
+static const unsigned int querySensorsPerTask = 8;
+
 SCA_BasicEventManager::SCA_BasicEventManager(class SCA_LogicManager *logicmgr)
-    : SCA_EventManager(logicmgr, BASIC_EVENTMGR)
+    : SCA_EventManager(logicmgr, BASIC_EVENTMGR), m_queryTaskPool(nullptr)
 {
 }
 
 SCA_BasicEventManager::~SCA_BasicEventManager()
 {
+  if (m_queryTaskPool) {
+    BLI_task_pool_free(m_queryTaskPool);
+  }
+}
+
+void SCA_BasicEventManager::QueryTask(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  QueryTaskData *data = (QueryTaskData *)taskdata;
+  for (unsigned int i = 0; i < data->m_count; ++i) {
+    data->m_sensors[i]->RunQuery();
+  }
+}
+
+void SCA_BasicEventManager::RunQueries()
+{
+  m_querySensors.clear();
+  for (SCA_ISensor *sensor : m_sensors) {
+    if (sensor->HasQuery() && sensor->NeedEvaluate()) {
+      m_querySensors.push_back(sensor);
+    }
+  }
+
+  const unsigned int count = m_querySensors.size();
+  // Not enough queries to be worth the threads, the sensors run them in Evaluate.
+  if (count <= querySensorsPerTask) {
+    return;
+  }
+
+  /* All the sensors of the manager query the same scene, the queries are run in
+   * Evaluate when the scene doesn't support parallel queries. */
+  if (!m_querySensors[0]->SupportsParallelQueries()) {
+    return;
+  }
+
+  m_queryTasks.clear();
+  for (unsigned int i = 0; i < count; i += querySensorsPerTask) {
+    m_queryTasks.push_back({&m_querySensors[i], std::min(querySensorsPerTask, count - i)});
+  }
+
+  if (!m_queryTaskPool) {
+    m_queryTaskPool = BLI_task_pool_create(nullptr, TASK_PRIORITY_HIGH);
+  }
+  for (QueryTaskData &task : m_queryTasks) {
+    BLI_task_pool_push(m_queryTaskPool, QueryTask, &task, false, nullptr);
+  }
+  BLI_task_pool_work_and_wait(m_queryTaskPool);
 }
 
 void SCA_BasicEventManager::NextFrame()
 {
+  /* The sensors only read the scene in their queries and the controllers are triggered
+   * after all the sensors are evaluated, so the queries can be run together before. */
+  RunQueries();
+
   for (SCA_ISensor *sensor : m_sensors) {
     sensor->Activate(m_logicmgr);
   }
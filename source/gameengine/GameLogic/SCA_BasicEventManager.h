@@ -36,7 +36,26 @@
 
 #include "SCA_EventManager.h"
 
+struct TaskPool;
+
 class SCA_BasicEventManager : public SCA_EventManager {
+ private:
+  /// Range of sensors of which the queries are run by a task.
+  struct QueryTaskData {
+    SCA_ISensor **m_sensors;
+    unsigned int m_count;
+  };
+
+  /// Sensors of which the query is run in parallel in the current frame.
+  std::vector<SCA_ISensor *> m_querySensors;
+  std::vector<QueryTaskData> m_queryTasks;
+  /// Task pool of the queries, kept between frames.
+  TaskPool *m_queryTaskPool;
+
+  static void QueryTask(TaskPool *__restrict pool, void *taskdata);
+
+  void RunQueries();
+
  public:
   SCA_BasicEventManager(class SCA_LogicManager *logicmgr);
   ~SCA_BasicEventManager();
@@ -35,6 +35,7 @@
 #include "SCA_CollisionSensor.h"
 
 #include "KX_CollisionEventManager.h"
+#include "KX_PyMath.h"
 #include "PHY_IPhysicsController.h"
 #include "PHY_IPhysicsEnvironment.h"
 #include "RAS_MeshObject.h"
@@ -55,6 +56,18 @@ void SCA_CollisionSensor::EndFrame()
   m_hitObject = nullptr;
   m_bTriggered = false;
   m_bColliderHash = 0;
+  m_contacts = nullptr;
+  m_numContacts = 0;
+  m_contactPoints = nullptr;
+}
+
+void SCA_CollisionSensor::SetContacts(const SCA_CollisionContact *contacts,
+                                      unsigned int numContacts,
+                                      const SCA_CollisionContactPoint *contactPoints)
+{
+  m_contacts = contacts;
+  m_numContacts = numContacts;
+  m_contactPoints = contactPoints;
 }
 
 void SCA_CollisionSensor::UnregisterToManager()
@@ -122,6 +135,9 @@ void SCA_CollisionSensor::Init()
   m_bLastCount = 0;
   m_bColliderHash = m_bLastColliderHash = 0;
   m_hitObject = nullptr;
+  m_contacts = nullptr;
+  m_numContacts = 0;
+  m_contactPoints = nullptr;
   m_reset = true;
 }
 
@@ -272,6 +288,7 @@ bool SCA_CollisionSensor::NewHandleCollision(PHY_IPhysicsController *ctrl1,
       m_bTriggered = true;
       m_hitObject = gameobj;
       m_hitMaterial = hitMaterial;
+      return true;
     }
   }
   return false;
@@ -333,6 +350,7 @@ PyAttributeDef SCA_CollisionSensor::Attributes[] = {
     EXP_PYATTRIBUTE_STRING_RO("hitMaterial", SCA_CollisionSensor, m_hitMaterial),
     EXP_PYATTRIBUTE_RO_FUNCTION("hitObject", SCA_CollisionSensor, pyattr_get_object_hit),
     EXP_PYATTRIBUTE_RO_FUNCTION("hitObjectList", SCA_CollisionSensor, pyattr_get_object_hit_list),
+    EXP_PYATTRIBUTE_RO_FUNCTION("contacts", SCA_CollisionSensor, pyattr_get_contacts),
     EXP_PYATTRIBUTE_NULL  // Sentinel
 };
 
@@ -358,4 +376,34 @@ PyObject *SCA_CollisionSensor::pyattr_get_object_hit_list(EXP_PyObjectPlus *self
   return self->m_colliders->GetProxy();
 }
 
+PyObject *SCA_CollisionSensor::pyattr_get_contacts(EXP_PyObjectPlus *self_v,
+                                                   const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  SCA_CollisionSensor *self = static_cast<SCA_CollisionSensor *>(self_v);
+
+  unsigned int size = 0;
+  for (unsigned int i = 0; i < self->m_numContacts; ++i) {
+    size += self->m_contacts[i].m_numPoints;
+  }
+
+  // The points are copied as the contact point table is cleared at the end of the frame.
+  PyObject *list = PyList_New(size);
+  unsigned int index = 0;
+  for (unsigned int i = 0; i < self->m_numContacts; ++i) {
+    const SCA_CollisionContact &contact = self->m_contacts[i];
+    for (unsigned int j = 0; j < contact.m_numPoints; ++j) {
+      const SCA_CollisionContactPoint &point = self->m_contactPoints[contact.m_firstPoint + j];
+      PyList_SET_ITEM(list,
+                      index++,
+                      Py_BuildValue("(NNNf)",
+                                    contact.m_object->GetProxy(),
+                                    PyObjectFrom(point.m_worldPoint),
+                                    PyObjectFrom(point.m_normal),
+                                    point.m_appliedImpulse));
+    }
+  }
+
+  return list;
+}
+
 #endif
@@ -34,6 +34,7 @@
 
 #include "EXP_ListValue.h"
 #include "KX_ClientObjectInfo.h"
+#include "MT_Vector3.h"
 #include "SCA_ISensor.h"
 
 class PHY_ICollData;
@@ -45,6 +46,27 @@ typedef unsigned long uint_ptr;
 #endif
 
 class KX_CollisionEventManager;
+class SCA_CollisionSensor;
+
+/** Contact point of a collision sensor, copied from the collision data as the physics can free
+ * it during the logic frame, e.g. when a controller suspends the physics of an object.
+ */
+struct SCA_CollisionContactPoint {
+  MT_Vector3 m_worldPoint;
+  /// Normal seen from the sensor object.
+  MT_Vector3 m_normal;
+  float m_appliedImpulse;
+};
+
+/// Contact of a collision sensor with an object, stored by the collision event manager.
+struct SCA_CollisionContact {
+  SCA_CollisionSensor *m_sensor;
+  /// The other object, kept alive by the colliders list of the sensor.
+  KX_GameObject *m_object;
+  /// Range of the contact points in the contact point table of the event manager.
+  unsigned int m_firstPoint;
+  unsigned int m_numPoints;
+};
 
 class SCA_CollisionSensor : public SCA_ISensor {
  protected:
@@ -73,6 +95,12 @@ class SCA_CollisionSensor : public SCA_ISensor {
   EXP_ListValue<KX_GameObject> *m_colliders;
   std::string m_hitMaterial;
 
+  /// Span of the contacts of the current frame in the event manager.
+  const SCA_CollisionContact *m_contacts;
+  unsigned int m_numContacts;
+  /// Contact point table of the event manager, indexed by the contacts.
+  const SCA_CollisionContactPoint *m_contactPoints;
+
  public:
   SCA_CollisionSensor(class SCA_EventManager *eventmgr,
                       class KX_GameObject *gameobj,
@@ -92,10 +120,16 @@ class SCA_CollisionSensor : public SCA_ISensor {
   virtual void UnregisterSumo(KX_CollisionEventManager *collisionman);
   virtual void UnregisterToManager();
 
+  /// Return true if the collision was recorded and its contacts must be given to the sensor.
   virtual bool NewHandleCollision(PHY_IPhysicsController *ctrl1,
                                   PHY_IPhysicsController *ctrl2,
                                   const PHY_ICollData *colldata);
 
+  /// Set the contacts of the current frame and their points, valid until EndFrame.
+  void SetContacts(const SCA_CollisionContact *contacts,
+                   unsigned int numContacts,
+                   const SCA_CollisionContactPoint *contactPoints);
+
   // Allows to do pre-filtering and save computation time
   // obj1 = sensor physical controller, obj2 = physical controller of second object
   // return value = true if collision should be checked on pair of object
@@ -135,6 +169,8 @@ class SCA_CollisionSensor : public SCA_ISensor {
                                          const EXP_PYATTRIBUTE_DEF *attrdef);
   static PyObject *pyattr_get_object_hit_list(EXP_PyObjectPlus *self_v,
                                               const EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_contacts(EXP_PyObjectPlus *self_v,
+                                       const EXP_PYATTRIBUTE_DEF *attrdef);
 
 #endif
 };
@@ -169,6 +169,11 @@ const std::wstring &SCA_IInputDevice::GetText() const
   return m_text;
 }
 
+void SCA_IInputDevice::SetText(const std::wstring &text)
+{
+  m_text = text;
+}
+
 const char SCA_IInputDevice::ConvertKeyToChar(SCA_IInputDevice::SCA_EnumInputs input, bool shifted)
 {
   std::map<SCA_EnumInputs, std::pair<char, char>>::iterator it = m_keyToChar.find(input);
@@ -238,6 +238,8 @@ class SCA_IInputDevice {
 
   /// Return typed unicode text during a frame.
   const std::wstring &GetText() const;
+  /// Replace the typed text of the frame, used to replay recorded inputs.
+  void SetText(const std::wstring &text);
 
   static const char ConvertKeyToChar(SCA_EnumInputs input, bool shifted);
 };
@@ -118,6 +118,25 @@ SCA_ISensor::sensortype SCA_ISensor::GetSensorType()
   return ST_NONE;
 }
 
+bool SCA_ISensor::HasQuery() const
+{
+  return false;
+}
+
+void SCA_ISensor::RunQuery()
+{
+}
+
+bool SCA_ISensor::SupportsParallelQueries() const
+{
+  return true;
+}
+
+bool SCA_ISensor::NeedEvaluate() const
+{
+  return (m_links && !m_suspended);
+}
+
 void SCA_ISensor::Suspend()
 {
   m_suspended = true;
@@ -254,7 +273,7 @@ void SCA_ISensor::Activate(class SCA_LogicManager *logicmgr)
   /* Calculate if a __triggering__ is wanted
    * don't evaluate a sensor that is not connected to any controller
    */
-  if (m_links && !m_suspended) {
+  if (NeedEvaluate()) {
     bool result = this->Evaluate();
     // store the state for the rest of the logic system
     m_prev_state = m_state;
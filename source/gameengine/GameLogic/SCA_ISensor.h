@@ -141,6 +141,21 @@ class SCA_ISensor : public SCA_ILogicBrick {
 
   virtual sensortype GetSensorType();
 
+  /** Return true if the sensor queries the scene in RunQuery, the queries of the sensors
+   * of an event manager are run in parallel before evaluating the sensors.
+   */
+  virtual bool HasQuery() const;
+  /** Compute the scene query used by the next Evaluate. Called from any thread, it must
+   * only read the scene and write the sensor.
+   */
+  virtual void RunQuery();
+  /** Return true if the queries of the sensors of the scene can run in parallel in the
+   * current frame.
+   */
+  virtual bool SupportsParallelQueries() const;
+  /// Return true if the sensor is evaluated in Activate.
+  bool NeedEvaluate() const;
+
   /// Stop sensing for a while.
   void Suspend();
 
@@ -101,9 +101,9 @@ class SCA_MouseFocusSensor : public SCA_MouseSensor {
   };
 
   /// \see KX_RayCast
-  bool RayHit(KX_ClientObjectInfo *client, KX_RayCast *result, void */*data*/);
+  bool RayHit(KX_ClientObjectInfo *client, KX_RayCast *result, void * /*data*/);
   /// \see KX_RayCast
-  bool NeedRayCast(KX_ClientObjectInfo *client, void */*data*/);
+  bool NeedRayCast(KX_ClientObjectInfo *client, void * /*data*/);
 
   const MT_Vector3 &RaySource() const;
   const MT_Vector3 &RayTarget() const;
@@ -176,6 +176,18 @@ class SCA_MouseFocusSensor : public SCA_MouseSensor {
    */
   bool m_positive_event;
 
+  /// Return true if the object has the property or material of the sensor.
+  bool HasPropertyOrMaterial(KX_GameObject *gameobj) const;
+
+  /// Return false if the ray goes through the object.
+  bool NeedRayCast(KX_GameObject *gameobj) const;
+
+  /// Set the hit if the object hit first by the ray triggers the sensor.
+  bool FocusHit(KX_GameObject *hitKXObj,
+                const MT_Vector3 &point,
+                const MT_Vector3 &normal,
+                const MT_Vector2 &uv);
+
   /**
    * Tests whether the object is in mouse focus for this camera
    */
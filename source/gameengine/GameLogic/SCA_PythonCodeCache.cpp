@@ -0,0 +1,319 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/GameLogic/SCA_PythonCodeCache.cpp
+ *  \ingroup gamelogic
+ */
+
+#ifdef WITH_PYTHON
+
+#  include "SCA_PythonCodeCache.h"
+
+#  include <cstdlib>
+#  include <cstring>
+
+#  include "marshal.h"
+
+#  include "BLI_fileops.h"
+#  include "BLI_path_utils.hh"
+#  include "BLI_system.h"
+#  include "MEM_guardedalloc.h"
+
+#  include BLI_SYSTEM_PID_H
+
+#  include "CM_Message.h"
+
+/** Header of a cached file, followed by the script name and text, compared to the script
+ * to use the file, and the marshalled code object.
+ */
+struct CodeCacheHeader {
+  /// Python bytecode magic number, the file is ignored for a different python version.
+  uint32_t m_magic;
+  uint32_t m_nameSize;
+  uint64_t m_textSize;
+};
+
+std::list<SCA_PythonCodeCache::Entry> SCA_PythonCodeCache::m_entries;
+std::unordered_multimap<uint64_t, std::list<SCA_PythonCodeCache::Entry>::iterator>
+    SCA_PythonCodeCache::m_entryMap;
+std::string SCA_PythonCodeCache::m_directory;
+bool SCA_PythonCodeCache::m_writable = true;
+unsigned int SCA_PythonCodeCache::m_writeCount = 0;
+
+uint64_t SCA_PythonCodeCache::Hash(const std::string &text, const std::string &name)
+{
+  // FNV-1a, stable between runs unlike std::hash.
+  uint64_t hash = 14695981039346656037ULL;
+  for (const std::string *str : {&name, &text}) {
+    for (const char c : *str) {
+      hash = (hash ^ (unsigned char)c) * 1099511628211ULL;
+    }
+    // Separate the name from the text.
+    hash = hash * 1099511628211ULL;
+  }
+
+  return hash;
+}
+
+std::string SCA_PythonCodeCache::GetFilePath(uint64_t hash)
+{
+  char filename[FILE_MAXFILE];
+  snprintf(filename,
+           sizeof(filename),
+           "%016llx.%s.bgec",
+           (unsigned long long)hash,
+           PyImport_GetMagicTag());
+
+  char filepath[FILE_MAX];
+  BLI_path_join(filepath, sizeof(filepath), m_directory.c_str(), filename);
+
+  return filepath;
+}
+
+SCA_PythonCodeCache::Entry *SCA_PythonCodeCache::FindEntry(uint64_t hash,
+                                                           const std::string &text,
+                                                           const std::string &name)
+{
+  const auto range = m_entryMap.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const std::list<Entry>::iterator entryIt = it->second;
+    if (entryIt->m_text == text && entryIt->m_name == name) {
+      m_entries.splice(m_entries.begin(), m_entries, entryIt);
+      return &*entryIt;
+    }
+  }
+
+  return nullptr;
+}
+
+SCA_PythonCodeCache::Entry &SCA_PythonCodeCache::AddEntry(uint64_t hash,
+                                                          const std::string &text,
+                                                          const std::string &name,
+                                                          PyObject *code)
+{
+  while (m_entries.size() >= maxEntries) {
+    Entry &last = m_entries.back();
+    const auto range = m_entryMap.equal_range(last.m_hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (&*it->second == &last) {
+        m_entryMap.erase(it);
+        break;
+      }
+    }
+    // The scripts using the code keep their own reference.
+    Py_DECREF(last.m_code);
+    m_entries.pop_back();
+  }
+
+  // The entry keeps its own reference.
+  Py_INCREF(code);
+  m_entries.push_front(Entry{hash, text, name, code, false});
+  m_entryMap.emplace(hash, m_entries.begin());
+
+  return m_entries.front();
+}
+
+PyObject *SCA_PythonCodeCache::Read(uint64_t hash,
+                                    const std::string &text,
+                                    const std::string &name)
+{
+  size_t size;
+  char *data = (char *)BLI_file_read_binary_as_mem(GetFilePath(hash).c_str(), 0, &size);
+  if (!data) {
+    return nullptr;
+  }
+
+  PyObject *code = nullptr;
+  CodeCacheHeader header;
+  if (size > sizeof(header)) {
+    memcpy(&header, data, sizeof(header));
+    const size_t codePos = sizeof(header) + name.size() + text.size();
+    // The whole script is compared, a different script with the same hash misses the cache.
+    if (header.m_magic == (uint32_t)PyImport_GetMagicNumber() &&
+        header.m_nameSize == name.size() && header.m_textSize == text.size() &&
+        size > codePos && memcmp(data + sizeof(header), name.data(), name.size()) == 0 &&
+        memcmp(data + sizeof(header) + name.size(), text.data(), text.size()) == 0)
+    {
+      code = PyMarshal_ReadObjectFromString(data + codePos, size - codePos);
+      // A truncated or corrupted file is compiled again.
+      if (!code || !PyCode_Check(code)) {
+        Py_XDECREF(code);
+        code = nullptr;
+        PyErr_Clear();
+      }
+    }
+  }
+
+  MEM_freeN(data);
+
+  return code;
+}
+
+bool SCA_PythonCodeCache::Write(uint64_t hash,
+                                const std::string &text,
+                                const std::string &name,
+                                PyObject *code)
+{
+  if (!m_writable) {
+    return false;
+  }
+
+  // Same option as the python modules cache, checked at every write like python does.
+  PyObject *dontWrite = PySys_GetObject("dont_write_bytecode");
+  if (dontWrite && PyObject_IsTrue(dontWrite) == 1) {
+    return false;
+  }
+
+  if (!BLI_dir_create_recursive(m_directory.c_str())) {
+    CM_Warning("could not create python code cache directory \"" << m_directory << "\"");
+    // Don't try again for every script.
+    m_writable = false;
+    return false;
+  }
+
+  PyObject *bytes = PyMarshal_WriteObjectToString(code, Py_MARSHAL_VERSION);
+  if (!bytes) {
+    PyErr_Clear();
+    return false;
+  }
+
+  const std::string filepath = GetFilePath(hash);
+  /* Written to a temporary file first so that other instances never read a partial file,
+   * named from the process and the write to not be shared with another instance. */
+  const std::string tmppath = filepath + "." + std::to_string(abs(getpid())) + "." +
+                              std::to_string(m_writeCount++) + ".tmp";
+
+  bool written = false;
+  FILE *file = BLI_fopen(tmppath.c_str(), "wb");
+  if (file) {
+    CodeCacheHeader header;
+    header.m_magic = (uint32_t)PyImport_GetMagicNumber();
+    header.m_nameSize = name.size();
+    header.m_textSize = text.size();
+
+    written = (fwrite(&header, sizeof(header), 1, file) == 1 &&
+               fwrite(name.data(), 1, name.size(), file) == name.size() &&
+               fwrite(text.data(), 1, text.size(), file) == text.size() &&
+               fwrite(PyBytes_AS_STRING(bytes), PyBytes_GET_SIZE(bytes), 1, file) == 1);
+    fclose(file);
+
+    if (!written || BLI_rename_overwrite(tmppath.c_str(), filepath.c_str()) != 0) {
+      BLI_delete(tmppath.c_str(), false, false);
+      written = false;
+    }
+  }
+  else {
+    // Read-only directory, the existing files are still used.
+    CM_Warning("could not write in python code cache directory \"" << m_directory << "\"");
+    m_writable = false;
+  }
+
+  Py_DECREF(bytes);
+
+  return written;
+}
+
+void SCA_PythonCodeCache::SetDirectory(const std::string &directory)
+{
+  m_directory = directory;
+  m_writable = true;
+}
+
+PyObject *SCA_PythonCodeCache::Compile(const std::string &text, const std::string &name)
+{
+  const uint64_t hash = Hash(text, name);
+
+  Entry *entry = FindEntry(hash, text, name);
+  if (entry) {
+    Py_INCREF(entry->m_code);
+    return entry->m_code;
+  }
+
+  bool stored = false;
+  PyObject *code = m_directory.empty() ? nullptr : Read(hash, text, name);
+  if (code) {
+    stored = true;
+  }
+  else {
+    code = Py_CompileString(text.c_str(), name.c_str(), Py_file_input);
+    if (!code) {
+      return nullptr;
+    }
+
+    if (!m_directory.empty()) {
+      stored = Write(hash, text, name, code);
+    }
+  }
+
+  AddEntry(hash, text, name, code).m_stored = stored;
+
+  return code;
+}
+
+PyObject *SCA_PythonCodeCache::Find(const std::string &text, const std::string &name)
+{
+  const uint64_t hash = Hash(text, name);
+
+  Entry *entry = FindEntry(hash, text, name);
+  if (entry) {
+    Py_INCREF(entry->m_code);
+    return entry->m_code;
+  }
+
+  if (m_directory.empty()) {
+    return nullptr;
+  }
+
+  PyObject *code = Read(hash, text, name);
+  if (code) {
+    AddEntry(hash, text, name, code).m_stored = true;
+  }
+
+  return code;
+}
+
+void SCA_PythonCodeCache::Store(const std::string &text, const std::string &name, PyObject *code)
+{
+  const uint64_t hash = Hash(text, name);
+
+  Entry *entry = FindEntry(hash, text, name);
+  if (!entry) {
+    entry = &AddEntry(hash, text, name, code);
+  }
+
+  if (!entry->m_stored && !m_directory.empty()) {
+    entry->m_stored = Write(hash, text, name, entry->m_code);
+  }
+}
+
+void SCA_PythonCodeCache::Clear()
+{
+  for (Entry &entry : m_entries) {
+    Py_DECREF(entry.m_code);
+  }
+  m_entries.clear();
+  m_entryMap.clear();
+  m_directory.clear();
+  m_writable = true;
+}
+
+#endif  // WITH_PYTHON
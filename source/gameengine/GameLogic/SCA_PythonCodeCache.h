@@ -0,0 +1,104 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file SCA_PythonCodeCache.h
+ *  \ingroup gamelogic
+ */
+
+#pragma once
+
+#ifdef WITH_PYTHON
+
+#  include <Python.h>
+
+#  include <cstdint>
+#  include <list>
+#  include <string>
+#  include <unordered_map>
+
+/** Cache of the code objects compiled from the embedded python scripts.
+ *
+ * The code objects are shared by all the scripts with the same text and name during
+ * the game, the least recently used ones are released when the cache is full. They are
+ * also marshalled in a cache directory, usually next to the blend file, to avoid compiling
+ * the scripts again in the next runs, unless sys.dont_write_bytecode is set. A cached file
+ * is named from a hash of the script and the python magic tag, and stores the script name
+ * and text which are compared to the script before using its code.
+ */
+class SCA_PythonCodeCache {
+ private:
+  struct Entry {
+    uint64_t m_hash;
+    std::string m_text;
+    std::string m_name;
+    PyObject *m_code;
+    /// The code was read from or written to the cache directory.
+    bool m_stored;
+  };
+
+  /// Maximum number of code objects kept in memory.
+  static const size_t maxEntries = 256;
+
+  /// Entries from the most to the least recently used.
+  static std::list<Entry> m_entries;
+  static std::unordered_multimap<uint64_t, std::list<Entry>::iterator> m_entryMap;
+  /// Directory of the marshalled code objects, empty to not use the disk.
+  static std::string m_directory;
+  /// False when the directory can't be written, the cached files are still read.
+  static bool m_writable;
+  /// Number of written files, used for unique temporary file names.
+  static unsigned int m_writeCount;
+
+  static uint64_t Hash(const std::string &text, const std::string &name);
+  static std::string GetFilePath(uint64_t hash);
+  /// Return the entry of a script in memory moved at the front or nullptr.
+  static Entry *FindEntry(uint64_t hash, const std::string &text, const std::string &name);
+  /// Add an entry keeping a reference to the code, release the least recently used ones.
+  static Entry &AddEntry(
+      uint64_t hash, const std::string &text, const std::string &name, PyObject *code);
+  /// Return a new reference to the code read from the disk or nullptr.
+  static PyObject *Read(uint64_t hash, const std::string &text, const std::string &name);
+  /// Write the code in the cache directory, return true on success.
+  static bool Write(uint64_t hash,
+                    const std::string &text,
+                    const std::string &name,
+                    PyObject *code);
+
+ public:
+  /// Set the directory of the marshalled code objects, created at the first write.
+  static void SetDirectory(const std::string &directory);
+
+  /** Return a new reference to the code object of a script, compiled only if not found
+   * in memory or on the disk. Return nullptr with the python error set if the compilation
+   * failed.
+   */
+  static PyObject *Compile(const std::string &text, const std::string &name);
+  /// Return a new reference to the code of a script in memory or on the disk, or nullptr.
+  static PyObject *Find(const std::string &text, const std::string &name);
+  /// Store the code of a script compiled elsewhere, written to the disk if not already.
+  static void Store(const std::string &text, const std::string &name, PyObject *code);
+
+  /// Release all the code objects, called before the python interpreter is reset.
+  static void Clear();
+};
+
+#endif  // WITH_PYTHON
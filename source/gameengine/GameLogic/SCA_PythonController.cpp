@@ -35,6 +35,7 @@
 #include "SCA_PythonController.h"
 
 #ifdef WITH_PYTHON
+#  include "SCA_PythonCodeCache.h"
 #  include "compile.h"
 #  include "py_capi_utils.hh"
 #endif  // WITH_PYTHON
@@ -44,63 +45,63 @@
 // initialize static member variables
 SCA_PythonController *SCA_PythonController::m_sCurrentController = nullptr;
 
-SCA_PythonController::SCA_PythonController(SCA_IObject *gameobj, int mode)
-    : SCA_IController(gameobj),
+SCA_PythonScript::SCA_PythonScript()
+    :
 #ifdef WITH_PYTHON
       m_bytecode(nullptr),
       m_function(nullptr),
+      m_dictionary(nullptr),
 #endif
-      m_function_argc(0),
-      m_bModified(true),
-      m_debug(false),
-      m_mode(mode)
+      m_functionArgc(0),
+      m_modified(true)
+{
+}
+
+SCA_PythonScript::SCA_PythonScript(const SCA_PythonScript &other)
+    : CM_RefCount<SCA_PythonScript>(other),
+      m_text(other.m_text),
+      m_name(other.m_name),
 #ifdef WITH_PYTHON
-      ,
-      m_pythondictionary(nullptr)
+      m_bytecode(nullptr),
+      m_function(nullptr),
+      m_dictionary(nullptr),
 #endif
-
+      m_functionArgc(0),
+      m_modified(true)
 {
 }
 
-SCA_PythonController::~SCA_PythonController()
+SCA_PythonScript::~SCA_PythonScript()
 {
-
 #ifdef WITH_PYTHON
   Py_XDECREF(m_bytecode);
   Py_XDECREF(m_function);
 
-  if (m_pythondictionary) {
+  if (m_dictionary) {
     // break any circular references in the dictionary
-    PyDict_Clear(m_pythondictionary);
-    Py_DECREF(m_pythondictionary);
+    PyDict_Clear(m_dictionary);
+    Py_DECREF(m_dictionary);
   }
 #endif
 }
 
-EXP_Value *SCA_PythonController::GetReplica()
+SCA_PythonController::SCA_PythonController(SCA_IObject *gameobj, int mode)
+    : SCA_IController(gameobj), m_debug(false), m_mode(mode), m_script(new SCA_PythonScript())
 {
-  SCA_PythonController *replica = new SCA_PythonController(*this);
-
-#ifdef WITH_PYTHON
-  /* why is this needed at all??? - m_bytecode is nullptr'd below so this doesnt make sense
-   * but removing it crashes blender (with YoFrankie). so leave in for now - Campbell */
-  Py_XINCREF(replica->m_bytecode);
-
-  Py_XINCREF(replica->m_function);  // this is ok since its not set to nullptr
-  replica->m_bModified = replica->m_bytecode == nullptr;
+}
 
-  // The replica->m_pythondictionary is stolen - replace with a copy.
-  if (m_pythondictionary)
-    replica->m_pythondictionary = PyDict_Copy(m_pythondictionary);
+SCA_PythonController::~SCA_PythonController()
+{
+  m_script->Release();
+}
 
-#  if 0
-	// The other option is to incref the replica->m_pythondictionary -
-	// the replica objects can then share data.
-	if (m_pythondictionary)
-		Py_INCREF(replica->m_pythondictionary);
-#  endif
+EXP_Value *SCA_PythonController::GetReplica()
+{
+  SCA_PythonController *replica = new SCA_PythonController(*this);
 
-#endif /* WITH_PYTHON */
+  /* The script, its compiled code and its globals dictionary are shared instead of copying
+   * the dictionary, it is never modified as each execution uses a copy of it. */
+  m_script->AddRef();
 
   // this will copy properties and so on...
   replica->ProcessReplica();
@@ -108,15 +109,27 @@ EXP_Value *SCA_PythonController::GetReplica()
   return replica;
 }
 
+SCA_PythonScript *SCA_PythonController::EditScript()
+{
+  if (m_script->GetRefCount() > 1) {
+    SCA_PythonScript *script = new SCA_PythonScript(*m_script);
+    m_script->Release();
+    m_script = script;
+  }
+
+  return m_script;
+}
+
 void SCA_PythonController::SetScriptText(const std::string &text)
 {
-  m_scriptText = text;
-  m_bModified = true;
+  SCA_PythonScript *script = EditScript();
+  script->m_text = text;
+  script->m_modified = true;
 }
 
 void SCA_PythonController::SetScriptName(const std::string &name)
 {
-  m_scriptName = name;
+  EditScript()->m_name = name;
 }
 
 bool SCA_PythonController::IsTriggered(class SCA_ISensor *sensor)
@@ -243,18 +256,22 @@ void SCA_PythonController::ErrorPrint(const char *error_msg)
 
 bool SCA_PythonController::Compile()
 {
-  m_bModified = false;
+  /* The compiled code is stored in the shared script, the other controllers
+   * sharing it have the same text and don't compile it again. */
+  SCA_PythonScript *script = m_script;
+  script->m_modified = false;
 
   // if a script already exists, decref it before replace the pointer to a new script
-  if (m_bytecode) {
-    Py_DECREF(m_bytecode);
-    m_bytecode = nullptr;
+  if (script->m_bytecode) {
+    Py_DECREF(script->m_bytecode);
+    script->m_bytecode = nullptr;
   }
 
-  // recompile the scripttext into bytecode
-  m_bytecode = Py_CompileString(m_scriptText.c_str(), m_scriptName.c_str(), Py_file_input);
+  /* recompile the scripttext into bytecode, or reuse the code of the other scripts
+   * with the same text, possibly compiled in a previous run */
+  script->m_bytecode = SCA_PythonCodeCache::Compile(script->m_text, script->m_name);
 
-  if (m_bytecode) {
+  if (script->m_bytecode) {
     return true;
   }
   else {
@@ -265,13 +282,14 @@ bool SCA_PythonController::Compile()
 
 bool SCA_PythonController::Import()
 {
-  m_bModified = false;
+  SCA_PythonScript *script = m_script;
+  script->m_modified = false;
 
   /* in case we re-import */
-  Py_XDECREF(m_function);
-  m_function = nullptr;
+  Py_XDECREF(script->m_function);
+  script->m_function = nullptr;
 
-  std::string mod_path = m_scriptText; /* just for storage, use C style string access */
+  std::string mod_path = script->m_text; /* just for storage, use C style string access */
   std::string function_string;
 
   const int pos = mod_path.rfind('.');
@@ -283,7 +301,7 @@ bool SCA_PythonController::Import()
   if (function_string.empty()) {
     CM_LogicBrickError(this,
                        "python module name formatting expected 'SomeModule.Func', got '"
-                           << m_scriptText << "'");
+                           << script->m_text << "'");
     return false;
   }
 
@@ -304,39 +322,39 @@ bool SCA_PythonController::Import()
   }
 
   // Get the function object
-  m_function = PyObject_GetAttrString(mod, function_string.c_str());
+  script->m_function = PyObject_GetAttrString(mod, function_string.c_str());
 
   // DECREF the module as we don't need it anymore
   Py_DECREF(mod);
 
-  if (m_function == nullptr) {
+  if (script->m_function == nullptr) {
     if (PyErr_Occurred())
       ErrorPrint("python controller found the module but could not access the function");
     else
       CM_LogicBrickError(this,
-                         "python module '" << m_scriptText << "' found but function missing");
+                         "python module '" << script->m_text << "' found but function missing");
     return false;
   }
 
-  if (!PyCallable_Check(m_function)) {
-    Py_DECREF(m_function);
-    m_function = nullptr;
-    CM_LogicBrickError(this, "python module function '" << m_scriptText << "' not callable");
+  if (!PyCallable_Check(script->m_function)) {
+    Py_DECREF(script->m_function);
+    script->m_function = nullptr;
+    CM_LogicBrickError(this, "python module function '" << script->m_text << "' not callable");
     return false;
   }
 
-  m_function_argc =
+  script->m_functionArgc =
       0; /* rare cases this could be a function that isn't defined in python, assume zero args */
-  if (PyFunction_Check(m_function)) {
-    m_function_argc = ((PyCodeObject *)PyFunction_GET_CODE(m_function))->co_argcount;
+  if (PyFunction_Check(script->m_function)) {
+    script->m_functionArgc = ((PyCodeObject *)PyFunction_GET_CODE(script->m_function))->co_argcount;
   }
 
-  if (m_function_argc > 1) {
-    Py_DECREF(m_function);
-    m_function = nullptr;
+  if (script->m_functionArgc > 1) {
+    Py_DECREF(script->m_function);
+    script->m_function = nullptr;
     CM_LogicBrickError(this,
                        "python module function:\n '"
-                           << m_scriptText << "' takes " << m_function_argc
+                           << script->m_text << "' takes " << script->m_functionArgc
                            << " args, should be zero or 1 controller arg");
     return false;
   }
@@ -350,13 +368,14 @@ void SCA_PythonController::Trigger(SCA_LogicManager *logicmgr)
 
   PyObject *excdict = nullptr;
   PyObject *resultobj = nullptr;
+  SCA_PythonScript *script = m_script;
 
   switch (m_mode) {
     case SCA_PYEXEC_SCRIPT: {
-      if (m_bModified)
-        if (Compile() == false)  // sets m_bModified to false
+      if (script->m_modified)
+        if (Compile() == false)  // sets m_modified to false
           return;
-      if (!m_bytecode)
+      if (!script->m_bytecode)
         return;
 
       /*
@@ -377,38 +396,39 @@ void SCA_PythonController::Trigger(SCA_LogicManager *logicmgr)
        * should always ensure excdict is cleared).
        */
 
-      if (!m_pythondictionary) {
-        m_pythondictionary = PyDict_Copy(PyC_DefaultNameSpace("<python controller script>")); /* new reference */
+      if (!script->m_dictionary) {
+        /* new reference */
+        script->m_dictionary = PyDict_Copy(PyC_DefaultNameSpace("<python controller script>"));
 
         /* Without __file__ set the sys.argv[0] is used for the filename
          * which ends up with lines from the blender binary being printed in the console */
-        PyObject *value = PyUnicode_FromStdString(m_scriptName);
-        PyDict_SetItemString(m_pythondictionary, "__file__", value);
+        PyObject *value = PyUnicode_FromStdString(script->m_name);
+        PyDict_SetItemString(script->m_dictionary, "__file__", value);
         Py_DECREF(value);
       }
 
-      excdict = PyDict_Copy(m_pythondictionary);
+      excdict = PyDict_Copy(script->m_dictionary);
 
-      resultobj = PyEval_EvalCode((PyObject *)m_bytecode, excdict, excdict);
+      resultobj = PyEval_EvalCode(script->m_bytecode, excdict, excdict);
 
       /* PyRun_SimpleString(m_scriptText.Ptr()); */
       break;
     }
     case SCA_PYEXEC_MODULE: {
-      if (m_bModified || m_debug)
-        if (Import() == false)  // sets m_bModified to false
+      if (script->m_modified || m_debug)
+        if (Import() == false)  // sets m_modified to false
           return;
-      if (!m_function)
+      if (!script->m_function)
         return;
 
       PyObject *args = nullptr;
 
-      if (m_function_argc == 1) {
+      if (script->m_functionArgc == 1) {
         args = PyTuple_New(1);
         PyTuple_SET_ITEM(args, 0, GetProxy());
       }
 
-      resultobj = PyObject_CallObject(m_function, args);
+      resultobj = PyObject_CallObject(script->m_function, args);
       Py_XDECREF(args);
       break;
     }
@@ -473,7 +493,7 @@ PyObject *SCA_PythonController::pyattr_get_script(EXP_PyObjectPlus *self_v,
   // static_cast<void *>(dynamic_cast<Derived *>(obj)) - static_cast<void *>(obj)
 
   SCA_PythonController *self = static_cast<SCA_PythonController *>(self_v);
-  return PyUnicode_FromStdString(self->m_scriptText);
+  return PyUnicode_FromStdString(self->m_script->m_text);
 }
 
 int SCA_PythonController::pyattr_set_script(EXP_PyObjectPlus *self_v,
@@ -491,7 +511,7 @@ int SCA_PythonController::pyattr_set_script(EXP_PyObjectPlus *self_v,
     return PY_SET_ATTR_FAIL;
   }
 
-  /* set scripttext sets m_bModified to true,
+  /* set scripttext sets m_modified to true,
    * so next time the script is needed, a reparse into byte code is done */
   self->SetScriptText(scriptArg);
 
@@ -34,29 +34,48 @@
 
 #include <vector>
 
+#include "CM_RefCount.h"
 #include "EXP_BoolValue.h"
 #include "SCA_IController.h"
 #include "SCA_LogicManager.h"
 
 class SCA_IObject;
-class SCA_PythonController : public SCA_IController {
-  Py_Header
+
+/** Script of a python controller and its compiled code, shared by the replicas of the
+ * controller until one of them changes its script. Replicas don't copy the globals
+ * dictionary and a script not yet compiled when replicated is compiled only once.
+ * Only the python controller shares its definition, the other logic bricks are still
+ * fully copied on replication.
+ */
+class SCA_PythonScript : public CM_RefCount<SCA_PythonScript> {
+ public:
+  std::string m_text;
+  std::string m_name;
 #ifdef WITH_PYTHON
-      struct _object *m_bytecode; /* SCA_PYEXEC_SCRIPT only */
-  PyObject *m_function;           /* SCA_PYEXEC_MODULE only */
+  PyObject *m_bytecode; /* SCA_PYEXEC_SCRIPT only */
+  PyObject *m_function; /* SCA_PYEXEC_MODULE only */
+  /// Globals of the script, the executions use a copy so it is never modified.
+  PyObject *m_dictionary; /* SCA_PYEXEC_SCRIPT only */
 #endif
-  int m_function_argc;
-  bool m_bModified;
-  bool m_debug; /* use with SCA_PYEXEC_MODULE for reloading every logic run */
+  int m_functionArgc;
+  /// The script must be compiled or imported before its execution.
+  bool m_modified;
+
+  SCA_PythonScript();
+  /// Copy the text and the name only, the copy is compiled again.
+  SCA_PythonScript(const SCA_PythonScript &other);
+  virtual ~SCA_PythonScript();
+};
+
+class SCA_PythonController : public SCA_IController {
+  Py_Header
+
+      bool m_debug; /* use with SCA_PYEXEC_MODULE for reloading every logic run */
   int m_mode;
 
  protected:
-  std::string m_scriptText;
-  std::string m_scriptName;
-#ifdef WITH_PYTHON
-  PyObject *m_pythondictionary; /* for SCA_PYEXEC_SCRIPT only */
-  PyObject *m_pythonfunction;   /* for SCA_PYEXEC_MODULE only */
-#endif
+  /// Shared with the replicas, copied before a modification of the text or the name.
+  SCA_PythonScript *m_script;
   std::vector<class SCA_ISensor *> m_triggeredSensors;
 
  public:
@@ -81,11 +100,22 @@ class SCA_PythonController : public SCA_IController {
   {
     m_debug = debug;
   }
+  int GetMode() const
+  {
+    return m_mode;
+  }
+  /// Return true if the script must be compiled or imported before its execution.
+  bool IsScriptModified() const
+  {
+    return m_script->m_modified;
+  }
   void AddTriggeredSensor(class SCA_ISensor *sensor)
   {
     m_triggeredSensors.push_back(sensor);
   }
   bool IsTriggered(class SCA_ISensor *sensor);
+  /// Return the script, copied first if it is shared with other controllers.
+  SCA_PythonScript *EditScript();
   bool Compile();
   bool Import();
   void ErrorPrint(const char *error_msg);
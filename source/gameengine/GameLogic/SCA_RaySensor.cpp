@@ -70,6 +70,7 @@ void SCA_RaySensor::Init()
   m_rayHit = false;
   m_hitObject = nullptr;
   m_reset = true;
+  m_queryDone = false;
 }
 
 SCA_RaySensor::~SCA_RaySensor()
@@ -182,10 +183,14 @@ bool SCA_RaySensor::NeedRayCast(KX_ClientObjectInfo *client, void */*data*/)
   return true;
 }
 
-bool SCA_RaySensor::Evaluate()
+bool SCA_RaySensor::HasQuery() const
 {
-  bool result = false;
-  bool reset = m_reset && m_level;
+  return true;
+}
+
+void SCA_RaySensor::RunQuery()
+{
+  m_queryDone = true;
   m_rayHit = false;
   m_hitObject = nullptr;
   m_hitPosition[0] = 0;
@@ -202,7 +207,6 @@ bool SCA_RaySensor::Evaluate()
   MT_Matrix3x3 invmat = matje.inverse();
 
   MT_Vector3 todir;
-  m_reset = false;
   switch (m_axis) {
     case SENS_RAY_X_AXIS:  // X
     {
@@ -253,11 +257,9 @@ bool SCA_RaySensor::Evaluate()
   m_rayDirection[2] = todir[2];
 
   MT_Vector3 topoint = frompoint + (m_distance)*todir;
-  PHY_IPhysicsEnvironment *pe = m_scene->GetPhysicsEnvironment();
-
-  if (!pe) {
-    CM_LogicBrickWarning(this, "there is no physics environment! Check universe for malfunction.");
-    return false;
+  PHY_IPhysicsEnvironment *physics_environment = m_scene->GetPhysicsEnvironment();
+  if (!physics_environment) {
+    return;
   }
 
   PHY_IPhysicsController *spc = obj->GetPhysicsController();
@@ -265,10 +267,32 @@ bool SCA_RaySensor::Evaluate()
   if (!spc && parent)
     spc = parent->GetPhysicsController();
 
-  PHY_IPhysicsEnvironment *physics_environment = this->m_scene->GetPhysicsEnvironment();
-
   KX_RayCast::Callback<SCA_RaySensor, void> callback(this, spc);
   KX_RayCast::RayTest(physics_environment, frompoint, topoint, callback);
+}
+
+bool SCA_RaySensor::SupportsParallelQueries() const
+{
+  PHY_IPhysicsEnvironment *physics_environment = m_scene->GetPhysicsEnvironment();
+  return (physics_environment && physics_environment->SupportsParallelQueries());
+}
+
+bool SCA_RaySensor::Evaluate()
+{
+  bool result = false;
+  bool reset = m_reset && m_level;
+  m_reset = false;
+
+  // The query could have been run with the queries of the other sensors.
+  if (!m_queryDone) {
+    RunQuery();
+  }
+  m_queryDone = false;
+
+  if (!m_scene->GetPhysicsEnvironment()) {
+    CM_LogicBrickWarning(this, "there is no physics environment! Check universe for malfunction.");
+    return false;
+  }
 
   /* now pass this result to some controller */
 
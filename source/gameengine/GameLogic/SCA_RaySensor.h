@@ -57,6 +57,8 @@ class SCA_RaySensor : public SCA_ISensor {
   float m_hitNormal[3];
   float m_rayDirection[3];
   std::string m_hitMaterial;
+  /// The query was run in parallel before Evaluate.
+  bool m_queryDone;
 
  public:
   SCA_RaySensor(class SCA_EventManager *eventmgr,
@@ -74,6 +76,9 @@ class SCA_RaySensor : public SCA_ISensor {
   virtual bool Evaluate();
   virtual bool IsPositiveTrigger();
   virtual void Init();
+  virtual bool HasQuery() const;
+  virtual void RunQuery();
+  virtual bool SupportsParallelQueries() const;
 
   /// \see KX_RayCast
   bool RayHit(KX_ClientObjectInfo *client, KX_RayCast *result, void */*data*/);
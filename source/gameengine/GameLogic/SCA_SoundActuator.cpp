@@ -44,8 +44,12 @@ typedef float sample_t;
 #  include <python/PyAPI.h>
 #endif
 
+#include <cmath>
+
 #include "KX_Camera.h"
 #include "KX_Globals.h"
+#include "KX_KetsjiEngine.h"
+#include "KX_SoundVoiceManager.h"
 
 /* ------------------------------------------------------------------------- */
 /* Native functions                                                          */
@@ -64,7 +68,16 @@ SCA_SoundActuator::SCA_SoundActuator(SCA_IObject *gameobj,
 #ifdef WITH_AUDASPACE
   m_sound = sound ? AUD_Sound_copy(sound) : nullptr;
   m_handle = nullptr;
+  m_voiceManager = nullptr;
+  m_virtual = false;
+  m_loop = false;
+  m_virtualTime = 0.0;
+  m_virtualPosition = 0.0;
+  m_length = 0.0;
+  m_distanceModel = AUD_DISTANCE_MODEL_INVALID;
 #endif  // WITH_AUDASPACE
+  m_priority = 0;
+  m_voiceGain = volume;
   m_volume = volume;
   m_pitch = pitch;
   m_is3d = is3d;
@@ -76,9 +89,7 @@ SCA_SoundActuator::SCA_SoundActuator(SCA_IObject *gameobj,
 SCA_SoundActuator::~SCA_SoundActuator()
 {
 #ifdef WITH_AUDASPACE
-  if (m_handle) {
-    AUD_Handle_stop(m_handle);
-  }
+  StopSound();
 
   if (m_sound) {
     AUD_Sound_free(m_sound);
@@ -86,13 +97,104 @@ SCA_SoundActuator::~SCA_SoundActuator()
 #endif  // WITH_AUDASPACE
 }
 
-void SCA_SoundActuator::play()
-{
 #ifdef WITH_AUDASPACE
+void SCA_SoundActuator::StopSound()
+{
+  m_virtual = false;
+  ReleaseVoice();
+
   if (m_handle) {
     AUD_Handle_stop(m_handle);
     m_handle = nullptr;
   }
+}
+
+void SCA_SoundActuator::ReleaseVoice()
+{
+  if (!m_voiceManager) {
+    return;
+  }
+
+  if (m_virtual) {
+    // The handle is left paused at the position the sound reached.
+    AUD_Handle_setPosition(m_handle, GetVoicePosition(m_voiceManager->GetTime()));
+    m_virtual = false;
+  }
+
+  m_voiceManager->RemoveVoice(this);
+  m_voiceManager = nullptr;
+}
+
+double SCA_SoundActuator::GetVoicePosition(double time) const
+{
+  if (!m_virtual) {
+    return AUD_Handle_getPosition(m_handle);
+  }
+
+  double position = m_virtualPosition + (time - m_virtualTime) * m_pitch;
+  if (m_loop && m_length > 0.0) {
+    position = std::fmod(position, m_length);
+  }
+
+  return position;
+}
+
+bool SCA_SoundActuator::IsVirtualSoundEnded(double time) const
+{
+  return (!m_loop && m_length > 0.0 && GetVoicePosition(time) >= m_length);
+}
+
+float SCA_SoundActuator::ComputeDistanceGain(float distance) const
+{
+  // Same attenuation as the audaspace software device.
+  const float reference = m_3d.reference_distance;
+  const float maximum = m_3d.max_distance;
+  const float attenuation = m_3d.rolloff_factor;
+  float gain;
+
+  if (ELEM(m_distanceModel,
+           AUD_DISTANCE_MODEL_INVERSE_CLAMPED,
+           AUD_DISTANCE_MODEL_LINEAR_CLAMPED,
+           AUD_DISTANCE_MODEL_EXPONENT_CLAMPED))
+  {
+    distance = std::max(std::min(maximum, distance), reference);
+  }
+
+  switch (m_distanceModel) {
+    case AUD_DISTANCE_MODEL_INVERSE:
+    case AUD_DISTANCE_MODEL_INVERSE_CLAMPED: {
+      gain = reference / (reference + attenuation * (distance - reference));
+      break;
+    }
+    case AUD_DISTANCE_MODEL_LINEAR:
+    case AUD_DISTANCE_MODEL_LINEAR_CLAMPED: {
+      if (maximum == reference) {
+        gain = (distance > reference) ? 0.0f : 1.0f;
+      }
+      else {
+        gain = 1.0f - attenuation * (distance - reference) / (maximum - reference);
+      }
+      break;
+    }
+    case AUD_DISTANCE_MODEL_EXPONENT:
+    case AUD_DISTANCE_MODEL_EXPONENT_CLAMPED: {
+      gain = (reference == 0.0f) ? 0.0f : std::pow(distance / reference, -attenuation);
+      break;
+    }
+    default: {
+      gain = 1.0f;
+      break;
+    }
+  }
+
+  return std::max(std::min(gain, m_3d.max_gain), m_3d.min_gain);
+}
+#endif  // WITH_AUDASPACE
+
+void SCA_SoundActuator::play()
+{
+#ifdef WITH_AUDASPACE
+  StopSound();
 
   if (!m_sound)
     return;
@@ -119,6 +221,7 @@ void SCA_SoundActuator::play()
 
   AUD_Device *device = AUD_Device_getCurrent();
   m_handle = AUD_Device_play(device, sound, false);
+  m_distanceModel = AUD_Device_getDistanceModel(device);
   AUD_Device_free(device);
 
   // in case of pingpong, we have to free the sound
@@ -142,6 +245,12 @@ void SCA_SoundActuator::play()
       AUD_Handle_setLoopCount(m_handle, -1);
     AUD_Handle_setPitch(m_handle, m_pitch);
     AUD_Handle_setVolume(m_handle, m_volume);
+
+    m_loop = loop;
+    m_length = 0.0;
+    m_voiceGain = m_volume;
+    m_voiceManager = KX_GetActiveEngine()->GetSoundVoiceManager();
+    m_voiceManager->AddVoice(this);
   }
 
   m_isplaying = true;
@@ -160,10 +269,64 @@ void SCA_SoundActuator::ProcessReplica()
   SCA_IActuator::ProcessReplica();
 #ifdef WITH_AUDASPACE
   m_handle = nullptr;
+  m_voiceManager = nullptr;
+  m_virtual = false;
   m_sound = m_sound ? AUD_Sound_copy(m_sound) : nullptr;
 #endif  // WITH_AUDASPACE
 }
 
+int SCA_SoundActuator::GetPriority() const
+{
+  return m_priority;
+}
+
+float SCA_SoundActuator::GetVoiceGain() const
+{
+  return m_voiceGain;
+}
+
+bool SCA_SoundActuator::IsVirtual() const
+{
+#ifdef WITH_AUDASPACE
+  return m_virtual;
+#else
+  return false;
+#endif  // WITH_AUDASPACE
+}
+
+void SCA_SoundActuator::SetVirtual(bool virt, double time)
+{
+#ifdef WITH_AUDASPACE
+  if (virt == m_virtual) {
+    return;
+  }
+
+  if (virt) {
+    if (m_length == 0.0) {
+      const int length = AUD_Sound_getLength(m_sound);
+      const AUD_Specs specs = AUD_Sound_getSpecs(m_sound);
+      if (length > 0 && specs.rate > 0.0) {
+        m_length = double(length) / specs.rate;
+        // The ping pong loop plays the sound forward then backward.
+        if (ELEM(m_type, KX_SOUNDACT_LOOPBIDIRECTIONAL, KX_SOUNDACT_LOOPBIDIRECTIONAL_STOP)) {
+          m_length *= 2.0;
+        }
+      }
+    }
+
+    AUD_Handle_pause(m_handle);
+    m_virtualPosition = AUD_Handle_getPosition(m_handle);
+    m_virtualTime = time;
+    m_virtual = true;
+  }
+  else {
+    AUD_Handle_setPosition(m_handle, GetVoicePosition(time));
+    m_virtual = false;
+    AUD_Handle_resume(m_handle);
+  }
+#endif  // WITH_AUDASPACE
+}
+
 bool SCA_SoundActuator::Update(double curtime)
 {
   bool result = false;
@@ -180,8 +343,14 @@ bool SCA_SoundActuator::Update(double curtime)
   if (!m_sound)
     return false;
 
-  // actual audio device playing state
-  bool isplaying = m_handle ? (AUD_Handle_getStatus(m_handle) == AUD_STATUS_PLAYING) : false;
+  const double voiceTime = KX_GetActiveEngine()->GetRealTime();
+  if (m_virtual && IsVirtualSoundEnded(voiceTime)) {
+    StopSound();
+  }
+
+  // actual audio device playing state, a virtual sound is still considered playing
+  bool isplaying = m_handle ? (m_virtual || AUD_Handle_getStatus(m_handle) == AUD_STATUS_PLAYING) :
+                              false;
 
   if (bNegativeEvent) {
     // here must be a check if it is still playing
@@ -191,10 +360,7 @@ bool SCA_SoundActuator::Update(double curtime)
         case KX_SOUNDACT_LOOPSTOP:
         case KX_SOUNDACT_LOOPBIDIRECTIONAL_STOP: {
           // stop immediately
-          if (m_handle) {
-            AUD_Handle_stop(m_handle);
-            m_handle = nullptr;
-          }
+          StopSound();
           break;
         }
         case KX_SOUNDACT_PLAYEND: {
@@ -206,6 +372,12 @@ bool SCA_SoundActuator::Update(double curtime)
           // stop the looping so that the sound stops when it finished
           if (m_handle)
             AUD_Handle_setLoopCount(m_handle, 0);
+          if (m_virtual) {
+            // the virtual sound stops at the end of the current loop
+            m_virtualPosition = GetVoicePosition(voiceTime);
+            m_virtualTime = voiceTime;
+            m_loop = false;
+          }
           break;
         }
         default:
@@ -232,9 +404,11 @@ bool SCA_SoundActuator::Update(double curtime)
       play();
   }
   // verify that the sound is still playing
-  isplaying = m_handle ? (AUD_Handle_getStatus(m_handle) == AUD_STATUS_PLAYING) : false;
+  isplaying = m_handle ? (m_virtual || AUD_Handle_getStatus(m_handle) == AUD_STATUS_PLAYING) :
+                         false;
 
   if (isplaying) {
+    m_voiceGain = m_volume;
     if (m_is3d) {
       KX_Camera *cam = KX_GetActiveScene()->GetActiveCamera();
       if (cam) {
@@ -248,6 +422,7 @@ bool SCA_SoundActuator::Update(double curtime)
         p = Mo * p;
         p.getValue(data);
         AUD_Handle_setLocation(m_handle, data);
+        m_voiceGain *= ComputeDistanceGain(p.length());
         p = (obj->GetLinearVelocity() - cam->GetLinearVelocity());
         p = Mo * p;
         p.getValue(data);
@@ -259,6 +434,8 @@ bool SCA_SoundActuator::Update(double curtime)
     result = true;
   }
   else {
+    // the sound ended, it is not a voice anymore
+    ReleaseVoice();
     m_isplaying = false;
     result = false;
   }
@@ -343,6 +520,9 @@ PyAttributeDef SCA_SoundActuator::Attributes[] = {
         "time", SCA_SoundActuator, pyattr_get_audposition, pyattr_set_audposition),
     EXP_PYATTRIBUTE_RW_FUNCTION("volume", SCA_SoundActuator, pyattr_get_gain, pyattr_set_gain),
     EXP_PYATTRIBUTE_RW_FUNCTION("pitch", SCA_SoundActuator, pyattr_get_pitch, pyattr_set_pitch),
+    EXP_PYATTRIBUTE_RW_FUNCTION(
+        "priority", SCA_SoundActuator, pyattr_get_priority, pyattr_set_priority),
+    EXP_PYATTRIBUTE_RO_FUNCTION("isVirtual", SCA_SoundActuator, pyattr_get_is_virtual),
     EXP_PYATTRIBUTE_ENUM_RW("mode",
                             SCA_SoundActuator::KX_SOUNDACT_NODEF + 1,
                             SCA_SoundActuator::KX_SOUNDACT_MAX - 1,
@@ -363,7 +543,12 @@ EXP_PYMETHODDEF_DOC_NOARGS(SCA_SoundActuator,
     case AUD_STATUS_PLAYING:
       break;
     case AUD_STATUS_PAUSED:
-      AUD_Handle_resume(m_handle);
+      // a virtual sound is already playing
+      if (!m_voiceManager) {
+        AUD_Handle_resume(m_handle);
+        m_voiceManager = KX_GetActiveEngine()->GetSoundVoiceManager();
+        m_voiceManager->AddVoice(this);
+      }
       break;
     default:
       play();
@@ -379,8 +564,11 @@ EXP_PYMETHODDEF_DOC_NOARGS(SCA_SoundActuator,
                            "\tPauses the sound.\n")
 {
 #  ifdef WITH_AUDASPACE
-  if (m_handle)
+  if (m_handle) {
+    // a paused sound is not virtualized
+    ReleaseVoice();
     AUD_Handle_pause(m_handle);
+  }
 #  endif  // WITH_AUDASPACE
 
   Py_RETURN_NONE;
@@ -392,10 +580,7 @@ EXP_PYMETHODDEF_DOC_NOARGS(SCA_SoundActuator,
                            "\tStops the sound.\n")
 {
 #  ifdef WITH_AUDASPACE
-  if (m_handle) {
-    AUD_Handle_stop(m_handle);
-    m_handle = nullptr;
-  }
+  StopSound();
 #  endif  // WITH_AUDASPACE
 
   Py_RETURN_NONE;
@@ -450,7 +635,7 @@ PyObject *SCA_SoundActuator::pyattr_get_audposition(EXP_PyObjectPlus *self,
   SCA_SoundActuator *actuator = static_cast<SCA_SoundActuator *>(self);
 
   if (actuator->m_handle)
-    position = AUD_Handle_getPosition(actuator->m_handle);
+    position = actuator->GetVoicePosition(KX_GetActiveEngine()->GetRealTime());
 #  endif  // WITH_AUDASPACE
 
   PyObject *result = PyFloat_FromDouble(position);
@@ -582,7 +767,11 @@ int SCA_SoundActuator::pyattr_set_audposition(EXP_PyObjectPlus *self,
 #  ifdef WITH_AUDASPACE
   SCA_SoundActuator *actuator = static_cast<SCA_SoundActuator *>(self);
 
-  if (actuator->m_handle)
+  if (actuator->m_virtual) {
+    actuator->m_virtualPosition = position;
+    actuator->m_virtualTime = KX_GetActiveEngine()->GetRealTime();
+  }
+  else if (actuator->m_handle)
     AUD_Handle_setPosition(actuator->m_handle, position);
 #  endif  // WITH_AUDASPACE
 
@@ -651,4 +840,32 @@ int SCA_SoundActuator::pyattr_set_sound(EXP_PyObjectPlus *self,
   return PY_SET_ATTR_SUCCESS;
 }
 
+PyObject *SCA_SoundActuator::pyattr_get_priority(EXP_PyObjectPlus *self,
+                                                 const struct EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  SCA_SoundActuator *actuator = static_cast<SCA_SoundActuator *>(self);
+  return PyLong_FromLong(actuator->m_priority);
+}
+
+int SCA_SoundActuator::pyattr_set_priority(EXP_PyObjectPlus *self,
+                                           const struct EXP_PYATTRIBUTE_DEF *attrdef,
+                                           PyObject *value)
+{
+  int priority = 0;
+  SCA_SoundActuator *actuator = static_cast<SCA_SoundActuator *>(self);
+  if (!PyArg_Parse(value, "i", &priority))
+    return PY_SET_ATTR_FAIL;
+
+  actuator->m_priority = priority;
+
+  return PY_SET_ATTR_SUCCESS;
+}
+
+PyObject *SCA_SoundActuator::pyattr_get_is_virtual(EXP_PyObjectPlus *self,
+                                                   const struct EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  SCA_SoundActuator *actuator = static_cast<SCA_SoundActuator *>(self);
+  return PyBool_FromLong(actuator->IsVirtual());
+}
+
 #endif  // WITH_PYTHON
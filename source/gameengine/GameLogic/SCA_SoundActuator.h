@@ -51,6 +51,8 @@ typedef struct KX_3DSoundSettings {
   float cone_outer_gain;
 } KX_3DSoundSettings;
 
+class KX_SoundVoiceManager;
+
 class SCA_SoundActuator : public SCA_IActuator {
   Py_Header bool m_isplaying;
 #ifdef WITH_AUDASPACE
@@ -61,8 +63,39 @@ class SCA_SoundActuator : public SCA_IActuator {
   float m_pitch;
   bool m_is3d;
   KX_3DSoundSettings m_3d;
+  /// Priority of the sound against the others when limiting the number of voices.
+  int m_priority;
+  /// Estimated gain of the sound at the listener, without the cone attenuation.
+  float m_voiceGain;
+#ifdef WITH_AUDASPACE
+  /// Voice manager the playing sound is registered to.
+  KX_SoundVoiceManager *m_voiceManager;
+  /// The sound is paused by the voice manager.
+  bool m_virtual;
+  /// The sound loops, a virtual sound wraps its position.
+  bool m_loop;
+  /// Time and position of the sound when it was virtualized.
+  double m_virtualTime;
+  double m_virtualPosition;
+  /// Length of the played sound in seconds, computed when first virtualized, 0 if unknown.
+  double m_length;
+  /// Distance model of the device playing the sound.
+  int m_distanceModel;
+#endif  // WITH_AUDASPACE
 
   void play();
+#ifdef WITH_AUDASPACE
+  /// Stop the sound and unregister it from the voice manager.
+  void StopSound();
+  /// Unregister the sound from the voice manager, a virtual sound stays paused.
+  void ReleaseVoice();
+  /// Return the position the sound reached, updated while it is virtual.
+  double GetVoicePosition(double time) const;
+  /// Return true if the virtual sound reached its end.
+  bool IsVirtualSoundEnded(double time) const;
+  /// Estimate the gain of a 3D sound at the given distance of the listener.
+  float ComputeDistanceGain(float distance) const;
+#endif  // WITH_AUDASPACE
 
  public:
   enum KX_SOUNDACT_TYPE {
@@ -95,6 +128,12 @@ class SCA_SoundActuator : public SCA_IActuator {
   EXP_Value *GetReplica();
   void ProcessReplica();
 
+  int GetPriority() const;
+  float GetVoiceGain() const;
+  bool IsVirtual() const;
+  /// Pause or resume the sound, called by the voice manager.
+  void SetVirtual(bool virt, double time);
+
 #ifdef WITH_PYTHON
 
   /* -------------------------------------------------------------------- */
@@ -123,6 +162,9 @@ class SCA_SoundActuator : public SCA_IActuator {
   static int pyattr_set_sound(EXP_PyObjectPlus *self,
                               const struct EXP_PYATTRIBUTE_DEF *attrdef,
                               PyObject *value);
+  static int pyattr_set_priority(EXP_PyObjectPlus *self,
+                                 const struct EXP_PYATTRIBUTE_DEF *attrdef,
+                                 PyObject *value);
 
   static PyObject *pyattr_get_3d_property(EXP_PyObjectPlus *self,
                                           const struct EXP_PYATTRIBUTE_DEF *attrdef);
@@ -136,6 +178,10 @@ class SCA_SoundActuator : public SCA_IActuator {
                                    const struct EXP_PYATTRIBUTE_DEF *attrdef);
   static PyObject *pyattr_get_sound(EXP_PyObjectPlus *self,
                                     const struct EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_priority(EXP_PyObjectPlus *self,
+                                       const struct EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_is_virtual(EXP_PyObjectPlus *self,
+                                         const struct EXP_PYATTRIBUTE_DEF *attrdef);
 
 #endif /* WITH_PYTHON */
 };
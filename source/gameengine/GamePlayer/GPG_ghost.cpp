@@ -557,6 +557,16 @@ static void usage(const std::string &program, bool isBlenderPlayer)
   CM_Message("       show_camera_frustum            0         Show debug camera frustum volume");
   CM_Message(
       "       show_shadow_frustum            0         Show debug light shadow frustum volume");
+  CM_Message("       frame_pipeline                 0         Step the physics during the render"
+             " (0: off, 1: threaded, 2: sequential)");
+  CM_Message(
+      "       fake_render                    0         Consume the transforms without rendering");
+  CM_Message("       record_input                             Record the inputs and frame times"
+             " to a file");
+  CM_Message("       replay_input                             Replay the inputs and frame times"
+             " of a recorded file");
+  CM_Message("       input_timings                            Write the time of each profile"
+             " category per frame (CSV or .json)");
   CM_Message("       ignore_deprecation_warnings    1         Ignore deprecation warnings"
              << std::endl);
   CM_Message("  -p: override python main loop script");
@@ -1795,6 +1805,12 @@ int main(int argc,
             gs = *launcher.GetGlobalSettings();
 
             launcher.ExitEngine();
+
+            // Quit with an error when the input record can't be replayed or recorded.
+            if (launcher.GetInputRecorderError()) {
+              error = true;
+              exitcode = KX_ExitRequest::QUIT_GAME;
+            }
           }
 
           /* refer to WM_exit_ext() and BKE_blender_free(),
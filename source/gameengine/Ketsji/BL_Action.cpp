@@ -49,6 +49,7 @@ BL_Action::BL_Action(class KX_GameObject *gameobj)
       m_blendpose(nullptr),
       m_blendinpose(nullptr),
       m_obj(gameobj),
+      m_shapeMesh(nullptr),
       m_startframe(0.f),
       m_endframe(0.f),
       m_localframe(0.f),
@@ -80,10 +81,7 @@ BL_Action::BL_Action(class KX_GameObject *gameobj)
 
 BL_Action::~BL_Action()
 {
-  if (m_blendpose)
-    BKE_pose_free(m_blendpose);
-  if (m_blendinpose)
-    BKE_pose_free(m_blendinpose);
+  ReleasePoses();
   ClearControllerList();
 
   Object *ob = m_obj->GetBlenderObject();
@@ -92,6 +90,20 @@ BL_Action::~BL_Action()
   }
 }
 
+void BL_Action::ReleasePoses()
+{
+  if (!m_blendpose && !m_blendinpose) {
+    return;
+  }
+
+  // Give the poses back to the armature pool to be reused by the other actions.
+  BL_ArmatureObject *obj = static_cast<BL_ArmatureObject *>(m_obj);
+  obj->ReleasePose(m_blendpose);
+  obj->ReleasePose(m_blendinpose);
+  m_blendpose = nullptr;
+  m_blendinpose = nullptr;
+}
+
 void BL_Action::ClearControllerList()
 {
   // Clear out the controller list
@@ -178,11 +190,20 @@ bool BL_Action::Play(const std::string &name,
   InitIPO();
 
   // Setup blendin shapes/poses
-  if (m_obj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE) {
+  if (m_obj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE && blendin > 0.0f) {
     BL_ArmatureObject *obj = (BL_ArmatureObject *)m_obj;
     obj->GetPose(&m_blendinpose);
   }
   else {
+    // The action can play a different shape key than the previous one.
+    m_shapeMesh = nullptr;
+    m_keyBlocks.clear();
+
+    Object *ob = m_obj->GetBlenderObject();
+    if (ob && ob->type == OB_MESH && blendin > 0.0f) {
+      ResolveShapeKey((Mesh *)ob->data);
+      GetShape(m_blendinshape);
+    }
   }
 
   // Now that we have an action, we have something we can play
@@ -293,8 +314,56 @@ void BL_Action::IncrementBlending(float curtime)
     m_blendframe = m_blendin;
 }
 
-void BL_Action::BlendShape(Key *key, float srcweight, std::vector<float> &blendshape)
+void BL_Action::ResolveShapeKey(Mesh *me)
 {
+  if (me == m_shapeMesh) {
+    return;
+  }
+
+  m_shapeMesh = me;
+  m_keyBlocks.clear();
+
+  Key *key = me ? me->key : nullptr;
+  if (!key || key->type != KEY_RELATIVE || !key->adt) {
+    return;
+  }
+
+  bool playKeyAction = (key->adt->action == m_action);
+  if (!playKeyAction) {
+    LISTBASE_FOREACH (NlaTrack *, track, &key->adt->nla_tracks) {
+      LISTBASE_FOREACH (NlaStrip *, strip, &track->strips) {
+        if (strip->act == m_action) {
+          playKeyAction = true;
+          break;
+        }
+      }
+    }
+  }
+
+  if (playKeyAction) {
+    LISTBASE_FOREACH (KeyBlock *, kb, &key->block) {
+      m_keyBlocks.push_back(kb);
+    }
+  }
+}
+
+void BL_Action::GetShape(std::vector<float> &shape) const
+{
+  const unsigned int size = m_keyBlocks.size();
+  shape.resize(size);
+  for (unsigned int i = 0; i < size; ++i) {
+    shape[i] = m_keyBlocks[i]->curval;
+  }
+}
+
+void BL_Action::BlendShape(float srcweight, const std::vector<float> &blendshape)
+{
+  const float dstweight = 1.0f - srcweight;
+  const unsigned int size = std::min(m_keyBlocks.size(), blendshape.size());
+  for (unsigned int i = 0; i < size; ++i) {
+    KeyBlock *kb = m_keyBlocks[i];
+    kb->curval = kb->curval * dstweight + blendshape[i] * srcweight;
+  }
 }
 
 enum eActionType {
@@ -458,12 +527,21 @@ void BL_Action::Update(float curtime, bool applyToObject)
       // Blend the poses
       obj->BlendInPose(m_blendinpose, weight, ACT_BLEND_BLEND);
     }
+    else if (m_blendinpose) {
+      // The blend in is finished, the pose can be used by other actions.
+      obj->ReleasePose(m_blendinpose);
+      m_blendinpose = nullptr;
+    }
 
     // Handle layer blending
     if (m_layer_weight >= 0)
       obj->BlendInPose(m_blendpose, m_layer_weight, m_blendmode);
 
     obj->UpdateTimestep(curtime);
+
+    if (m_done) {
+      ReleasePoses();
+    }
   }
   else {
     /* To skip some code if not needed */
@@ -602,27 +680,22 @@ void BL_Action::Update(float curtime, bool applyToObject)
 
     if (!actionIsUpdated) {
       // TEST Shapekeys action
-      Mesh *me = (Mesh *)ob->data;
-      if (ob->type == OB_MESH && me) {
-        const bool bHasShapeKey = me->key && me->key->type == KEY_RELATIVE;
-        bool has_animdata = bHasShapeKey && me->key->adt;
-        bool play_normal_key_action = has_animdata && me->key->adt->action == m_action;
-        bool play_nla_key_action = false;
-        if (!play_normal_key_action && has_animdata) {
-          LISTBASE_FOREACH (NlaTrack *, track, &me->key->adt->nla_tracks) {
-            LISTBASE_FOREACH (NlaStrip *, strip, &track->strips) {
-              if (strip->act == m_action) {
-                play_nla_key_action = true;
-                break;
-              }
-            }
-          }
-        }
-
-        if (play_normal_key_action || play_nla_key_action) {
+      if (ob->type == OB_MESH) {
+        Mesh *me = (Mesh *)ob->data;
+        // The key blocks are resolved once per mesh instead of each update.
+        ResolveShapeKey(me);
+
+        if (!m_keyBlocks.empty()) {
+          // Tagged once per frame for all the actions playing the key, the vertices are blended
+          // when the mesh is evaluated.
           scene->AppendToIdsToUpdateInAllRenderPasses(&me->id, ID_RECALC_GEOMETRY);
           Key *key = me->key;
 
+          // Weights of the previous layers.
+          if (m_layer_weight >= 0) {
+            GetShape(m_blendshape);
+          }
+
           PointerRNA ptrrna = RNA_id_pointer_create(&key->id);
           const blender::animrig::slot_handle_t slot_handle = blender::animrig::first_slot_handle(
               *m_action);
@@ -632,25 +705,13 @@ void BL_Action::Update(float curtime, bool applyToObject)
           if (m_blendin && m_blendframe < m_blendin) {
             IncrementBlending(curtime);
 
-            // float weight = 1.f - (m_blendframe / m_blendin);
-
-            // We go through and clear out the keyblocks so there isn't any interference
-            // from other shape actions
-            KeyBlock *kb;
-            for (kb = (KeyBlock *)key->block.first; kb; kb = (KeyBlock *)kb->next) {
-              kb->curval = 0.f;
-            }
-
-            // Now blend the shape
-            // BlendShape(key, weight, m_blendinshape);
+            const float weight = 1.f - (m_blendframe / m_blendin);
+            BlendShape(weight, m_blendinshape);
+          }
+          // Handle layer blending
+          if (m_layer_weight >= 0) {
+            BlendShape(m_layer_weight, m_blendshape);
           }
-          //// Handle layer blending
-          // if (m_layer_weight >= 0) {
-          //  shape_deformer->GetShape(m_blendshape);
-          //  BlendShape(key, m_layer_weight, m_blendshape);
-          //}
-
-          // shape_deformer->SetLastFrame(curtime);
         }
       }
     }
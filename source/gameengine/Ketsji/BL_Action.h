@@ -38,8 +38,14 @@ class BL_Action {
   struct bPose *m_blendinpose;
   std::vector<class SG_Controller *> m_sg_contr_list;
   class KX_GameObject *m_obj;
+  /// Shape key weights before the action update, used for layer blending.
   std::vector<float> m_blendshape;
+  /// Shape key weights when the action started, used for blend in.
   std::vector<float> m_blendinshape;
+  /// Mesh of which the shape key is played by the action, resolved once per mesh.
+  struct Mesh *m_shapeMesh;
+  /// Blocks of the shape key played by the action, empty if the action doesn't play a shape key.
+  std::vector<struct KeyBlock *> m_keyBlocks;
 
   AnimationEvalContext m_animEvalCtx;
 
@@ -79,11 +85,18 @@ class BL_Action {
   float m_prevUpdate;
 
   void ClearControllerList();
+  /// Give the armature poses back to the armature pool.
+  void ReleasePoses();
   void InitIPO();
   void SetLocalTime(float curtime);
   void ResetStartTime(float curtime);
   void IncrementBlending(float curtime);
-  void BlendShape(struct Key *key, float srcweight, std::vector<float> &blendshape);
+  /// Resolve the shape key blocks played by the action for a mesh.
+  void ResolveShapeKey(struct Mesh *me);
+  /// Store the shape key weights.
+  void GetShape(std::vector<float> &shape) const;
+  /// Blend the shape key weights with the given weights.
+  void BlendShape(float srcweight, const std::vector<float> &blendshape);
 
  public:
   BL_Action(class KX_GameObject *gameobj);
@@ -0,0 +1,361 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_ActivityCullingGrid.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_ActivityCullingGrid.h"
+
+#include <cfloat>
+#include <cmath>
+
+#include "BLI_math_base.h"
+
+#include "EXP_ListValue.h"
+#include "KX_GameObject.h"
+
+/// Size of a grid cell, a cell should be small compared to the usual culling radii.
+static const float cellSize = 16.0f;
+
+KX_ActivityCullingGrid::KX_ActivityCullingGrid()
+    : m_cellSize(cellSize), m_invalid(true), m_frame(0), m_evaluatedCount(0)
+{
+}
+
+KX_ActivityCullingGrid::~KX_ActivityCullingGrid()
+{
+}
+
+KX_ActivityCullingGrid::CellKey KX_ActivityCullingGrid::ComputeCellKey(
+    const MT_Vector3 &pos) const
+{
+  return {(int)std::floor(pos.x() / m_cellSize),
+          (int)std::floor(pos.y() / m_cellSize),
+          (int)std::floor(pos.z() / m_cellSize)};
+}
+
+static void get_radius_range(KX_GameObject *gameobj, float &minRadius, float &maxRadius)
+{
+  const KX_GameObject::ActivityCullingInfo &info = gameobj->GetActivityCullingInfo();
+  if (info.m_flags & KX_GameObject::ActivityCullingInfo::ACTIVITY_PHYSICS) {
+    minRadius = min_ff(minRadius, info.m_physicsRadius);
+    maxRadius = max_ff(maxRadius, info.m_physicsRadius);
+  }
+  if (info.m_flags & KX_GameObject::ActivityCullingInfo::ACTIVITY_LOGIC) {
+    minRadius = min_ff(minRadius, info.m_logicRadius);
+    maxRadius = max_ff(maxRadius, info.m_logicRadius);
+  }
+}
+
+void KX_ActivityCullingGrid::InsertInCell(unsigned int slot, const CellKey &key)
+{
+  Entry &entry = m_entries[slot];
+
+  CellMap::iterator it = m_cells.find(key);
+  if (it == m_cells.end()) {
+    Cell cell;
+    cell.m_minRadius = FLT_MAX;
+    cell.m_maxRadius = 0.0f;
+    cell.m_radiusDirty = false;
+    cell.m_band = BAND_NONE;
+    it = m_cells.emplace(key, cell).first;
+  }
+
+  Cell &cell = it->second;
+  entry.m_cell = key;
+  entry.m_cellIndex = cell.m_slots.size();
+  entry.m_pending = false;
+  cell.m_slots.push_back(slot);
+
+  get_radius_range(entry.m_object, cell.m_minRadius, cell.m_maxRadius);
+}
+
+void KX_ActivityCullingGrid::RemoveFromCell(unsigned int slot)
+{
+  Entry &entry = m_entries[slot];
+  Cell &cell = m_cells[entry.m_cell];
+
+  // Swap remove, the last slot of the cell takes the place of the removed one.
+  const unsigned int lastSlot = cell.m_slots.back();
+  cell.m_slots[entry.m_cellIndex] = lastSlot;
+  m_entries[lastSlot].m_cellIndex = entry.m_cellIndex;
+  cell.m_slots.pop_back();
+
+  // Empty cells are freed during the next update.
+  cell.m_radiusDirty = true;
+  entry.m_pending = true;
+}
+
+void KX_ActivityCullingGrid::EvaluateObject(Entry &entry,
+                                            const std::vector<MT_Vector3> &camPositions)
+{
+  // For each camera compute the distance to objects and keep the minimum distance.
+  const MT_Vector3 &obpos = entry.m_object->NodeGetWorldPosition();
+  float dist = FLT_MAX;
+  for (const MT_Vector3 &campos : camPositions) {
+    dist = min_ff((obpos - campos).length2(), dist);
+  }
+  entry.m_object->UpdateActivity(dist);
+  entry.m_frame = m_frame;
+  ++m_evaluatedCount;
+}
+
+void KX_ActivityCullingGrid::Invalidate()
+{
+  for (Entry &entry : m_entries) {
+    entry.m_object->SetActivityCullingSlot(-1);
+  }
+
+  m_entries.clear();
+  m_cells.clear();
+  m_movedSlots.clear();
+  m_invalid = true;
+}
+
+bool KX_ActivityCullingGrid::IsInvalid() const
+{
+  return m_invalid;
+}
+
+void KX_ActivityCullingGrid::Rebuild(EXP_ListValue<KX_GameObject> *objects)
+{
+  Invalidate();
+  m_invalid = false;
+
+  for (KX_GameObject *gameobj : objects) {
+    AddObject(gameobj);
+  }
+}
+
+void KX_ActivityCullingGrid::AddObject(KX_GameObject *gameobj)
+{
+  // The object will be added when the grid is rebuilt.
+  if (m_invalid) {
+    return;
+  }
+
+  if (gameobj->GetActivityCullingSlot() != -1 ||
+      gameobj->GetActivityCullingInfo().m_flags ==
+          KX_GameObject::ActivityCullingInfo::ACTIVITY_NONE)
+  {
+    return;
+  }
+
+  const unsigned int slot = m_entries.size();
+  Entry entry;
+  entry.m_object = gameobj;
+  entry.m_cell = {0, 0, 0};
+  entry.m_cellIndex = 0;
+  entry.m_pending = true;
+  entry.m_moved = true;
+  entry.m_frame = m_frame;
+  m_entries.push_back(entry);
+
+  gameobj->SetActivityCullingSlot(slot);
+  // Insert the object in a cell and evaluate it during the next update.
+  m_movedSlots.push_back(slot);
+}
+
+void KX_ActivityCullingGrid::RemoveObject(KX_GameObject *gameobj)
+{
+  const int slot = gameobj->GetActivityCullingSlot();
+  if (slot == -1) {
+    return;
+  }
+
+  if (!m_entries[slot].m_pending) {
+    RemoveFromCell(slot);
+  }
+
+  // Swap remove, the last entry takes the slot of the removed one.
+  const unsigned int lastSlot = m_entries.size() - 1;
+  if ((unsigned int)slot != lastSlot) {
+    Entry &last = m_entries[lastSlot];
+    if (!last.m_pending) {
+      m_cells[last.m_cell].m_slots[last.m_cellIndex] = slot;
+    }
+    // The moved slot list still refers the previous slot.
+    if (last.m_moved) {
+      m_movedSlots.push_back(slot);
+    }
+    last.m_object->SetActivityCullingSlot(slot);
+    m_entries[slot] = last;
+  }
+  m_entries.pop_back();
+
+  gameobj->SetActivityCullingSlot(-1);
+}
+
+void KX_ActivityCullingGrid::UpdateObject(KX_GameObject *gameobj)
+{
+  if (gameobj->GetActivityCullingSlot() != -1) {
+    RemoveObject(gameobj);
+    AddObject(gameobj);
+  }
+  /* We can't know if an untracked object is part of the active objects,
+   * rebuild the grid from the scene object list. */
+  else if (gameobj->GetActivityCullingInfo().m_flags !=
+           KX_GameObject::ActivityCullingInfo::ACTIVITY_NONE)
+  {
+    Invalidate();
+  }
+}
+
+void KX_ActivityCullingGrid::TagObjectMoved(KX_GameObject *gameobj)
+{
+  const int slot = gameobj->GetActivityCullingSlot();
+  if (slot == -1) {
+    return;
+  }
+
+  Entry &entry = m_entries[slot];
+  if (!entry.m_moved) {
+    entry.m_moved = true;
+    m_movedSlots.push_back(slot);
+  }
+}
+
+void KX_ActivityCullingGrid::Update(const std::vector<MT_Vector3> &camPositions)
+{
+  ++m_frame;
+  m_evaluatedCount = 0;
+
+  /* Move the objects to their new cell and evaluate them, the list is swapped
+   * as suspending or restoring an object could tag it as moved. */
+  std::vector<unsigned int> movedSlots;
+  movedSlots.swap(m_movedSlots);
+  for (unsigned int slot : movedSlots) {
+    // Outdated slot of a removed entry.
+    if (slot >= m_entries.size()) {
+      continue;
+    }
+
+    Entry &entry = m_entries[slot];
+    if (!entry.m_moved) {
+      continue;
+    }
+    entry.m_moved = false;
+
+    const CellKey key = ComputeCellKey(entry.m_object->NodeGetWorldPosition());
+    if (entry.m_pending || !(key == entry.m_cell)) {
+      if (!entry.m_pending) {
+        RemoveFromCell(slot);
+      }
+      InsertInCell(slot, key);
+      EvaluateObject(entry, camPositions);
+    }
+  }
+
+  for (CellMap::iterator it = m_cells.begin(); it != m_cells.end();) {
+    const CellKey &key = it->first;
+    Cell &cell = it->second;
+
+    if (cell.m_slots.empty()) {
+      it = m_cells.erase(it);
+      continue;
+    }
+
+    if (cell.m_radiusDirty) {
+      cell.m_minRadius = FLT_MAX;
+      cell.m_maxRadius = 0.0f;
+      for (unsigned int slot : cell.m_slots) {
+        get_radius_range(m_entries[slot].m_object, cell.m_minRadius, cell.m_maxRadius);
+      }
+      cell.m_radiusDirty = false;
+    }
+
+    /* Compute the bounds of the squared distance between any point of the cell
+     * and the nearest camera. */
+    const MT_Vector3 cellMin(key.m_x * m_cellSize, key.m_y * m_cellSize, key.m_z * m_cellSize);
+    const MT_Vector3 cellMax = cellMin + MT_Vector3(m_cellSize, m_cellSize, m_cellSize);
+    float lower = FLT_MAX;
+    float upper = FLT_MAX;
+    for (const MT_Vector3 &campos : camPositions) {
+      float mindist = 0.0f;
+      float maxdist = 0.0f;
+      for (unsigned short axis = 0; axis < 3; ++axis) {
+        const float dmin = cellMin[axis] - campos[axis];
+        const float dmax = campos[axis] - cellMax[axis];
+        const float d = max_ff(0.0f, max_ff(dmin, dmax));
+        mindist += d * d;
+        const float dfar = max_ff(fabsf(dmin), fabsf(dmax));
+        maxdist += dfar * dfar;
+      }
+      lower = min_ff(lower, mindist);
+      upper = min_ff(upper, maxdist);
+    }
+
+    Band band;
+    if (upper <= cell.m_minRadius) {
+      band = BAND_NEAR;
+    }
+    else if (lower > cell.m_maxRadius) {
+      band = BAND_FAR;
+    }
+    else {
+      band = BAND_MIXED;
+    }
+
+    // The state of all the objects of the cell is unchanged.
+    if (band == cell.m_band && band != BAND_MIXED) {
+      ++it;
+      continue;
+    }
+    cell.m_band = band;
+
+    for (unsigned int slot : cell.m_slots) {
+      Entry &entry = m_entries[slot];
+      // Already evaluated after a move.
+      if (entry.m_frame == m_frame) {
+        continue;
+      }
+
+      if (band == BAND_MIXED) {
+        EvaluateObject(entry, camPositions);
+      }
+      else {
+        // The cell bounds are enough to decide the state of the object.
+        entry.m_object->UpdateActivity((band == BAND_NEAR) ? upper : lower);
+        entry.m_frame = m_frame;
+        ++m_evaluatedCount;
+      }
+    }
+
+    ++it;
+  }
+}
+
+unsigned int KX_ActivityCullingGrid::GetObjectCount() const
+{
+  return m_entries.size();
+}
+
+unsigned int KX_ActivityCullingGrid::GetCellCount() const
+{
+  return m_cells.size();
+}
+
+unsigned int KX_ActivityCullingGrid::GetEvaluatedCount() const
+{
+  return m_evaluatedCount;
+}
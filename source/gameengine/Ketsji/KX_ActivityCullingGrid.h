@@ -0,0 +1,134 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_ActivityCullingGrid.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "MT_Vector3.h"
+
+template<class T> class EXP_ListValue;
+class KX_GameObject;
+
+/** Uniform hash grid of the objects using activity culling.
+ * Every cell stores the band of its camera distance bounds compared to the
+ * culling radii of its objects. When the band is fully near (all objects are
+ * in their radii) or fully far (all objects are out of their radii) the state
+ * of the objects can be deduced from the cell, so objects are re-evaluated
+ * only when the band of their cell changed, when the band is mixed or when
+ * they were moved to another cell.
+ */
+class KX_ActivityCullingGrid {
+ private:
+  struct CellKey {
+    int m_x;
+    int m_y;
+    int m_z;
+
+    inline bool operator==(const CellKey &other) const
+    {
+      return (m_x == other.m_x && m_y == other.m_y && m_z == other.m_z);
+    }
+  };
+
+  struct CellKeyHash {
+    inline size_t operator()(const CellKey &key) const
+    {
+      return ((size_t)key.m_x * 73856093) ^ ((size_t)key.m_y * 19349663) ^
+             ((size_t)key.m_z * 83492791);
+    }
+  };
+
+  enum Band { BAND_NONE = 0, BAND_NEAR, BAND_FAR, BAND_MIXED };
+
+  struct Cell {
+    std::vector<unsigned int> m_slots;
+    /// Minimum and maximum squared culling radius of the objects in the cell.
+    float m_minRadius;
+    float m_maxRadius;
+    /// The radius range must be recomputed, an object was removed.
+    bool m_radiusDirty;
+    Band m_band;
+  };
+
+  struct Entry {
+    KX_GameObject *m_object;
+    CellKey m_cell;
+    /// Index of the entry slot in the cell slot list.
+    unsigned int m_cellIndex;
+    /// Entry not yet inserted in a cell.
+    bool m_pending;
+    /// Object transform changed since last update.
+    bool m_moved;
+    /// Last frame the object was evaluated.
+    unsigned int m_frame;
+  };
+
+  typedef std::unordered_map<CellKey, Cell, CellKeyHash> CellMap;
+
+  float m_cellSize;
+  CellMap m_cells;
+  std::vector<Entry> m_entries;
+  /// Slots of the entries moved or added since last update, can contain outdated slots.
+  std::vector<unsigned int> m_movedSlots;
+  /// The grid must be rebuilt from the scene object list.
+  bool m_invalid;
+  unsigned int m_frame;
+  /// Number of objects evaluated during the last update.
+  unsigned int m_evaluatedCount;
+
+  CellKey ComputeCellKey(const MT_Vector3 &pos) const;
+  void InsertInCell(unsigned int slot, const CellKey &key);
+  void RemoveFromCell(unsigned int slot);
+  void EvaluateObject(Entry &entry, const std::vector<MT_Vector3> &camPositions);
+
+ public:
+  KX_ActivityCullingGrid();
+  ~KX_ActivityCullingGrid();
+
+  /// Remove all the objects and tag the grid to be rebuilt.
+  void Invalidate();
+  bool IsInvalid() const;
+  /// Recreate the grid from all the active objects of the scene.
+  void Rebuild(EXP_ListValue<KX_GameObject> *objects);
+
+  void AddObject(KX_GameObject *gameobj);
+  void RemoveObject(KX_GameObject *gameobj);
+  /// Update the object after a change of its activity culling flags or radii.
+  void UpdateObject(KX_GameObject *gameobj);
+  /// Tag the object to recompute its cell, called from transform update callbacks.
+  void TagObjectMoved(KX_GameObject *gameobj);
+
+  /** Suspend or restore the objects of cells of which the camera distance band changed.
+   * \param camPositions The positions of all the cameras using activity culling.
+   */
+  void Update(const std::vector<MT_Vector3> &camPositions);
+
+  unsigned int GetObjectCount() const;
+  unsigned int GetCellCount() const;
+  unsigned int GetEvaluatedCount() const;
+};
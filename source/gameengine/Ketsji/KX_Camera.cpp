@@ -40,6 +40,7 @@
 #include "KX_Globals.h"
 #include "KX_PyMath.h"
 #include "KX_RayCast.h"
+#include "KX_Scene.h"
 #include "RAS_ICanvas.h"
 
 KX_Camera::KX_Camera()
@@ -134,6 +135,27 @@ MT_Transform KX_Camera::GetWorldToCamera() const
   return camtrans;
 }
 
+MT_Transform KX_Camera::GetRenderWorldToCamera() const
+{
+  const KX_Scene *scene = static_cast<KX_Scene *>(m_pSGNode->GetSGClientInfo());
+  MT_Vector3 position;
+  MT_Matrix3x3 orientation;
+  MT_Vector3 scaling;
+  if (!m_pSGNode->GetInterpolatedWorldTransform(scene->GetInterpolationTick(),
+                                                scene->GetInterpolationFactor(),
+                                                position,
+                                                orientation,
+                                                scaling))
+  {
+    return GetWorldToCamera();
+  }
+
+  MT_Transform camtrans;
+  camtrans.invert(MT_Transform(position, orientation));
+
+  return camtrans;
+}
+
 MT_Transform KX_Camera::GetCameraToWorld() const
 {
   return MT_Transform(NodeGetWorldPosition(), NodeGetWorldOrientation());
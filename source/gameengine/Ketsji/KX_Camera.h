@@ -135,6 +135,8 @@ class KX_Camera : public KX_GameObject {
   virtual void ProcessReplica();
 
   MT_Transform GetWorldToCamera() const;
+  /// World to camera transform interpolated between the logic steps, used for rendering.
+  MT_Transform GetRenderWorldToCamera() const;
   MT_Transform GetCameraToWorld() const;
 
   /** Sets the projection matrix that is used by the rasterizer. */
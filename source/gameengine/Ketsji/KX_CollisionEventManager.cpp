@@ -31,6 +31,8 @@
 
 #include "KX_CollisionEventManager.h"
 
+#include <algorithm>
+
 #include "KX_CollisionContactPoints.h"
 #include "PHY_IPhysicsController.h"
 #include "PHY_IPhysicsEnvironment.h"
@@ -54,7 +56,13 @@ KX_CollisionEventManager::~KX_CollisionEventManager()
 
 void KX_CollisionEventManager::RemoveNewCollisions()
 {
+  for (const NewCollision &collision : m_newCollisions) {
+    delete collision.colldata;
+  }
+
   m_newCollisions.clear();
+  m_sensorContacts.clear();
+  m_contactPoints.clear();
 }
 
 bool KX_CollisionEventManager::NewHandleCollision(PHY_IPhysicsController *ctrl1,
@@ -62,7 +70,7 @@ bool KX_CollisionEventManager::NewHandleCollision(PHY_IPhysicsController *ctrl1,
                                                   const PHY_ICollData *coll_data,
                                                   bool first)
 {
-  m_newCollisions.insert(NewCollision(ctrl1, ctrl2, coll_data, first));
+  m_newCollisions.push_back({ctrl1, ctrl2, coll_data, first});
 
   return false;
 }
@@ -171,6 +179,47 @@ void KX_CollisionEventManager::EndFrame()
   for (SCA_ISensor *sensor : m_sensors) {
     static_cast<SCA_CollisionSensor *>(sensor)->EndFrame();
   }
+
+  // The contacts of the sensors and their copied points are kept until now.
+  RemoveNewCollisions();
+}
+
+void KX_CollisionEventManager::AddSensorContact(SCA_CollisionSensor *sensor,
+                                                KX_GameObject *object,
+                                                const PHY_ICollData *colldata,
+                                                bool first)
+{
+  const unsigned int numPoints = colldata->GetNumContacts();
+  m_sensorContacts.push_back({sensor, object, (unsigned int)m_contactPoints.size(), numPoints});
+
+  for (unsigned int i = 0; i < numPoints; ++i) {
+    m_contactPoints.push_back({colldata->GetWorldPoint(i, first),
+                               colldata->GetNormal(i, first),
+                               colldata->GetAppliedImpulse(i, first)});
+  }
+}
+
+void KX_CollisionEventManager::UpdateSensorContacts()
+{
+  // Group the contacts of each sensor, keeping the order of the collisions.
+  std::stable_sort(m_sensorContacts.begin(),
+                   m_sensorContacts.end(),
+                   [](const SCA_CollisionContact &a, const SCA_CollisionContact &b) {
+                     return a.m_sensor < b.m_sensor;
+                   });
+
+  for (std::vector<SCA_CollisionContact>::iterator it = m_sensorContacts.begin(),
+                                                   end = m_sensorContacts.end();
+       it != end;)
+  {
+    SCA_CollisionSensor *sensor = it->m_sensor;
+    std::vector<SCA_CollisionContact>::iterator last = std::find_if(
+        it, end, [sensor](const SCA_CollisionContact &contact) {
+          return contact.m_sensor != sensor;
+        });
+    sensor->SetContacts(&*it, last - it, m_contactPoints.data());
+    it = last;
+  }
 }
 
 void KX_CollisionEventManager::NextFrame()
@@ -183,43 +232,46 @@ void KX_CollisionEventManager::NextFrame()
     // Controllers
     PHY_IPhysicsController *ctrl1 = collision.first;
     PHY_IPhysicsController *ctrl2 = collision.second;
-    // Sensor iterator
-    std::list<SCA_ISensor *>::iterator sit;
+    const PHY_ICollData *colldata = collision.colldata;
 
-    // First client info
-    KX_ClientObjectInfo *client_info = static_cast<KX_ClientObjectInfo *>(
+    KX_ClientObjectInfo *client_info1 = static_cast<KX_ClientObjectInfo *>(
         ctrl1->GetNewClientInfo());
-    // First gameobject
-    KX_GameObject *kxObj1 = KX_GameObject::GetClientObject(client_info);
-    // Invoke sensor response for each object
-    if (client_info) {
-      for (sit = client_info->m_sensors.begin(); sit != client_info->m_sensors.end(); ++sit) {
-        static_cast<SCA_CollisionSensor *>(*sit)->NewHandleCollision(ctrl1, ctrl2, nullptr);
+    KX_ClientObjectInfo *client_info2 = static_cast<KX_ClientObjectInfo *>(
+        ctrl2->GetNewClientInfo());
+    KX_GameObject *kxObj1 = KX_GameObject::GetClientObject(client_info1);
+    KX_GameObject *kxObj2 = KX_GameObject::GetClientObject(client_info2);
+
+    // Invoke sensor response for each object and record the accepted contacts.
+    if (client_info1) {
+      for (SCA_ISensor *sensor : client_info1->m_sensors) {
+        SCA_CollisionSensor *collisionsensor = static_cast<SCA_CollisionSensor *>(sensor);
+        if (collisionsensor->NewHandleCollision(ctrl1, ctrl2, colldata)) {
+          AddSensorContact(collisionsensor, kxObj2, colldata, collision.isFirst);
+        }
       }
     }
 
-    // Second client info
-    client_info = static_cast<KX_ClientObjectInfo *>(ctrl2->GetNewClientInfo());
-    // Second gameobject
-    KX_GameObject *kxObj2 = KX_GameObject::GetClientObject(client_info);
-    if (client_info) {
-      for (sit = client_info->m_sensors.begin(); sit != client_info->m_sensors.end(); ++sit) {
-        static_cast<SCA_CollisionSensor *>(*sit)->NewHandleCollision(ctrl2, ctrl1, nullptr);
+    if (client_info2) {
+      for (SCA_ISensor *sensor : client_info2->m_sensors) {
+        SCA_CollisionSensor *collisionsensor = static_cast<SCA_CollisionSensor *>(sensor);
+        if (collisionsensor->NewHandleCollision(ctrl2, ctrl1, colldata)) {
+          AddSensorContact(collisionsensor, kxObj1, colldata, !collision.isFirst);
+        }
       }
     }
+
     // Run python callbacks
-    const PHY_ICollData *colldata = collision.colldata;
     KX_CollisionContactPointList contactPointList0 = KX_CollisionContactPointList(colldata, collision.isFirst);
     KX_CollisionContactPointList contactPointList1 = KX_CollisionContactPointList(colldata, !collision.isFirst);
     kxObj1->RunCollisionCallbacks(kxObj2, contactPointList0);
     kxObj2->RunCollisionCallbacks(kxObj1, contactPointList1);
   }
 
+  UpdateSensorContacts();
+
   for (SCA_ISensor *sensor : m_sensors) {
     sensor->Activate(m_logicmgr);
   }
-
-  RemoveNewCollisions();
 }
 
 SCA_LogicManager *KX_CollisionEventManager::GetLogicManager()
@@ -231,31 +283,3 @@ PHY_IPhysicsEnvironment *KX_CollisionEventManager::GetPhysicsEnvironment()
 {
   return m_physEnv;
 }
-
-KX_CollisionEventManager::NewCollision::NewCollision(PHY_IPhysicsController *_first,
-                                                     PHY_IPhysicsController *_second,
-                                                     const PHY_ICollData *_colldata,
-                                                     bool _isfirst)
-    : first(_first), second(_second), colldata(_colldata), isFirst(_isfirst)
-{
-}
-
-KX_CollisionEventManager::NewCollision::NewCollision(const NewCollision &to_copy)
-    : first(to_copy.first), second(to_copy.second), colldata(to_copy.colldata), isFirst(to_copy.isFirst)
-{
-}
-
-bool KX_CollisionEventManager::NewCollision::operator<(const NewCollision &other) const
-{
-  // see strict weak ordering: https://support.microsoft.com/en-us/kb/949171
-  if (first == other.first) {
-    if (second == other.second) {
-      if (colldata == other.colldata) {
-        return isFirst < other.isFirst;
-      }
-      return colldata < other.colldata;
-    }
-    return second < other.second;
-  }
-  return first < other.first;
-}
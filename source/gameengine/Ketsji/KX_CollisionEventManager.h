@@ -31,7 +31,6 @@
 
 #pragma once
 
-#include <set>
 #include <vector>
 
 #include "KX_GameObject.h"
@@ -45,31 +44,29 @@ class KX_CollisionEventManager : public SCA_EventManager {
   /**
    * Contains two colliding objects and the first contact point.
    */
-  class NewCollision {
-   public:
+  struct NewCollision {
     PHY_IPhysicsController *first;
     PHY_IPhysicsController *second;
+    /// Owned by the manager and deleted at the end of the frame.
     const PHY_ICollData *colldata;
     bool isFirst;
-
-    /**
-     * Creates a copy of the given PHY_ICollData; freeing that copy should be done by the owner of
-     * the NewCollision object.
-     *
-     * This allows us to efficiently store NewCollision objects in a std::set without creating more
-     * copies of colldata, as the NewCollision copy constructor reuses the pointer and doesn't
-     * clone it again. */
-    NewCollision(PHY_IPhysicsController *first,
-                 PHY_IPhysicsController *second,
-                 const PHY_ICollData *colldata,
-                 bool isFirst);
-    NewCollision(const NewCollision &to_copy);
-    bool operator<(const NewCollision &other) const;
   };
 
   PHY_IPhysicsEnvironment *m_physEnv;
 
-  std::set<NewCollision> m_newCollisions;
+  /** Collisions reported by the last physics step, in the order of the physics.
+   * The vector is cleared at the end of each frame but keeps its storage, so that
+   * it is used as an arena for the collisions of the next frames.
+   */
+  std::vector<NewCollision> m_newCollisions;
+  /** Contacts accepted by the sensors in the current frame, grouped by sensor.
+   * Each sensor refers to its span of contacts until the end of the frame.
+   */
+  std::vector<SCA_CollisionContact> m_sensorContacts;
+  /** Points of the contacts, copied during the collision pass as the collision data refers
+   * to physics manifolds that the logic can free, e.g. by suspending the physics.
+   */
+  std::vector<SCA_CollisionContactPoint> m_contactPoints;
 
   static bool newCollisionResponse(void *client_data,
                                    PHY_IPhysicsController *ctrl1,
@@ -88,6 +85,13 @@ class KX_CollisionEventManager : public SCA_EventManager {
                                   const PHY_ICollData *coll_data,
                                   bool first);
 
+  /// Record a contact accepted by a sensor and copy its points.
+  void AddSensorContact(SCA_CollisionSensor *sensor,
+                        KX_GameObject *object,
+                        const PHY_ICollData *colldata,
+                        bool first);
+  /// Group the contacts by sensor and give each sensor its span.
+  void UpdateSensorContacts();
   void RemoveNewCollisions();
 
  public:
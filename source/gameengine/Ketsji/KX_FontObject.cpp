@@ -54,12 +54,20 @@ static std::vector<std::string> split_string(std::string str)
   return text;
 }
 
-KX_FontObject::KX_FontObject() : KX_GameObject(), m_object(nullptr), m_rasterizer(nullptr)
+static const std::string textPropName = "Text";
+
+KX_FontObject::KX_FontObject()
+    : KX_GameObject(),
+      m_textProp(nullptr),
+      m_textModified(false),
+      m_object(nullptr),
+      m_rasterizer(nullptr)
 {
 }
 
 KX_FontObject::~KX_FontObject()
 {
+  BindTextProperty(nullptr);
   // remove font from the scene list
   // it's handled in KX_Scene::NewRemoveObject
   UpdateCurveText(m_backupText);  // eevee
@@ -73,6 +81,77 @@ KX_PythonProxy *KX_FontObject::NewInstance()
 void KX_FontObject::ProcessReplica()
 {
   KX_GameObject::ProcessReplica();
+
+  // The properties were replicated, the replica is added to the modified fonts by the scene.
+  m_textProp = nullptr;
+  m_textModified = false;
+  BindTextProperty(GetProperty(textPropName));
+}
+
+void KX_FontObject::SetProperty(const std::string &name, EXP_Value *ioProperty)
+{
+  if (name != textPropName || !ioProperty) {
+    KX_GameObject::SetProperty(name, ioProperty);
+    return;
+  }
+
+  // Stop observing the previous text property first, setting the new one releases it.
+  BindTextProperty(nullptr);
+  KX_GameObject::SetProperty(name, ioProperty);
+  BindTextProperty(ioProperty);
+  TagTextModified();
+}
+
+bool KX_FontObject::RemoveProperty(const std::string &inName)
+{
+  if (inName == textPropName) {
+    BindTextProperty(nullptr);
+  }
+
+  return KX_GameObject::RemoveProperty(inName);
+}
+
+void KX_FontObject::ClearProperties()
+{
+  BindTextProperty(nullptr);
+  KX_GameObject::ClearProperties();
+}
+
+void KX_FontObject::ValueModified(EXP_PropValue *value)
+{
+  TagTextModified();
+}
+
+bool KX_FontObject::IsTextModified() const
+{
+  return m_textModified;
+}
+
+void KX_FontObject::SetTextModified(bool modified)
+{
+  m_textModified = modified;
+}
+
+void KX_FontObject::BindTextProperty(EXP_Value *prop)
+{
+  if (m_textProp && m_textProp->GetObserver() == this) {
+    m_textProp->SetObserver(nullptr);
+  }
+
+  m_textProp = dynamic_cast<EXP_PropValue *>(prop);
+  if (m_textProp) {
+    m_textProp->SetObserver(this);
+  }
+}
+
+void KX_FontObject::TagTextModified()
+{
+  // Multiple modifications in a frame are coalesced in one text update.
+  if (m_textModified || !m_pSGNode) {
+    return;
+  }
+
+  GetScene()->AddModifiedFont(this);
 }
 
 void KX_FontObject::SetText(const std::string &text)
@@ -85,18 +164,35 @@ void KX_FontObject::UpdateCurveText(std::string newText)  // eevee
 {
   Object *ob = GetBlenderObject();
   Curve *cu = (Curve *)ob->data;
-  if (cu->str)
-    MEM_freeN(cu->str);
-  if (cu->strinfo)
-    MEM_freeN(cu->strinfo);
+
+  // Nothing to lay out again if the curve already shows the text.
+  if (cu->str && newText == cu->str) {
+    return;
+  }
 
   size_t len_bytes;
   size_t len_chars = BLI_strlen_utf8_ex(newText.c_str(), &len_bytes);
 
+  // Reuse the curve buffers when they are large enough, a changing HUD text often keeps its size.
+  const size_t strinfo_size = (len_chars + 1) * sizeof(CharInfo);
+  if (cu->strinfo && MEM_allocN_len(cu->strinfo) >= strinfo_size) {
+    memset(cu->strinfo, 0, strinfo_size);
+  }
+  else {
+    if (cu->strinfo)
+      MEM_freeN(cu->strinfo);
+    cu->strinfo = static_cast<CharInfo *>(MEM_callocN(strinfo_size, __func__));
+  }
+
+  const size_t str_size = len_bytes + sizeof(char32_t);
+  if (!cu->str || MEM_allocN_len(cu->str) < str_size) {
+    if (cu->str)
+      MEM_freeN(cu->str);
+    cu->str = static_cast<char *>(MEM_mallocN(str_size, __func__));
+  }
+
   cu->len_char32 = len_chars;
   cu->len = len_bytes;
-  cu->strinfo = static_cast<CharInfo *>(MEM_callocN((len_chars + 1) * sizeof(CharInfo), __func__));
-  cu->str = static_cast<char *>(MEM_mallocN(len_bytes + sizeof(char32_t), __func__));
   memcpy(cu->str, newText.c_str(), len_bytes + 1);
 
   if (ob->gameflag & OB_OVERLAY_COLLECTION) {
@@ -110,9 +206,8 @@ void KX_FontObject::UpdateCurveText(std::string newText)  // eevee
 void KX_FontObject::UpdateTextFromProperty()
 {
   // Allow for some logic brick control
-  EXP_Value *prop = GetProperty("Text");
-  if (prop && prop->GetText() != m_text) {
-    SetText(prop->GetText());
+  if (m_textProp && m_textProp->GetText() != m_text) {
+    SetText(m_textProp->GetText());
     UpdateCurveText(m_text);  // eevee
   }
 }
@@ -33,7 +33,10 @@
 
 #include "KX_GameObject.h"
 
-class KX_FontObject : public KX_GameObject {
+/** The text is updated from the "Text" property when the scene is notified of a modification,
+ * the modifications of a logic frame are applied once in KX_Scene::LogicEndFrame.
+ */
+class KX_FontObject : public KX_GameObject, public EXP_PropValue::Observer {
   Py_Header
 
       public : KX_FontObject();
@@ -41,6 +44,15 @@ class KX_FontObject : public KX_GameObject {
 
   virtual KX_PythonProxy *NewInstance();
   virtual void ProcessReplica();
+
+  virtual void SetProperty(const std::string &name, EXP_Value *ioProperty);
+  virtual bool RemoveProperty(const std::string &inName);
+  virtual void ClearProperties();
+  virtual void ValueModified(EXP_PropValue *value);
+
+  /// Return true if the font is in the modified fonts of the scene.
+  bool IsTextModified() const;
+  void SetTextModified(bool modified);
   virtual int GetGameObjectType() const
   {
     return OBJ_TEXT;
@@ -66,6 +78,15 @@ class KX_FontObject : public KX_GameObject {
 #endif
 
  protected:
+  /// Observe the "Text" property to notify the scene of its modifications.
+  void BindTextProperty(EXP_Value *prop);
+  /// Notify the scene that the text property changed.
+  void TagTextModified();
+
+  /// The observed "Text" property.
+  EXP_PropValue *m_textProp;
+  bool m_textModified;
+
   std::string m_text;
   std::vector<std::string> m_texts;
   Object *m_object;
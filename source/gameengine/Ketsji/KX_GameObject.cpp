@@ -87,6 +87,7 @@ KX_GameObject::KX_GameObject()
       m_visibleAtGameStart(false),   // eevee
       m_forceIgnoreParentTx(false),  // eevee
       m_previousLodLevel(-1),        // eevee
+      m_interpolatedTransform(false),
       m_layer(0),
       m_lodManager(nullptr),
       m_currentLodLevel(0),
@@ -96,6 +97,9 @@ KX_GameObject::KX_GameObject()
       m_objectColor(1.0f, 1.0f, 1.0f, 1.0f),
       m_bVisible(true),
       m_bOccluder(false),
+      m_activityCullingSlot(-1),
+      m_pythonProxySlot(-1),
+      m_pythonProxyDepth(0),
       m_pPhysicsController(nullptr),
       m_pSGNode(nullptr),
       m_pInstanceObjects(nullptr),
@@ -104,6 +108,9 @@ KX_GameObject::KX_GameObject()
 #ifdef WITH_PYTHON
       ,
       m_components(NULL),
+#  ifdef USE_MATHUTILS
+      m_mathutilsObjects(nullptr),
+#  endif
       m_attr_dict(nullptr),
       m_collisionCallbacks(nullptr),
       m_removeCallbacks(nullptr)
@@ -137,6 +144,10 @@ KX_GameObject::~KX_GameObject()
   if (m_components) {
     m_components->Release();
   }
+
+#  ifdef USE_MATHUTILS
+  ClearMathutilsObjects();
+#  endif
 #endif  // WITH_PYTHON
 
   /* EEVEE INTEGRATION */
@@ -254,8 +265,14 @@ void KX_GameObject::ForceIgnoreParentTx()
 void KX_GameObject::TagForTransformUpdate(bool is_overlay_pass, bool is_last_render_pass)
 {
   float object_to_world[4][4];
-  NodeGetWorldTransform().getValue(&object_to_world[0][0]);
-  bool staticObject = true;
+  bool interpolated;
+  NodeGetRenderTransform(interpolated).getValue(&object_to_world[0][0]);
+  /* An interpolated object moves every render, also update the object after the
+   * last interpolated render to restore its exact transform. */
+  bool staticObject = !(interpolated || m_interpolatedTransform);
+  if (is_last_render_pass) {
+    m_interpolatedTransform = interpolated;
+  }
   if (GetSGNode()->IsDirty(SG_Node::DIRTY_RENDER)) {
     staticObject = false;
     /* Wait the end of all render passes (main + custom viewports)
@@ -332,7 +349,8 @@ void KX_GameObject::TagForTransformUpdate(bool is_overlay_pass, bool is_last_ren
 void KX_GameObject::TagForTransformUpdateEvaluated()
 {
   float object_to_world[4][4];
-  NodeGetWorldTransform().getValue(&object_to_world[0][0]);
+  bool interpolated;
+  NodeGetRenderTransform(interpolated).getValue(&object_to_world[0][0]);
 
   bContext *C = KX_GetActiveEngine()->GetContext();
   Depsgraph *depsgraph = CTX_data_depsgraph_on_load(C);
@@ -571,6 +589,7 @@ KX_GameObject::ActivityCullingInfo &KX_GameObject::GetActivityCullingInfo()
 void KX_GameObject::SetActivityCullingInfo(const ActivityCullingInfo &cullingInfo)
 {
   m_activityCullingInfo = cullingInfo;
+  UpdateActivityCullingGrid();
 }
 
 void KX_GameObject::SetActivityCulling(ActivityCullingInfo::Flag flag, bool enable)
@@ -591,6 +610,16 @@ void KX_GameObject::SetActivityCulling(ActivityCullingInfo::Flag flag, bool enab
       RestoreLogicAndActions(false);
     }
   }
+
+  UpdateActivityCullingGrid();
+}
+
+void KX_GameObject::UpdateActivityCullingGrid()
+{
+  // The object is not yet in a scene during conversion.
+  if (m_pSGNode) {
+    GetScene()->GetActivityCullingGrid().UpdateObject(this);
+  }
 }
 
 void KX_GameObject::AddDummyLodManager(RAS_MeshObject *meshObj, Object *ob)
@@ -633,6 +662,10 @@ std::string KX_GameObject::GetName()
 void KX_GameObject::SetName(const std::string &name)
 {
   m_name = name;
+  // Only the lists of the scene containing the object index it by name.
+  if (m_pSGNode) {
+    GetScene()->UpdateObjectName(this);
+  }
 }
 
 PHY_IPhysicsController *KX_GameObject::GetPhysicsController()
@@ -921,6 +954,8 @@ void KX_GameObject::ProcessReplica()
 
   m_pPhysicsController = nullptr;
   m_pSGNode = nullptr;
+  m_activityCullingSlot = -1;
+  m_pythonProxySlot = -1;
 
   /* Dupli group and instance list are set later in replication.
    * See KX_Scene::DupliGroupRecurse. */
@@ -933,6 +968,10 @@ void KX_GameObject::ProcessReplica()
 
 #ifdef WITH_PYTHON
 
+#  ifdef USE_MATHUTILS
+  m_mathutilsObjects = nullptr;
+#  endif
+
   if (m_attr_dict)
     m_attr_dict = PyDict_Copy(m_attr_dict);
 
@@ -1212,6 +1251,7 @@ void KX_GameObject::UpdateTransform()
 void KX_GameObject::UpdateTransformFunc(SG_Node *node, void *gameobj, void *scene)
 {
   ((KX_GameObject *)gameobj)->UpdateTransform();
+  ((KX_Scene *)scene)->GetActivityCullingGrid().TagObjectMoved((KX_GameObject *)gameobj);
 }
 
 void KX_GameObject::SynchronizeTransform()
@@ -1224,6 +1264,7 @@ void KX_GameObject::SynchronizeTransform()
 void KX_GameObject::SynchronizeTransformFunc(SG_Node *node, void *gameobj, void *scene)
 {
   ((KX_GameObject *)gameobj)->SynchronizeTransform();
+  ((KX_Scene *)scene)->GetActivityCullingGrid().TagObjectMoved((KX_GameObject *)gameobj);
 }
 
 void KX_GameObject::InitIPO(bool ipo_as_force, bool ipo_add, bool ipo_local)
@@ -1720,6 +1761,23 @@ MT_Transform KX_GameObject::NodeGetWorldTransform() const
   return m_pSGNode->GetWorldTransform();
 }
 
+MT_Transform KX_GameObject::NodeGetRenderTransform(bool &interpolated) const
+{
+  const KX_Scene *scene = static_cast<KX_Scene *>(m_pSGNode->GetSGClientInfo());
+  MT_Vector3 position;
+  MT_Matrix3x3 orientation;
+  MT_Vector3 scaling;
+  interpolated = m_pSGNode->GetInterpolatedWorldTransform(scene->GetInterpolationTick(),
+                                                          scene->GetInterpolationFactor(),
+                                                          position,
+                                                          orientation,
+                                                          scaling);
+  if (!interpolated) {
+    return m_pSGNode->GetWorldTransform();
+  }
+  return MT_Transform(position, orientation.scaled(scaling[0], scaling[1], scaling[2]));
+}
+
 MT_Transform KX_GameObject::NodeGetLocalTransform() const
 {
   return m_pSGNode->GetLocalTransform();
@@ -1893,7 +1951,10 @@ void KX_GameObject::Update()
   if (!m_logicSuspended) {
     if (m_components) {
       for (KX_PythonComponent *comp : m_components) {
-        comp->Update();
+        // Scheduled components are updated by the scene proxy manager.
+        if (comp->GetSchedulerGroup() == -1) {
+          comp->Update();
+        }
       }
     }
 
@@ -2158,6 +2219,61 @@ static Mathutils_Callback mathutils_kxgameob_matrix_cb = {mathutils_kxgameob_gen
                                                           nullptr,
                                                           nullptr};
 
+/// Number of reusable mathutils objects, vectors first then matrices.
+#  define MATHUTILS_OBJECT_COUNT (MATHUTILS_VEC_CB_GRAVITY + MATHUTILS_MAT_CB_ORI_GLOBAL + 1)
+
+void KX_GameObject::ClearMathutilsObjects()
+{
+  if (!m_mathutilsObjects) {
+    return;
+  }
+
+  for (unsigned short i = 0; i < MATHUTILS_OBJECT_COUNT; ++i) {
+    Py_XDECREF(m_mathutilsObjects[i]);
+  }
+  delete[] m_mathutilsObjects;
+  m_mathutilsObjects = nullptr;
+}
+
+PyObject *KX_GameObject::GetMathutilsObject(int subtype, bool matrix, int size)
+{
+  PyObject *proxy = EXP_PROXY_FROM_REF_BORROW(this);
+
+  /* The objects are holding a reference to the proxy, they can't be stored when
+   * the proxy owns the game object. */
+  if (EXP_PROXY_PYOWNS(proxy)) {
+    return (matrix) ? Matrix_CreatePyObject_cb(
+                          proxy, size, size, mathutils_kxgameob_matrix_cb_index, subtype) :
+                      Vector_CreatePyObject_cb(
+                          proxy, size, mathutils_kxgameob_vector_cb_index, subtype);
+  }
+
+  if (!m_mathutilsObjects) {
+    m_mathutilsObjects = new PyObject *[MATHUTILS_OBJECT_COUNT]();
+  }
+
+  PyObject *&cached = m_mathutilsObjects[(matrix) ? MATHUTILS_VEC_CB_GRAVITY + subtype : subtype];
+  /* When only referenced by the game object the previous object can't be observed
+   * by any script, as the values are read from the callbacks on each access it can be
+   * returned again. */
+  if (cached && Py_REFCNT(cached) == 1 && ((BaseMathObject *)cached)->cb_user == proxy) {
+    Py_INCREF(cached);
+    return cached;
+  }
+
+  PyObject *obj = (matrix) ? Matrix_CreatePyObject_cb(
+                                 proxy, size, size, mathutils_kxgameob_matrix_cb_index, subtype) :
+                             Vector_CreatePyObject_cb(
+                                 proxy, size, mathutils_kxgameob_vector_cb_index, subtype);
+  if (obj) {
+    Py_XDECREF(cached);
+    Py_INCREF(obj);
+    cached = obj;
+  }
+
+  return obj;
+}
+
 void KX_GameObject_Mathutils_Callback_Init(void)
 {
   // register mathutils callbacks, ok to run more than once.
@@ -2477,7 +2593,7 @@ static PyObject *Map_GetItem(PyObject *self_v, PyObject *item)
   }
 
   /* first see if the attributes a string and try get the cvalue attribute */
-  if (attr_str && (resultattr = self->GetProperty(attr_str))) {
+  if (attr_str && (resultattr = self->GetPropertyFromPython(item))) {
     pyconvert = resultattr->ConvertValueToPython();
     return pyconvert ? pyconvert : resultattr->GetProxy();
   }
@@ -2546,7 +2662,7 @@ static int Map_SetItem(PyObject *self_v, PyObject *key, PyObject *val)
       EXP_Value *vallie = self->ConvertPythonToValue(val, false, "gameOb[key] = value: ");
 
       if (vallie) {
-        EXP_Value *oldprop = self->GetProperty(attr_str);
+        EXP_Value *oldprop = self->GetPropertyFromPython(key);
 
         if (oldprop)
           oldprop->SetValue(vallie);
@@ -2606,7 +2722,7 @@ static int Seq_Contains(PyObject *self_v, PyObject *value)
     return -1;
   }
 
-  if (PyUnicode_Check(value) && self->GetProperty(_PyUnicode_AsString(value)))
+  if (PyUnicode_Check(value) && self->GetPropertyFromPython(value))
     return 1;
 
   if (self->m_attr_dict && PyDict_GetItem(self->m_attr_dict, value))
@@ -3241,6 +3357,7 @@ int KX_GameObject::pyattr_set_physicsCullingRadius(EXP_PyObjectPlus *self_v,
   }
 
   self->GetActivityCullingInfo().m_physicsRadius = val * val;
+  self->UpdateActivityCullingGrid();
 
   return PY_SET_ATTR_SUCCESS;
 }
@@ -3266,6 +3383,7 @@ int KX_GameObject::pyattr_set_logicCullingRadius(EXP_PyObjectPlus *self_v,
   }
 
   self->GetActivityCullingInfo().m_logicRadius = val * val;
+  self->UpdateActivityCullingGrid();
 
   return PY_SET_ATTR_SUCCESS;
 }
@@ -3274,10 +3392,8 @@ PyObject *KX_GameObject::pyattr_get_worldPosition(EXP_PyObjectPlus *self_v,
                                                   const EXP_PYATTRIBUTE_DEF *attrdef)
 {
 #  ifdef USE_MATHUTILS
-  return Vector_CreatePyObject_cb(EXP_PROXY_FROM_REF_BORROW(self_v),
-                                  3,
-                                  mathutils_kxgameob_vector_cb_index,
-                                  MATHUTILS_VEC_CB_POS_GLOBAL);
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  return self->GetMathutilsObject(MATHUTILS_VEC_CB_POS_GLOBAL, false, 3);
 #  else
   KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
   return PyObjectFrom(self->NodeGetWorldPosition());
@@ -3302,10 +3418,8 @@ PyObject *KX_GameObject::pyattr_get_localPosition(EXP_PyObjectPlus *self_v,
                                                   const EXP_PYATTRIBUTE_DEF *attrdef)
 {
 #  ifdef USE_MATHUTILS
-  return Vector_CreatePyObject_cb(EXP_PROXY_FROM_REF_BORROW(self_v),
-                                  3,
-                                  mathutils_kxgameob_vector_cb_index,
-                                  MATHUTILS_VEC_CB_POS_LOCAL);
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  return self->GetMathutilsObject(MATHUTILS_VEC_CB_POS_LOCAL, false, 3);
 #  else
   KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
   return PyObjectFrom(self->NodeGetLocalPosition());
@@ -3330,10 +3444,8 @@ PyObject *KX_GameObject::pyattr_get_localInertia(EXP_PyObjectPlus *self_v,
                                                  const EXP_PYATTRIBUTE_DEF *attrdef)
 {
 #  ifdef USE_MATHUTILS
-  return Vector_CreatePyObject_cb(EXP_PROXY_FROM_REF_BORROW(self_v),
-                                  3,
-                                  mathutils_kxgameob_vector_cb_index,
-                                  MATHUTILS_VEC_CB_INERTIA_LOCAL);
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  return self->GetMathutilsObject(MATHUTILS_VEC_CB_INERTIA_LOCAL, false, 3);
 #  else
   KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
   if (self->GetPhysicsController1())
@@ -3346,11 +3458,8 @@ PyObject *KX_GameObject::pyattr_get_worldOrientation(EXP_PyObjectPlus *self_v,
                                                      const EXP_PYATTRIBUTE_DEF *attrdef)
 {
 #  ifdef USE_MATHUTILS
-  return Matrix_CreatePyObject_cb(EXP_PROXY_FROM_REF_BORROW(self_v),
-                                  3,
-                                  3,
-                                  mathutils_kxgameob_matrix_cb_index,
-                                  MATHUTILS_MAT_CB_ORI_GLOBAL);
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  return self->GetMathutilsObject(MATHUTILS_MAT_CB_ORI_GLOBAL, true, 3);
 #  else
   KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
   return PyObjectFrom(self->NodeGetWorldOrientation());
@@ -3378,11 +3487,8 @@ PyObject *KX_GameObject::pyattr_get_localOrientation(EXP_PyObjectPlus *self_v,
                                                      const EXP_PYATTRIBUTE_DEF *attrdef)
 {
 #  ifdef USE_MATHUTILS
-  return Matrix_CreatePyObject_cb(EXP_PROXY_FROM_REF_BORROW(self_v),
-                                  3,
-                                  3,
-                                  mathutils_kxgameob_matrix_cb_index,
-                                  MATHUTILS_MAT_CB_ORI_LOCAL);
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  return self->GetMathutilsObject(MATHUTILS_MAT_CB_ORI_LOCAL, true, 3);
 #  else
   KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
   return PyObjectFrom(self->NodeGetLocalOrientation());
@@ -3409,10 +3515,8 @@ PyObject *KX_GameObject::pyattr_get_worldScaling(EXP_PyObjectPlus *self_v,
                                                  const EXP_PYATTRIBUTE_DEF *attrdef)
 {
 #  ifdef USE_MATHUTILS
-  return Vector_CreatePyObject_cb(EXP_PROXY_FROM_REF_BORROW(self_v),
-                                  3,
-                                  mathutils_kxgameob_vector_cb_index,
-                                  MATHUTILS_VEC_CB_SCALE_GLOBAL);
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  return self->GetMathutilsObject(MATHUTILS_VEC_CB_SCALE_GLOBAL, false, 3);
 #  else
   KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
   return PyObjectFrom(self->NodeGetWorldScaling());
@@ -3437,10 +3541,8 @@ PyObject *KX_GameObject::pyattr_get_localScaling(EXP_PyObjectPlus *self_v,
                                                  const EXP_PYATTRIBUTE_DEF *attrdef)
 {
 #  ifdef USE_MATHUTILS
-  return Vector_CreatePyObject_cb(EXP_PROXY_FROM_REF_BORROW(self_v),
-                                  3,
-                                  mathutils_kxgameob_vector_cb_index,
-                                  MATHUTILS_VEC_CB_SCALE_LOCAL);
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  return self->GetMathutilsObject(MATHUTILS_VEC_CB_SCALE_LOCAL, false, 3);
 #  else
   KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
   return PyObjectFrom(self->NodeGetLocalScaling());
@@ -3539,10 +3641,8 @@ PyObject *KX_GameObject::pyattr_get_worldLinearVelocity(EXP_PyObjectPlus *self_v
                                                         const EXP_PYATTRIBUTE_DEF *attrdef)
 {
 #  ifdef USE_MATHUTILS
-  return Vector_CreatePyObject_cb(EXP_PROXY_FROM_REF_BORROW(self_v),
-                                  3,
-                                  mathutils_kxgameob_vector_cb_index,
-                                  MATHUTILS_VEC_CB_LINVEL_GLOBAL);
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  return self->GetMathutilsObject(MATHUTILS_VEC_CB_LINVEL_GLOBAL, false, 3);
 #  else
   KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
   return PyObjectFrom(GetLinearVelocity(false));
@@ -3567,10 +3667,8 @@ PyObject *KX_GameObject::pyattr_get_localLinearVelocity(EXP_PyObjectPlus *self_v
                                                         const EXP_PYATTRIBUTE_DEF *attrdef)
 {
 #  ifdef USE_MATHUTILS
-  return Vector_CreatePyObject_cb(EXP_PROXY_FROM_REF_BORROW(self_v),
-                                  3,
-                                  mathutils_kxgameob_vector_cb_index,
-                                  MATHUTILS_VEC_CB_LINVEL_LOCAL);
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  return self->GetMathutilsObject(MATHUTILS_VEC_CB_LINVEL_LOCAL, false, 3);
 #  else
   KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
   return PyObjectFrom(GetLinearVelocity(true));
@@ -3595,10 +3693,8 @@ PyObject *KX_GameObject::pyattr_get_worldAngularVelocity(EXP_PyObjectPlus *self_
                                                          const EXP_PYATTRIBUTE_DEF *attrdef)
 {
 #  ifdef USE_MATHUTILS
-  return Vector_CreatePyObject_cb(EXP_PROXY_FROM_REF_BORROW(self_v),
-                                  3,
-                                  mathutils_kxgameob_vector_cb_index,
-                                  MATHUTILS_VEC_CB_ANGVEL_GLOBAL);
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  return self->GetMathutilsObject(MATHUTILS_VEC_CB_ANGVEL_GLOBAL, false, 3);
 #  else
   KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
   return PyObjectFrom(GetAngularVelocity(false));
@@ -3623,10 +3719,8 @@ PyObject *KX_GameObject::pyattr_get_localAngularVelocity(EXP_PyObjectPlus *self_
                                                          const EXP_PYATTRIBUTE_DEF *attrdef)
 {
 #  ifdef USE_MATHUTILS
-  return Vector_CreatePyObject_cb(EXP_PROXY_FROM_REF_BORROW(self_v),
-                                  3,
-                                  mathutils_kxgameob_vector_cb_index,
-                                  MATHUTILS_VEC_CB_ANGVEL_LOCAL);
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  return self->GetMathutilsObject(MATHUTILS_VEC_CB_ANGVEL_LOCAL, false, 3);
 #  else
   KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
   return PyObjectFrom(GetAngularVelocity(true));
@@ -3651,10 +3745,8 @@ PyObject *KX_GameObject::pyattr_get_gravity(EXP_PyObjectPlus *self_v,
                                             const EXP_PYATTRIBUTE_DEF *attrdef)
 {
 #  ifdef USE_MATHUTILS
-  return Vector_CreatePyObject_cb(EXP_PROXY_FROM_REF_BORROW(self_v),
-                                  3,
-                                  mathutils_kxgameob_vector_cb_index,
-                                  MATHUTILS_VEC_CB_GRAVITY);
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  return self->GetMathutilsObject(MATHUTILS_VEC_CB_GRAVITY, false, 3);
 #  else
   KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
   return PyObjectFrom(GetGravity());
@@ -3793,10 +3885,8 @@ PyObject *KX_GameObject::pyattr_get_obcolor(EXP_PyObjectPlus *self_v,
                                             const EXP_PYATTRIBUTE_DEF *attrdef)
 {
 #  ifdef USE_MATHUTILS
-  return Vector_CreatePyObject_cb(EXP_PROXY_FROM_REF_BORROW(self_v),
-                                  4,
-                                  mathutils_kxgameob_vector_cb_index,
-                                  MATHUTILS_VEC_CB_OBJECT_COLOR);
+  KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
+  return self->GetMathutilsObject(MATHUTILS_VEC_CB_OBJECT_COLOR, false, 4);
 #  else
   KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
   return PyObjectFrom(self->GetObjectColor());
@@ -111,6 +111,9 @@ class KX_GameObject : public SCA_IObject {
   short m_previousLodLevel;
   /* END OF EEVEE INTEGRATION */
 
+  /// The transform was interpolated during the last render.
+  bool m_interpolatedTransform;
+
   KX_ClientObjectInfo *m_pClient_info;
   std::string m_name;
   int m_layer;
@@ -130,6 +133,11 @@ class KX_GameObject : public SCA_IObject {
 
   // Object activity culling settings converted from blender objects.
   ActivityCullingInfo m_activityCullingInfo;
+  /// Slot in the scene activity culling grid, -1 if the object is not in the grid.
+  int m_activityCullingSlot;
+  /// Slot and depth list in the scene python proxy manager, -1 if the object is not registered.
+  int m_pythonProxySlot;
+  unsigned short m_pythonProxyDepth;
 
   PHY_IPhysicsController *m_pPhysicsController;
   SG_Node *m_pSGNode;
@@ -146,6 +154,15 @@ class KX_GameObject : public SCA_IObject {
   EXP_ListValue<KX_PythonComponent> *m_components;
 #endif
 
+#ifdef USE_MATHUTILS
+  /** Mathutils callback vectors and matrices returned by the python attributes,
+   * reused by the next access when no script references them anymore. Allocated on first use.
+   */
+  PyObject **m_mathutilsObjects;
+
+  void ClearMathutilsObjects();
+#endif
+
   std::vector<bRigidBodyJointConstraint *> m_constraints;
 
  public:
@@ -478,6 +495,11 @@ class KX_GameObject : public SCA_IObject {
   const MT_Vector3 &NodeGetWorldScaling() const;
   const MT_Vector3 &NodeGetWorldPosition() const;
   MT_Transform NodeGetWorldTransform() const;
+  /** World transform used for rendering, interpolated between the two last logic
+   * and physics steps when the frame interpolation is enabled.
+   * \param interpolated Set to true if the transform was interpolated.
+   */
+  MT_Transform NodeGetRenderTransform(bool &interpolated) const;
 
   const MT_Matrix3x3 &NodeGetLocalOrientation() const;
   const MT_Vector3 &NodeGetLocalScaling() const;
@@ -729,6 +751,31 @@ class KX_GameObject : public SCA_IObject {
   void SetActivityCullingInfo(const ActivityCullingInfo &cullingInfo);
   /// Enable or disable a category of object activity culling.
   void SetActivityCulling(ActivityCullingInfo::Flag flag, bool enable);
+  /// Notify the scene activity culling grid that the culling settings changed.
+  void UpdateActivityCullingGrid();
+
+  int GetActivityCullingSlot() const
+  {
+    return m_activityCullingSlot;
+  }
+  void SetActivityCullingSlot(int slot)
+  {
+    m_activityCullingSlot = slot;
+  }
+
+  int GetPythonProxySlot() const
+  {
+    return m_pythonProxySlot;
+  }
+  unsigned short GetPythonProxyDepth() const
+  {
+    return m_pythonProxyDepth;
+  }
+  void SetPythonProxySlot(int slot, unsigned short depth)
+  {
+    m_pythonProxySlot = slot;
+    m_pythonProxyDepth = depth;
+  }
 
   /**
    * \section Logic bubbling methods.
@@ -783,6 +830,14 @@ class KX_GameObject : public SCA_IObject {
 
   static PyObject *game_object_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
 
+#  ifdef USE_MATHUTILS
+  /** Get the mathutils callback vector or matrix of an attribute.
+   * \param subtype The vector or matrix callback subtype.
+   * \param size The vector size, or the matrix column and row count.
+   */
+  PyObject *GetMathutilsObject(int subtype, bool matrix, int size);
+#  endif
+
   EXP_PYMETHOD_O(KX_GameObject, SetWorldPosition);
   EXP_PYMETHOD_VARARGS(KX_GameObject, ApplyForce);
   EXP_PYMETHOD_VARARGS(KX_GameObject, ApplyTorque);
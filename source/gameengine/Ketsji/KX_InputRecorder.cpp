@@ -0,0 +1,560 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_InputRecorder.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_InputRecorder.h"
+
+#include <cctype>
+#include <cstring>
+
+#include "BLI_fileops.h"
+#include "BLI_path_utils.hh"
+#include "MEM_guardedalloc.h"
+
+#include "CM_Message.h"
+#include "SCA_IInputDevice.h"
+
+/// Header of a record file, followed by the frames.
+struct InputRecordHeader {
+  char m_magic[4];
+  uint32_t m_version;
+};
+
+static const char recordMagic[4] = {'B', 'G', 'E', 'I'};
+static const uint32_t recordVersion = 1;
+/// Size of the serialized frames from which they are appended to the recorded file.
+static const size_t recordFlushSize = 1 << 20;
+
+template <class Type> static void WriteValue(std::vector<char> &data, const Type &value)
+{
+  const char *bytes = (const char *)&value;
+  data.insert(data.end(), bytes, bytes + sizeof(Type));
+}
+
+template <class Type, class Item>
+static void WriteArray(std::vector<char> &data, const std::vector<Item> &array)
+{
+  WriteValue(data, (uint16_t)array.size());
+  for (const Item &item : array) {
+    WriteValue(data, (Type)item);
+  }
+}
+
+template <class Type>
+static bool ReadValue(const std::vector<char> &data, size_t &pos, Type &value)
+{
+  if (pos + sizeof(Type) > data.size()) {
+    return false;
+  }
+  memcpy(&value, data.data() + pos, sizeof(Type));
+  pos += sizeof(Type);
+  return true;
+}
+
+template <class Type, class Item>
+static bool ReadArray(const std::vector<char> &data, size_t &pos, std::vector<Item> &array)
+{
+  uint16_t size;
+  if (!ReadValue(data, pos, size)) {
+    return false;
+  }
+  array.resize(size);
+  for (Item &item : array) {
+    Type value;
+    if (!ReadValue(data, pos, value)) {
+      return false;
+    }
+    item = (Item)value;
+  }
+  return true;
+}
+
+/// Return true if the event didn't change since the last clear of the inputs.
+static bool IsIdleEvent(const SCA_InputEvent &event)
+{
+  return (event.m_queue.empty() && event.m_status.size() <= 1 && event.m_values.size() <= 1);
+}
+
+/// Return true for the window events which are always taken from the real window.
+static bool IsWindowEvent(int code)
+{
+  return (code == SCA_IInputDevice::WINRESIZE || code == SCA_IInputDevice::WINCLOSE ||
+          code == SCA_IInputDevice::WINQUIT);
+}
+
+KX_InputRecorder::KX_InputRecorder(Mode mode, const std::string &filePath)
+    : m_mode(mode),
+      m_filePath(filePath),
+      m_file(nullptr),
+      m_readPos(0),
+      m_recordingFrame(false),
+      m_joystickFrame(0)
+{
+}
+
+KX_InputRecorder::~KX_InputRecorder()
+{
+  if (m_file) {
+    fclose(m_file);
+  }
+}
+
+KX_InputRecorder::Mode KX_InputRecorder::GetMode() const
+{
+  return m_mode;
+}
+
+bool KX_InputRecorder::Read()
+{
+  size_t size;
+  char *data = (char *)BLI_file_read_binary_as_mem(m_filePath.c_str(), 0, &size);
+  if (!data) {
+    CM_Error("could not read input record file \"" << m_filePath << "\"");
+    return false;
+  }
+
+  m_data.assign(data, data + size);
+  MEM_freeN(data);
+
+  InputRecordHeader header;
+  m_readPos = 0;
+  if (!ReadValue(m_data, m_readPos, header) ||
+      memcmp(header.m_magic, recordMagic, sizeof(recordMagic)) != 0 ||
+      header.m_version != recordVersion)
+  {
+    CM_Error("invalid input record file \"" << m_filePath << "\"");
+    m_data.clear();
+    return false;
+  }
+
+  return true;
+}
+
+bool KX_InputRecorder::Create()
+{
+  m_file = BLI_fopen(m_filePath.c_str(), "wb");
+  if (!m_file) {
+    CM_Error("could not create input record file \"" << m_filePath << "\"");
+    return false;
+  }
+
+  InputRecordHeader header;
+  memcpy(header.m_magic, recordMagic, sizeof(recordMagic));
+  header.m_version = recordVersion;
+  WriteValue(m_data, header);
+
+  return Flush();
+}
+
+bool KX_InputRecorder::Flush()
+{
+  if (!m_file) {
+    // The frames are dropped after a write error.
+    m_data.clear();
+    return false;
+  }
+
+  const bool success = (m_data.empty() ||
+                        fwrite(m_data.data(), m_data.size(), 1, m_file) == 1);
+  m_data.clear();
+
+  if (!success) {
+    CM_Error("could not write input record file \"" << m_filePath << "\"");
+    fclose(m_file);
+    m_file = nullptr;
+  }
+
+  return success;
+}
+
+bool KX_InputRecorder::Write()
+{
+  bool success = true;
+
+  if (m_mode == RECORD) {
+    SerializeFrame();
+
+    if (!Flush()) {
+      success = false;
+    }
+    else {
+      if (fclose(m_file) != 0) {
+        CM_Error("could not write input record file \"" << m_filePath << "\"");
+        success = false;
+      }
+      m_file = nullptr;
+    }
+  }
+
+  if (!m_timingsPath.empty() && !WriteTimings()) {
+    CM_Error("could not write timings file \"" << m_timingsPath << "\"");
+    success = false;
+  }
+
+  return success;
+}
+
+void KX_InputRecorder::SerializeFrame()
+{
+  if (!m_recordingFrame) {
+    return;
+  }
+
+  const FrameClock &clock = m_frame.m_clock;
+  WriteValue(m_data, clock.m_clockTime);
+  WriteValue(m_data, (int32_t)clock.m_frames);
+  WriteValue(m_data, clock.m_timestep);
+  WriteValue(m_data, clock.m_framestep);
+  WriteValue(m_data, clock.m_interpolation);
+
+  WriteValue(m_data, (uint16_t)m_frame.m_inputs.size());
+  for (const Input &input : m_frame.m_inputs) {
+    WriteValue(m_data, (uint16_t)input.m_code);
+    WriteValue(m_data, (uint32_t)input.m_unicode);
+    WriteArray<uint8_t>(m_data, input.m_status);
+    WriteArray<uint8_t>(m_data, input.m_queue);
+    WriteArray<int32_t>(m_data, input.m_values);
+  }
+
+  WriteValue(m_data, (uint16_t)m_frame.m_text.size());
+  for (const wchar_t c : m_frame.m_text) {
+    WriteValue(m_data, (uint32_t)c);
+  }
+
+  WriteValue(m_data, (uint16_t)m_frame.m_joysticks.size());
+  for (const JoystickStates &states : m_frame.m_joysticks) {
+    WriteValue(m_data, (uint8_t)states.size());
+    for (const std::pair<unsigned char, DEV_Joystick::State> &pair : states) {
+      const DEV_Joystick::State &state = pair.second;
+      WriteValue(m_data, (uint8_t)pair.first);
+      for (int i = 0; i < JOYAXIS_MAX; ++i) {
+        // SDL axis values are 16 bits.
+        WriteValue(m_data, (int16_t)state.m_axis[i]);
+      }
+      WriteValue(m_data, (uint32_t)state.m_buttons);
+      WriteValue(m_data, (uint8_t)(state.m_trigAxis | (state.m_trigButton << 1)));
+    }
+  }
+
+  m_recordingFrame = false;
+}
+
+bool KX_InputRecorder::DeserializeFrame()
+{
+  if (m_readPos >= m_data.size()) {
+    return false;
+  }
+
+  FrameClock &clock = m_frame.m_clock;
+  int32_t frames;
+  uint16_t numInputs;
+  if (!ReadValue(m_data, m_readPos, clock.m_clockTime) || !ReadValue(m_data, m_readPos, frames) ||
+      !ReadValue(m_data, m_readPos, clock.m_timestep) ||
+      !ReadValue(m_data, m_readPos, clock.m_framestep) ||
+      !ReadValue(m_data, m_readPos, clock.m_interpolation) ||
+      !ReadValue(m_data, m_readPos, numInputs))
+  {
+    return false;
+  }
+  clock.m_frames = frames;
+
+  m_frame.m_inputs.resize(numInputs);
+  for (Input &input : m_frame.m_inputs) {
+    uint16_t code;
+    uint32_t unicode;
+    if (!ReadValue(m_data, m_readPos, code) || !ReadValue(m_data, m_readPos, unicode) ||
+        !ReadArray<uint8_t>(m_data, m_readPos, input.m_status) ||
+        !ReadArray<uint8_t>(m_data, m_readPos, input.m_queue) ||
+        !ReadArray<int32_t>(m_data, m_readPos, input.m_values) ||
+        code >= SCA_IInputDevice::MAX_KEYS)
+    {
+      return false;
+    }
+    input.m_code = code;
+    input.m_unicode = unicode;
+  }
+
+  uint16_t textSize;
+  if (!ReadValue(m_data, m_readPos, textSize)) {
+    return false;
+  }
+  m_frame.m_text.resize(textSize);
+  for (wchar_t &c : m_frame.m_text) {
+    uint32_t value;
+    if (!ReadValue(m_data, m_readPos, value)) {
+      return false;
+    }
+    c = (wchar_t)value;
+  }
+
+  uint16_t numLogicFrames;
+  if (!ReadValue(m_data, m_readPos, numLogicFrames)) {
+    return false;
+  }
+  m_frame.m_joysticks.resize(numLogicFrames);
+  for (JoystickStates &states : m_frame.m_joysticks) {
+    uint8_t numJoysticks;
+    if (!ReadValue(m_data, m_readPos, numJoysticks)) {
+      return false;
+    }
+    states.resize(numJoysticks);
+    for (std::pair<unsigned char, DEV_Joystick::State> &pair : states) {
+      DEV_Joystick::State &state = pair.second;
+      uint8_t index;
+      uint8_t triggers;
+      if (!ReadValue(m_data, m_readPos, index) || index >= JOYINDEX_MAX) {
+        return false;
+      }
+      for (int i = 0; i < JOYAXIS_MAX; ++i) {
+        int16_t axis;
+        if (!ReadValue(m_data, m_readPos, axis)) {
+          return false;
+        }
+        state.m_axis[i] = axis;
+      }
+      if (!ReadValue(m_data, m_readPos, state.m_buttons) ||
+          !ReadValue(m_data, m_readPos, triggers))
+      {
+        return false;
+      }
+      pair.first = index;
+      state.m_trigAxis = (triggers & 1);
+      state.m_trigButton = (triggers & 2);
+    }
+  }
+
+  m_joystickFrame = 0;
+
+  return true;
+}
+
+bool KX_InputRecorder::BeginFrame(FrameClock &clock)
+{
+  if (m_mode == RECORD) {
+    SerializeFrame();
+    if (m_data.size() >= recordFlushSize) {
+      Flush();
+    }
+
+    m_frame.m_clock = clock;
+    m_frame.m_inputs.clear();
+    m_frame.m_text.clear();
+    m_frame.m_joysticks.clear();
+    m_recordingFrame = true;
+  }
+  else if (m_mode == REPLAY) {
+    if (!DeserializeFrame()) {
+      if (m_readPos < m_data.size()) {
+        CM_Error("truncated input record file \"" << m_filePath << "\"");
+      }
+      // Don't replay the remaining of a corrupted file.
+      m_readPos = m_data.size();
+      return false;
+    }
+
+    clock = m_frame.m_clock;
+  }
+
+  return true;
+}
+
+void KX_InputRecorder::ProcessInputs(SCA_IInputDevice *inputDevice)
+{
+  if (m_mode == RECORD) {
+    for (unsigned short code = 0; code < SCA_IInputDevice::MAX_KEYS; ++code) {
+      if (IsWindowEvent(code)) {
+        continue;
+      }
+
+      const SCA_InputEvent &event = inputDevice->GetInput(
+          (SCA_IInputDevice::SCA_EnumInputs)code);
+      if (!IsIdleEvent(event)) {
+        m_frame.m_inputs.push_back(
+            {code, event.m_unicode, event.m_status, event.m_queue, event.m_values});
+      }
+    }
+
+    m_frame.m_text = inputDevice->GetText();
+  }
+  else if (m_mode == REPLAY) {
+    // The recorded inputs are sorted by code.
+    std::vector<Input>::const_iterator it = m_frame.m_inputs.begin();
+    for (unsigned short code = 0; code < SCA_IInputDevice::MAX_KEYS; ++code) {
+      if (IsWindowEvent(code)) {
+        continue;
+      }
+
+      SCA_InputEvent &event = inputDevice->GetInput((SCA_IInputDevice::SCA_EnumInputs)code);
+      if (it != m_frame.m_inputs.end() && it->m_code == code) {
+        event.m_unicode = it->m_unicode;
+        event.m_status = it->m_status;
+        event.m_queue = it->m_queue;
+        event.m_values = it->m_values;
+        ++it;
+      }
+      else if (!IsIdleEvent(event)) {
+        /* Discard the real events, the first status and value are the ones of the previous
+         * frame which are the same as when recording. */
+        event.m_status.resize(1);
+        event.m_values.resize(1);
+        event.m_queue.clear();
+      }
+    }
+
+    inputDevice->SetText(m_frame.m_text);
+  }
+}
+
+void KX_InputRecorder::RecordJoysticks()
+{
+  if (m_mode != RECORD) {
+    return;
+  }
+
+  JoystickStates states;
+  for (unsigned char i = 0; i < JOYINDEX_MAX; ++i) {
+    DEV_Joystick *joystick = DEV_Joystick::GetInstance(i);
+    if (joystick) {
+      DEV_Joystick::State state;
+      joystick->GetState(state);
+      states.emplace_back(i, state);
+    }
+  }
+
+  m_frame.m_joysticks.push_back(states);
+}
+
+bool KX_InputRecorder::ReplayJoysticks(short (&addrem)[JOYINDEX_MAX])
+{
+  if (m_mode != REPLAY || m_joystickFrame >= m_frame.m_joysticks.size()) {
+    return false;
+  }
+
+  const DEV_Joystick::State *states[JOYINDEX_MAX] = {nullptr};
+  for (const std::pair<unsigned char, DEV_Joystick::State> &pair :
+       m_frame.m_joysticks[m_joystickFrame++])
+  {
+    states[pair.first] = &pair.second;
+  }
+
+  return DEV_Joystick::SetReplayStates(states, addrem);
+}
+
+void KX_InputRecorder::SetTimingsFile(const std::string &filePath)
+{
+  m_timingsPath = filePath;
+}
+
+void KX_InputRecorder::SetTimingLabels(const std::vector<std::string> &labels)
+{
+  m_timingLabels.clear();
+
+  // Use identifiers usable as CSV header and JSON keys, e.g. "GPU Latency:" -> "gpu_latency".
+  for (const std::string &label : labels) {
+    std::string name;
+    for (const char c : label) {
+      if (c == ' ') {
+        name += '_';
+      }
+      else if (c != ':') {
+        name += tolower(c);
+      }
+    }
+    m_timingLabels.push_back(name);
+  }
+}
+
+bool KX_InputRecorder::HasTimings() const
+{
+  return !m_timingsPath.empty();
+}
+
+void KX_InputRecorder::AddTimings(double clockTime, const std::vector<double> &times)
+{
+  double total = 0.0;
+  for (const double time : times) {
+    total += time;
+  }
+
+  m_timings.push_back(clockTime);
+  m_timings.push_back(total);
+  m_timings.insert(m_timings.end(), times.begin(), times.end());
+}
+
+bool KX_InputRecorder::WriteTimings() const
+{
+  FILE *file = BLI_fopen(m_timingsPath.c_str(), "w");
+  if (!file) {
+    return false;
+  }
+
+  const bool json = BLI_path_extension_check(m_timingsPath.c_str(), ".json");
+  // Clock time and total time followed by the categories.
+  const unsigned int rowSize = m_timingLabels.size() + 2;
+  const unsigned int numRows = m_timings.size() / rowSize;
+
+  // The times are written in milliseconds except the clock time.
+  if (json) {
+    fprintf(file, "{\n  \"categories\": [");
+    for (unsigned int i = 0; i < m_timingLabels.size(); ++i) {
+      fprintf(file, "%s\"%s\"", (i == 0) ? "" : ", ", m_timingLabels[i].c_str());
+    }
+    fprintf(file, "],\n  \"frames\": [");
+    for (unsigned int row = 0; row < numRows; ++row) {
+      const double *times = &m_timings[row * rowSize];
+      fprintf(file,
+              "%s\n    {\"frame\": %u, \"clock\": %.6f, \"total\": %.4f",
+              (row == 0) ? "" : ",",
+              row,
+              times[0],
+              times[1] * 1000.0);
+      for (unsigned int i = 0; i < m_timingLabels.size(); ++i) {
+        fprintf(file, ", \"%s\": %.4f", m_timingLabels[i].c_str(), times[i + 2] * 1000.0);
+      }
+      fprintf(file, "}");
+    }
+    fprintf(file, "\n  ]\n}\n");
+  }
+  else {
+    fprintf(file, "frame,clock,total");
+    for (const std::string &label : m_timingLabels) {
+      fprintf(file, ",%s", label.c_str());
+    }
+    fprintf(file, "\n");
+    for (unsigned int row = 0; row < numRows; ++row) {
+      const double *times = &m_timings[row * rowSize];
+      fprintf(file, "%u,%.6f,%.4f", row, times[0], times[1] * 1000.0);
+      for (unsigned int i = 0; i < m_timingLabels.size(); ++i) {
+        fprintf(file, ",%.4f", times[i + 2] * 1000.0);
+      }
+      fprintf(file, "\n");
+    }
+  }
+
+  const bool success = (ferror(file) == 0);
+  fclose(file);
+
+  return success;
+}
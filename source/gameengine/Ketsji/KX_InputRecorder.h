@@ -0,0 +1,157 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_InputRecorder.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "DEV_Joystick.h"
+#include "SCA_InputEvent.h"
+
+class SCA_IInputDevice;
+
+/** Record and replay of the inputs and of the frame clock of the engine, and writer of the
+ * time spent in each profiling category per frame.
+ *
+ * When recording, the events of the input device, the joystick states and the frame times
+ * computed by the engine are stored for every frame and appended to a binary file by
+ * chunks, so that a long session doesn't keep all its frames in memory.
+ * When replaying, the engine uses the recorded frame times and inputs instead of the real
+ * ones, so a game session runs the same logic frames with the same inputs independently
+ * of the speed of the machine, which makes the timings of several runs comparable.
+ *
+ * The file is in native endianness, it is only meant to be replayed on the same kind of
+ * machine with the same version of the engine.
+ */
+class KX_InputRecorder {
+ public:
+  enum Mode {
+    /// Only write the timings.
+    NONE = 0,
+    RECORD,
+    REPLAY
+  };
+
+  /// Frame times of the engine, see KX_KetsjiEngine::FrameTimes.
+  struct FrameClock {
+    double m_clockTime;
+    int m_frames;
+    double m_timestep;
+    double m_framestep;
+    double m_interpolation;
+  };
+
+ private:
+  /// Non idle input event of a frame.
+  struct Input {
+    unsigned short m_code;
+    unsigned int m_unicode;
+    std::vector<SCA_InputEvent::SCA_EnumInputs> m_status;
+    std::vector<SCA_InputEvent::SCA_EnumInputs> m_queue;
+    std::vector<int> m_values;
+  };
+
+  /// Joysticks connected during a logic frame and their states.
+  using JoystickStates = std::vector<std::pair<unsigned char, DEV_Joystick::State>>;
+
+  struct Frame {
+    FrameClock m_clock;
+    std::vector<Input> m_inputs;
+    std::wstring m_text;
+    /// Joystick states of each logic frame.
+    std::vector<JoystickStates> m_joysticks;
+  };
+
+  Mode m_mode;
+  std::string m_filePath;
+  /// File being recorded, nullptr if not recording or after a write error.
+  FILE *m_file;
+
+  /// Serialized frames, only the frames not yet written to the file when recording.
+  std::vector<char> m_data;
+  /// Read position in m_data when replaying.
+  size_t m_readPos;
+  /// Frame being recorded or replayed.
+  Frame m_frame;
+  /// True when m_frame holds a frame to be serialized.
+  bool m_recordingFrame;
+  /// Index of the next logic frame of m_frame.m_joysticks to replay.
+  unsigned int m_joystickFrame;
+
+  std::string m_timingsPath;
+  std::vector<std::string> m_timingLabels;
+  /// Clock time, total time and time of each category for every frame.
+  std::vector<double> m_timings;
+
+  /// Serialize the frame being recorded into m_data.
+  void SerializeFrame();
+  /// Read the next frame from m_data, return false at the end of the data.
+  bool DeserializeFrame();
+  /// Append the serialized frames to the recorded file, return false on failure.
+  bool Flush();
+
+  bool WriteTimings() const;
+
+ public:
+  KX_InputRecorder(Mode mode, const std::string &filePath);
+  ~KX_InputRecorder();
+
+  Mode GetMode() const;
+
+  /// Read the file to replay, return false if the file is invalid.
+  bool Read();
+  /// Create the file to record, return false if it can't be written.
+  bool Create();
+  /// Write the remaining recorded frames and the timings, return false on failure.
+  bool Write();
+
+  /** Start a new frame, store the clock when recording or replace it by the recorded
+   * clock when replaying. Return false when all the recorded frames were replayed.
+   */
+  bool BeginFrame(FrameClock &clock);
+  /// Store the inputs of the frame or replace them by the recorded inputs.
+  void ProcessInputs(SCA_IInputDevice *inputDevice);
+
+  /// Store the joystick states of a logic frame.
+  void RecordJoysticks();
+  /** Replace the joysticks by the recorded ones for a logic frame, return true if joysticks
+   * were added or removed, see DEV_Joystick::HandleEvents.
+   */
+  bool ReplayJoysticks(short (&addrem)[JOYINDEX_MAX]);
+
+  /** Write the timings of each frame at exit to a file, as JSON if its extension is .json,
+   * as CSV otherwise.
+   */
+  void SetTimingsFile(const std::string &filePath);
+  /// Set the profiling category names, called by the engine.
+  void SetTimingLabels(const std::vector<std::string> &labels);
+  bool HasTimings() const;
+  /// Add the timings in seconds of a frame, one per category.
+  void AddTimings(double clockTime, const std::vector<double> &times);
+};
@@ -39,6 +39,7 @@
 #include <boost/format.hpp>
 
 #include "BLI_rect.h"
+#include "BLI_task.h"
 #include "../draw/intern/draw_command.hh"
 #include "DRW_render.hh"
 #include "GPU_context.hh"
@@ -51,6 +52,7 @@
 #include "DEV_Joystick.h"  // for DEV_Joystick::HandleEvents
 #include "KX_Camera.h"
 #include "KX_Globals.h"
+#include "KX_InputRecorder.h"
 #include "KX_NetworkMessageScene.h"
 #include "KX_PyConstraintBinding.h"
 #include "KX_PythonInit.h"  // for updatePythonJoysticks
@@ -133,6 +135,7 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system,
       m_kxsystem(system),
       m_converter(nullptr),
       m_inputDevice(nullptr),
+      m_inputRecorder(nullptr),
       m_bInitialized(false),
       m_flags(AUTO_ADD_DEBUG_PROPERTIES),
       m_frameTime(0.0f),
@@ -147,6 +150,8 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system,
       m_ticrate(DEFAULT_LOGIC_TIC_RATE),
       m_anim_framerate(25.0),
       m_doRender(true),
+      m_framePipeline(KX_FramePipeline::NONE),
+      m_physicsTaskPool(nullptr),
       m_exitkey(130),
       m_exitcode(KX_ExitRequest::NO_REQUEST),
       m_exitstring(""),
@@ -176,6 +181,11 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system,
  */
 KX_KetsjiEngine::~KX_KetsjiEngine()
 {
+  FinishPhysicsStep();
+  if (m_physicsTaskPool) {
+    BLI_task_pool_free(m_physicsTaskPool);
+  }
+
 #ifdef WITH_PYTHON
   Py_CLEAR(m_pyprofiledict);
 #endif
@@ -225,6 +235,15 @@ void KX_KetsjiEngine::SetInputDevice(SCA_IInputDevice *inputDevice)
   m_inputDevice = inputDevice;
 }
 
+void KX_KetsjiEngine::SetInputRecorder(KX_InputRecorder *recorder)
+{
+  m_inputRecorder = recorder;
+  if (m_inputRecorder) {
+    m_inputRecorder->SetTimingLabels(
+        std::vector<std::string>(m_profileLabels, m_profileLabels + tc_numCategories));
+  }
+}
+
 void KX_KetsjiEngine::SetCanvas(RAS_ICanvas *canvas)
 {
   BLI_assert(canvas);
@@ -302,6 +321,10 @@ void KX_KetsjiEngine::EndFrame()
   // Go to next profiling measurement, time spent after this call is shown in the next frame.
   m_logger.NextMeasurement();
 
+  if (m_inputRecorder && m_inputRecorder->HasTimings()) {
+    LogFrameTimings();
+  }
+
   m_logger.StartLog(tc_rasterizer);
   m_rasterizer->EndFrame();
 
@@ -347,6 +370,10 @@ void KX_KetsjiEngine::EndFrameViewportRender()
   // Go to next profiling measurement, time spent after this call is shown in the next frame.
   m_logger.NextMeasurement();
 
+  if (m_inputRecorder && m_inputRecorder->HasTimings()) {
+    LogFrameTimings();
+  }
+
   m_logger.StartLog(tc_rasterizer);
   // m_rasterizer->EndFrame();
 
@@ -415,7 +442,7 @@ KX_KetsjiEngine::FrameTimes KX_KetsjiEngine::GetFrameTimes()
 
   // Time of a frame (without scale).
   double timestep;
-  if (m_flags & FIXED_FRAMERATE) {
+  if (m_flags & (FIXED_FRAMERATE | INTERPOLATE_FRAMES)) {
     // Normal time step for fixed frame.
     timestep = 1.0 / m_ticrate;
   }
@@ -426,7 +453,7 @@ KX_KetsjiEngine::FrameTimes KX_KetsjiEngine::GetFrameTimes()
 
   // Number of frames to proceed.
   int frames;
-  if (m_flags & FIXED_FRAMERATE) {
+  if (m_flags & (FIXED_FRAMERATE | INTERPOLATE_FRAMES)) {
     // As many as possible for the elapsed time.
     frames = int(dt * m_ticrate);
   }
@@ -435,16 +462,31 @@ KX_KetsjiEngine::FrameTimes KX_KetsjiEngine::GetFrameTimes()
     frames = 1;
   }
 
+  double interpolation = 1.0;
+
   // Fix timestep to not exceed max physics and logic frames.
   int maxFrames = max_ii(m_maxLogicFrame, m_maxPhysicsFrame);
-  if (frames > maxFrames) {
-    timestep = dt / maxFrames;
-    frames = maxFrames;
+  if (m_flags & INTERPOLATE_FRAMES) {
+    /* The time step is kept constant and the remaining time is accumulated for the next
+     * frames, it is used to blend the transforms between the two last steps. */
+    double remainingTime = dt - frames * timestep;
+    if (frames > maxFrames) {
+      frames = maxFrames;
+      remainingTime = 0.0;
+    }
+    m_previousRealTime = m_clockTime - remainingTime;
+    interpolation = min_dd(remainingTime / timestep, 1.0);
   }
+  else {
+    if (frames > maxFrames) {
+      timestep = dt / maxFrames;
+      frames = maxFrames;
+    }
 
-  // If the number of frame is non-zero, update previous time.
-  if (frames > 0) {
-    m_previousRealTime = m_clockTime;
+    // If the number of frame is non-zero, update previous time.
+    if (frames > 0) {
+      m_previousRealTime = m_clockTime;
+    }
   }
   //// Else in case of fixed framerate, try to sleep until the next frame.
   // else if (m_flags & FIXED_FRAMERATE) {
@@ -464,22 +506,69 @@ KX_KetsjiEngine::FrameTimes KX_KetsjiEngine::GetFrameTimes()
   times.frames = frames;
   times.timestep = timestep;
   times.framestep = framestep;
+  times.interpolation = interpolation;
 
   return times;
 }
 
+bool KX_KetsjiEngine::ProcessInputRecorder(FrameTimes &times)
+{
+  KX_InputRecorder::FrameClock clock = {
+      m_clockTime, times.frames, times.timestep, times.framestep, times.interpolation};
+  if (!m_inputRecorder->BeginFrame(clock)) {
+    return false;
+  }
+
+  if (m_inputRecorder->GetMode() == KX_InputRecorder::REPLAY) {
+    // Use the recorded clock to run the same logic frames whatever the real time is.
+    m_clockTime = clock.m_clockTime;
+    times.frames = clock.m_frames;
+    times.timestep = clock.m_timestep;
+    times.framestep = clock.m_framestep;
+    times.interpolation = clock.m_interpolation;
+  }
+
+  m_inputRecorder->ProcessInputs(m_inputDevice);
+
+  return true;
+}
+
+void KX_KetsjiEngine::LogFrameTimings()
+{
+  std::vector<double> times(tc_numCategories);
+  for (int i = tc_first; i < tc_numCategories; ++i) {
+    times[i] = m_logger.GetLastMeasurement((KX_TimeCategory)i);
+  }
+
+  m_inputRecorder->AddTimings(m_clockTime, times);
+}
+
 bool KX_KetsjiEngine::NextFrame()
 {
+  // The logic must see the results of the previous physics steps.
+  FinishPhysicsStep();
+
   m_logger.StartLog(tc_services);
 
-  const FrameTimes times = GetFrameTimes();
+  FrameTimes times = GetFrameTimes();
+
+  if (m_inputRecorder && !ProcessInputRecorder(times)) {
+    // All the recorded frames were replayed.
+    RequestExit(KX_ExitRequest::QUIT_GAME);
+    m_logger.StartLog(tc_outside);
+    return false;
+  }
 
-  // Exit if zero frame is sheduled.
+  for (KX_Scene *scene : m_scenes) {
+    scene->SetInterpolationFactor(times.interpolation);
+  }
+
+  // Exit if zero frame is sheduled, interpolated frames are always rendered.
   if (times.frames == 0) {
     // Start logging time spent outside main loop
     m_logger.StartLog(tc_outside);
 
-    return false;
+    return (m_flags & INTERPOLATE_FRAMES) ? m_doRender : false;
   }
 
   for (unsigned short i = 0; i < times.frames; ++i) {
@@ -492,7 +581,18 @@ bool KX_KetsjiEngine::NextFrame()
 #ifdef WITH_SDL
     // Handle all SDL Joystick events here to share them for all scenes properly.
     short addrem[JOYINDEX_MAX] = {0};
-    if (DEV_Joystick::HandleEvents(addrem)) {
+    bool remap;
+    if (m_inputRecorder && m_inputRecorder->GetMode() == KX_InputRecorder::REPLAY) {
+      remap = m_inputRecorder->ReplayJoysticks(addrem);
+    }
+    else {
+      remap = DEV_Joystick::HandleEvents(addrem);
+      if (m_inputRecorder) {
+        m_inputRecorder->RecordJoysticks();
+      }
+    }
+
+    if (remap) {
 #  ifdef WITH_PYTHON
       updatePythonJoysticks(addrem);
 #  endif  // WITH_PYTHON
@@ -519,6 +619,11 @@ bool KX_KetsjiEngine::NextFrame()
         scene->UpdateObjectActivity();
       }
 
+      if (m_flags & INTERPOLATE_FRAMES) {
+        m_logger.StartLog(tc_scenegraph);
+        scene->SaveTickTransforms();
+      }
+
       m_logger.StartLog(tc_physics);
 
       // set Python hooks for each scene
@@ -545,6 +650,12 @@ bool KX_KetsjiEngine::NextFrame()
       m_logger.StartLog(tc_scenegraph);
       scene->UpdateParents(m_frameTime);
 
+      // The last physics step of the frame is started after the logic of all the scenes.
+      if (m_framePipeline != KX_FramePipeline::NONE && i == times.frames - 1) {
+        m_logger.StartLog(tc_services);
+        continue;
+      }
+
       m_logger.StartLog(tc_physics);
 
       // Perform physics calculations on the scene. This can involve
@@ -563,6 +674,10 @@ bool KX_KetsjiEngine::NextFrame()
       m_logger.StartLog(tc_services);
     }
 
+    if (m_framePipeline != KX_FramePipeline::NONE && i == times.frames - 1) {
+      BeginPhysicsSteps(times);
+    }
+
     m_logger.StartLog(tc_network);
     m_networkMessageManager->ClearMessages();
 
@@ -570,6 +685,9 @@ bool KX_KetsjiEngine::NextFrame()
     m_logger.StartLog(tc_logic);
     m_inputDevice->ClearInputs();
 
+    // virtualize the sounds once the logic updated their gain
+    m_soundVoiceManager.Update(GetRealTime());
+
     // scene management
     ProcessScheduledScenes();
   }
@@ -580,6 +698,78 @@ bool KX_KetsjiEngine::NextFrame()
   return m_doRender;
 }
 
+static void physics_step_task(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  /* The scenes are stepped one after the other, Bullet uses global variables
+   * set by each physics environment before its step. */
+  std::vector<KX_Scene *> *scenes = static_cast<std::vector<KX_Scene *> *>(taskdata);
+  for (KX_Scene *scene : *scenes) {
+    scene->GetPhysicsEnvironment()->StepDeltaTime();
+  }
+}
+
+void KX_KetsjiEngine::BeginPhysicsSteps(const FrameTimes &times)
+{
+  /* The animations modify the scene graph and the physics of kinematic objects,
+   * they are updated before the steps instead of during the render. */
+  m_logger.StartLog(tc_animations);
+  for (KX_Scene *scene : m_scenes) {
+    UpdateAnimations(scene);
+    // All the scenes are updated at once.
+    if (m_flags & RESTRICT_ANIMATION) {
+      break;
+    }
+  }
+
+  m_logger.StartLog(tc_physics);
+  for (KX_Scene *scene : m_scenes) {
+    scene->GetPhysicsEnvironment()->BeginDeltaTime(m_frameTime, times.timestep, times.framestep);
+    m_steppingScenes.push_back(scene);
+  }
+
+  if (m_framePipeline == KX_FramePipeline::THREADED && !m_steppingScenes.empty()) {
+    if (!m_physicsTaskPool) {
+      m_physicsTaskPool = BLI_task_pool_create(nullptr, TASK_PRIORITY_HIGH);
+    }
+    BLI_task_pool_push(m_physicsTaskPool, physics_step_task, &m_steppingScenes, false, nullptr);
+  }
+
+  m_logger.StartLog(tc_services);
+}
+
+void KX_KetsjiEngine::FinishPhysicsStep()
+{
+  if (m_steppingScenes.empty()) {
+    return;
+  }
+
+  if (m_physicsTaskPool) {
+    BLI_task_pool_work_and_wait(m_physicsTaskPool);
+  }
+
+  for (KX_Scene *scene : m_steppingScenes) {
+    PHY_IPhysicsEnvironment *physEnv = scene->GetPhysicsEnvironment();
+    if (m_framePipeline == KX_FramePipeline::SEQUENTIAL) {
+      physEnv->StepDeltaTime();
+    }
+    physEnv->EndDeltaTime();
+    physEnv->UpdateSoftBodies();
+    scene->UpdateParents(m_frameTime);
+  }
+  m_steppingScenes.clear();
+}
+
+void KX_KetsjiEngine::SetFramePipeline(KX_FramePipeline pipeline)
+{
+  FinishPhysicsStep();
+  m_framePipeline = pipeline;
+}
+
+KX_FramePipeline KX_KetsjiEngine::GetFramePipeline() const
+{
+  return m_framePipeline;
+}
+
 KX_KetsjiEngine::CameraRenderData KX_KetsjiEngine::GetCameraRenderData(
     KX_Scene *scene,
     KX_Camera *camera,
@@ -622,7 +812,7 @@ KX_KetsjiEngine::CameraRenderData KX_KetsjiEngine::GetCameraRenderData(
 
   // Compute the camera matrices: modelview and projection.
   const MT_Matrix4x4 viewmat = m_rasterizer->GetViewMatrix(
-      eye, rendercam->GetWorldToCamera(), rendercam->GetCameraData()->m_perspective);
+      eye, rendercam->GetRenderWorldToCamera(), rendercam->GetCameraData()->m_perspective);
   const MT_Matrix4x4 projmat = GetCameraProjectionMatrix(scene, rendercam, eye, viewport, area);
   rendercam->SetModelviewMatrix(viewmat);
   rendercam->SetProjectionMatrix(projmat);
@@ -1080,8 +1270,11 @@ void KX_KetsjiEngine::RenderCamera(KX_Scene *scene,
 
   m_logger.StartLog(tc_scenegraph);
 
-  m_logger.StartLog(tc_animations);
-  UpdateAnimations(scene);
+  // With a frame pipeline the animations are updated before the physics step.
+  if (m_framePipeline == KX_FramePipeline::NONE) {
+    m_logger.StartLog(tc_animations);
+    UpdateAnimations(scene);
+  }
 
   m_logger.StartLog(tc_rasterizer);
 
@@ -1104,6 +1297,9 @@ void KX_KetsjiEngine::RenderCamera(KX_Scene *scene,
   scene->RenderAfterCameraSetup(rendercam, background_fb, viewport, is_overlay_pass, is_last_render_pass);
 
   if (scene->GetPhysicsEnvironment()) {
+    if (scene->GetPhysicsEnvironment()->GetDebugMode() != 0) {
+      FinishPhysicsStep();
+    }
     scene->GetPhysicsEnvironment()->DebugDrawWorld();
   }
 }
@@ -1143,6 +1339,8 @@ RAS_FrameBuffer *KX_KetsjiEngine::PostRenderScene(KX_Scene *scene,
 
 void KX_KetsjiEngine::StopEngine()
 {
+  FinishPhysicsStep();
+
   if (m_bInitialized) {
     m_converter->FinalizeAsyncLoads();
 
@@ -1347,8 +1545,9 @@ void KX_KetsjiEngine::DrawDebugCameraFrustum(KX_Scene *scene,
   for (KX_Camera *cam : scene->GetCameraList()) {
     if (cam != cameraFrameData.m_renderCamera &&
         (m_showCameraFrustum == KX_DebugOption::FORCE || cam->GetShowCameraFrustum())) {
-      const MT_Matrix4x4 viewmat = m_rasterizer->GetViewMatrix(
-          cameraFrameData.m_eye, cam->GetWorldToCamera(), cam->GetCameraData()->m_perspective);
+      const MT_Matrix4x4 viewmat = m_rasterizer->GetViewMatrix(cameraFrameData.m_eye,
+                                                               cam->GetRenderWorldToCamera(),
+                                                               cam->GetCameraData()->m_perspective);
       const MT_Matrix4x4 projmat = GetCameraProjectionMatrix(
           scene, cam, cameraFrameData.m_eye, cameraFrameData.m_viewport, cameraFrameData.m_area);
       debugDraw.DrawCameraFrustum(projmat * viewmat);
@@ -1600,6 +1799,8 @@ void KX_KetsjiEngine::ProcessScheduledScenes(void)
 {
   // Check whether there will be changes to the list of scenes
   if (m_replace_scenes.size() || m_removingScenes.size()) {
+    // The removed scenes could be simulated.
+    FinishPhysicsStep();
 
     // Change the scene list
     ReplaceScheduledScenes();
@@ -39,13 +39,16 @@
 #include "EXP_Python.h"
 #include "KX_ISystem.h"
 #include "KX_Scene.h"
+#include "KX_SoundVoiceManager.h"
 #include "KX_TimeCategoryLogger.h"
 #include "MT_Matrix4x4.h"
 #include "RAS_CameraData.h"
 #include "RAS_Rasterizer.h"
 
 class KX_ISystem;
+class KX_InputRecorder;
 class BL_Converter;
+struct TaskPool;
 class KX_NetworkMessageManager;
 class RAS_ICanvas;
 class RAS_FrameBuffer;
@@ -64,6 +67,16 @@ enum class KX_ExitRequest {
 
 enum class KX_DebugOption { DISABLE = 0, FORCE, ALLOW };
 
+/// Execution of the physics step of a frame relative to the frame render.
+enum class KX_FramePipeline {
+  /// The physics is stepped during the logic frame.
+  NONE = 0,
+  /// The last physics step of a frame runs in a worker thread while the frame is rendered.
+  THREADED,
+  /// Same stages as THREADED executed in order after the render, used to compare the results.
+  SEQUENTIAL
+};
+
 typedef struct {
   short glslflag;
 } GlobalSettings;
@@ -90,7 +103,10 @@ class KX_KetsjiEngine {
     /// Automatic add debug properties to the debug list.
     AUTO_ADD_DEBUG_PROPERTIES = (1 << 6),
     /// Use override camera?
-    CAMERA_OVERRIDE = (1 << 7)
+    CAMERA_OVERRIDE = (1 << 7),
+    /** Run logic and physics at the fixed tic rate and render every frame the
+     * object transforms interpolated between the two last fixed steps. */
+    INTERPOLATE_FRAMES = (1 << 8)
   };
 
  private:
@@ -140,10 +156,14 @@ class KX_KetsjiEngine {
   KX_ISystem *m_kxsystem;
   BL_Converter *m_converter;
   KX_NetworkMessageManager *m_networkMessageManager;
+  /// Virtualization of the playing sounds.
+  KX_SoundVoiceManager m_soundVoiceManager;
 #ifdef WITH_PYTHON
   PyObject *m_pyprofiledict;
 #endif
   SCA_IInputDevice *m_inputDevice;
+  /// Record or replay of the inputs and frame times, and writer of the timings, optional.
+  KX_InputRecorder *m_inputRecorder;
 
   struct FrameTimes {
     // Number of frames to proceed.
@@ -152,6 +172,8 @@ class KX_KetsjiEngine {
     double timestep;
     // Scaled duration of a frame.
     double framestep;
+    // Blend factor between the two last frames for rendering, 1 when not interpolating.
+    double interpolation;
   };
 
   CM_Clock m_clock;
@@ -194,6 +216,12 @@ class KX_KetsjiEngine {
 
   bool m_doRender; /* whether or not the scene should be rendered after the logic frame */
 
+  KX_FramePipeline m_framePipeline;
+  /// Task pool of the physics steps running during the render, kept between frames.
+  TaskPool *m_physicsTaskPool;
+  /// Scenes of which the physics step was started and not finished.
+  std::vector<KX_Scene *> m_steppingScenes;
+
   /// Key used to exit the BGE
   short m_exitkey;
 
@@ -288,6 +316,17 @@ class KX_KetsjiEngine {
 
   void BeginFrame();
   FrameTimes GetFrameTimes();
+  /** Record the frame times and inputs or replace them by the replayed ones.
+   * Return false when the replay is finished.
+   */
+  bool ProcessInputRecorder(FrameTimes &times);
+  /// Pass the time spent in each category during the last frame to the input recorder.
+  void LogFrameTimings();
+
+  /** Update the animations and start the physics step of all the scenes after their logic,
+   * the steps are finished after the render.
+   */
+  void BeginPhysicsSteps(const FrameTimes &times);
 
  public:
   KX_KetsjiEngine(KX_ISystem *system,
@@ -315,6 +354,8 @@ class KX_KetsjiEngine {
 
   /// set the devices and stuff. the client must take care of creating these
   void SetInputDevice(SCA_IInputDevice *inputDevice);
+  /// Set the optional input recorder, owned by the client.
+  void SetInputRecorder(KX_InputRecorder *recorder);
   void SetCanvas(RAS_ICanvas *canvas);
   void SetRasterizer(RAS_Rasterizer *rasterizer);
   void SetNetworkMessageManager(KX_NetworkMessageManager *manager);
@@ -343,11 +384,22 @@ class KX_KetsjiEngine {
   {
     return m_networkMessageManager;
   }
+  KX_SoundVoiceManager *GetSoundVoiceManager()
+  {
+    return &m_soundVoiceManager;
+  }
 
   /// returns true if an update happened to indicate -> Render
   bool NextFrame();
   void Render();
 
+  void SetFramePipeline(KX_FramePipeline pipeline);
+  KX_FramePipeline GetFramePipeline() const;
+  /** Wait for the physics steps started by the last NextFrame and apply their results to
+   * the scene graph, must be called after the render and before any access to the physics.
+   */
+  void FinishPhysicsStep();
+
   void StartEngine();
   void StopEngine();
 
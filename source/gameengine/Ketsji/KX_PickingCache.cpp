@@ -0,0 +1,195 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_PickingCache.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_PickingCache.h"
+
+#include "KX_Camera.h"
+#include "KX_ClientObjectInfo.h"
+#include "KX_KetsjiEngine.h"
+#include "KX_RayCast.h"
+#include "KX_Scene.h"
+#include "RAS_ICanvas.h"
+
+/// Ray cast callback accepting all the objects except sensors and the camera.
+class KX_PickingRayCast : public KX_RayCast {
+ public:
+  KX_PickingRayCast(PHY_IPhysicsController *ignoreController)
+      : KX_RayCast(ignoreController, false, true)
+  {
+  }
+
+  virtual bool RayHit(KX_ClientObjectInfo *client)
+  {
+    return true;
+  }
+
+  virtual bool needBroadphaseRayCast(PHY_IPhysicsController *controller)
+  {
+    KX_ClientObjectInfo *info = static_cast<KX_ClientObjectInfo *>(controller->GetNewClientInfo());
+    return (info && info->isActor());
+  }
+};
+
+KX_PickingCache::KX_PickingCache()
+{
+}
+
+KX_PickingCache::~KX_PickingCache()
+{
+}
+
+void KX_PickingCache::Invalidate()
+{
+  m_rays.clear();
+}
+
+KX_PickingCache::Ray &KX_PickingCache::GetRay(
+    KX_Scene *scene, KX_KetsjiEngine *engine, KX_Camera *cam, int x, int y)
+{
+  for (Ray &ray : m_rays) {
+    if (ray.m_camera == cam && ray.m_x == x && ray.m_y == y) {
+      return ray;
+    }
+  }
+
+  m_rays.emplace_back();
+  Ray &ray = m_rays.back();
+  ray.m_camera = cam;
+  ray.m_x = x;
+  ray.m_y = y;
+  ComputeRay(ray, scene, engine);
+
+  return ray;
+}
+
+void KX_PickingCache::ComputeRay(Ray &ray, KX_Scene *scene, KX_KetsjiEngine *engine)
+{
+  /* The window coordinates are converted to normalized device coordinates:
+   *
+   * xn = 2(xwin - x_lb)/width - 1.0
+   * yn = 2(ywin - y_lb)/height - 1.0
+   *    = 2(height - y_blender - y_lb)/height - 1.0
+   *    = 1.0 - 2(y_blender - y_lb)/height
+   *
+   * and then to world coordinates with the inverted projection and camera to world matrices.
+   */
+  RAS_Rect area, viewport;
+  RAS_ICanvas *canvas = engine->GetCanvas();
+  int y_inv = canvas->GetHeight() - ray.m_y;
+
+  const RAS_Rect displayArea = engine->GetRasterizer()->GetRenderArea(
+      canvas, RAS_Rasterizer::RAS_STEREO_LEFTEYE);
+  engine->GetSceneViewport(scene, ray.m_camera, displayArea, area, viewport);
+
+  ray.m_hasHit = false;
+
+  /* Check if the mouse is in the viewport */
+  if ((ray.m_x < viewport.GetRight() &&      // less than right
+       ray.m_x > viewport.GetLeft() &&       // more than then left
+       y_inv < viewport.GetTop() &&          // below top
+       y_inv > viewport.GetBottom()) == 0)  // above bottom
+  {
+    ray.m_inViewport = false;
+    ray.m_traced = true;
+    return;
+  }
+
+  float height = float(viewport.GetTop() - viewport.GetBottom() + 1);
+  float width = float(viewport.GetRight() - viewport.GetLeft() + 1);
+
+  float x_lb = float(viewport.GetLeft());
+  float y_lb = float(viewport.GetBottom());
+
+  /* y_inv - inverting for a bounds check is only part of it, now make relative to view bounds */
+  y_inv = (viewport.GetTop() - y_inv) + viewport.GetBottom();
+
+  /*	build the from and to point in normalized device coordinates
+   *	Normalized device coordinates are [-1,1] in x, y, z
+   *
+   *	The actual z coordinates used don't have to be exact just infront and
+   *	behind of the near and far clip planes.
+   */
+  MT_Vector4 frompoint((2 * (ray.m_x - x_lb) / width) - 1.0f,
+                       1.0f - (2 * (y_inv - y_lb) / height),
+                       -1.0f,
+                       1.0f);
+  MT_Vector4 topoint((2 * (ray.m_x - x_lb) / width) - 1.0f,
+                     1.0f - (2 * (y_inv - y_lb) / height),
+                     1.0f,
+                     1.0f);
+
+  /* camera to world  */
+  MT_Matrix4x4 camcs_wcs_matrix = MT_Matrix4x4(ray.m_camera->GetCameraToWorld());
+
+  MT_Matrix4x4 clip_camcs_matrix = MT_Matrix4x4(ray.m_camera->GetProjectionMatrix());
+  clip_camcs_matrix.invert();
+
+  /* shoot-points: clip to cam to wcs . win to clip was already done.*/
+  frompoint = camcs_wcs_matrix * (clip_camcs_matrix * frompoint);
+  topoint = camcs_wcs_matrix * (clip_camcs_matrix * topoint);
+
+  /* from hom wcs to 3d wcs: */
+  ray.m_source.setValue(
+      frompoint[0] / frompoint[3], frompoint[1] / frompoint[3], frompoint[2] / frompoint[3]);
+  ray.m_target.setValue(topoint[0] / topoint[3], topoint[1] / topoint[3], topoint[2] / topoint[3]);
+
+  ray.m_inViewport = true;
+  ray.m_traced = false;
+}
+
+void KX_PickingCache::TraceRay(Ray &ray, KX_Scene *scene)
+{
+  ray.m_traced = true;
+
+  PHY_IPhysicsEnvironment *physEnv = scene->GetPhysicsEnvironment();
+  if (!physEnv) {
+    return;
+  }
+
+  KX_PickingRayCast callback(ray.m_camera->GetPhysicsController());
+  const MT_Vector3 &from = ray.m_source;
+  const MT_Vector3 &to = ray.m_target;
+
+  PHY_IPhysicsController *hitController = physEnv->RayTest(
+      callback, from.x(), from.y(), from.z(), to.x(), to.y(), to.z());
+  if (!hitController) {
+    return;
+  }
+
+  KX_ClientObjectInfo *info = static_cast<KX_ClientObjectInfo *>(
+      hitController->GetNewClientInfo());
+  ray.m_hit = {info->m_gameobject, callback.m_hitPoint, callback.m_hitNormal, callback.m_hitUV};
+  ray.m_hasHit = true;
+}
+
+const KX_PickingCache::Hit *KX_PickingCache::GetFirstHit(Ray &ray, KX_Scene *scene)
+{
+  if (!ray.m_traced) {
+    TraceRay(ray, scene);
+  }
+
+  return ray.m_hasHit ? &ray.m_hit : nullptr;
+}
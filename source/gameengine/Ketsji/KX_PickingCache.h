@@ -0,0 +1,88 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_PickingCache.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <list>
+
+#include "MT_Vector2.h"
+#include "MT_Vector3.h"
+
+class KX_Camera;
+class KX_GameObject;
+class KX_KetsjiEngine;
+class KX_Scene;
+
+/** Mouse picking rays shared by all the mouse focus sensors of a scene.
+ * A ray is computed once per frame for each camera and mouse position and the nearest
+ * object it hits is traced lazily, so that all the sensors accepting this object share
+ * a single ray test. The sensors filtering it out (X-Ray or other collision masks) cast
+ * their own ray.
+ */
+class KX_PickingCache {
+ public:
+  struct Hit {
+    KX_GameObject *m_object;
+    MT_Vector3 m_point;
+    MT_Vector3 m_normal;
+    MT_Vector2 m_uv;
+  };
+
+  struct Ray {
+    KX_Camera *m_camera;
+    int m_x;
+    int m_y;
+    /// The mouse is in the camera viewport, otherwise the ray is not traced.
+    bool m_inViewport;
+    MT_Vector3 m_source;
+    MT_Vector3 m_target;
+    /// The ray test was done, m_hit is valid if m_hasHit is true.
+    bool m_traced;
+    bool m_hasHit;
+    /// Nearest object hit by the ray.
+    Hit m_hit;
+  };
+
+ private:
+  /// List to keep the rays valid when adding new ones.
+  std::list<Ray> m_rays;
+
+  void ComputeRay(Ray &ray, KX_Scene *scene, KX_KetsjiEngine *engine);
+  void TraceRay(Ray &ray, KX_Scene *scene);
+
+ public:
+  KX_PickingCache();
+  ~KX_PickingCache();
+
+  /// Discard all the rays, called when the cameras or the objects could have moved.
+  void Invalidate();
+
+  /// Return the ray of the camera through the mouse position, computed once per frame.
+  Ray &GetRay(KX_Scene *scene, KX_KetsjiEngine *engine, KX_Camera *cam, int x, int y);
+
+  /// Return the nearest object hit by the ray, or nullptr if there is none.
+  const Hit *GetFirstHit(Ray &ray, KX_Scene *scene);
+};
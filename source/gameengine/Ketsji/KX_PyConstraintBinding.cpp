@@ -600,6 +600,69 @@ static PyObject *gPyExportBulletFile(PyObject *, PyObject *args)
   Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR(gPySetShapeCacheDirectory__doc__,
+             "setShapeCacheDirectory(path)\n"
+             "Set the directory used to cache the triangle mesh BVHs, empty to disable it.\n");
+static PyObject *gPySetShapeCacheDirectory(PyObject *, PyObject *args)
+{
+  char *path;
+  if (!PyArg_ParseTuple(args, "s:setShapeCacheDirectory", &path))
+    return nullptr;
+
+  if (KX_GetPhysicsEnvironment()) {
+    KX_GetPhysicsEnvironment()->SetShapeCacheDirectory(path);
+  }
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gPySaveState__doc__,
+             "saveState()\n"
+             "Save the state of the simulation in a ring buffer and return its identifier.\n");
+static PyObject *gPySaveState(PyObject *, PyObject *)
+{
+  uint64_t state = 0;
+  if (KX_GetPhysicsEnvironment()) {
+    state = KX_GetPhysicsEnvironment()->SaveState();
+  }
+  return PyLong_FromUnsignedLongLong(state);
+}
+
+PyDoc_STRVAR(gPyRestoreState__doc__,
+             "restoreState(state)\n"
+             "Restore a state saved with saveState(), return False if it was overwritten.\n");
+static PyObject *gPyRestoreState(PyObject *, PyObject *args)
+{
+  unsigned long long state;
+  if (!PyArg_ParseTuple(args, "K:restoreState", &state))
+    return nullptr;
+
+  bool restored = false;
+  if (KX_GetPhysicsEnvironment()) {
+    restored = KX_GetPhysicsEnvironment()->RestoreState(state);
+  }
+  return PyBool_FromLong(restored);
+}
+
+PyDoc_STRVAR(gPySetStateBufferSize__doc__,
+             "setStateBufferSize(size)\n"
+             "Set the number of states kept by saveState().\n");
+static PyObject *gPySetStateBufferSize(PyObject *, PyObject *args)
+{
+  int size;
+  if (!PyArg_ParseTuple(args, "i:setStateBufferSize", &size))
+    return nullptr;
+
+  if (size < 1) {
+    PyErr_SetString(PyExc_ValueError, "setStateBufferSize(size): size must be at least 1");
+    return nullptr;
+  }
+
+  if (KX_GetPhysicsEnvironment()) {
+    KX_GetPhysicsEnvironment()->SetStateBufferSize(size);
+  }
+  Py_RETURN_NONE;
+}
+
 static struct PyMethodDef physicsconstraints_methods[] = {
     {"setGravity", (PyCFunction)gPySetGravity, METH_VARARGS, (const char *)gPySetGravity__doc__},
     {"setDebugMode",
@@ -693,6 +756,19 @@ static struct PyMethodDef physicsconstraints_methods[] = {
      (const char *)gPyGetAppliedImpulse__doc__},
 
     {"exportBulletFile", (PyCFunction)gPyExportBulletFile, METH_VARARGS, "export a .bullet file"},
+    {"setShapeCacheDirectory",
+     (PyCFunction)gPySetShapeCacheDirectory,
+     METH_VARARGS,
+     (const char *)gPySetShapeCacheDirectory__doc__},
+    {"saveState", (PyCFunction)gPySaveState, METH_NOARGS, (const char *)gPySaveState__doc__},
+    {"restoreState",
+     (PyCFunction)gPyRestoreState,
+     METH_VARARGS,
+     (const char *)gPyRestoreState__doc__},
+    {"setStateBufferSize",
+     (PyCFunction)gPySetStateBufferSize,
+     METH_VARARGS,
+     (const char *)gPySetStateBufferSize__doc__},
 
     // sentinel
     {nullptr, (PyCFunction) nullptr, 0, nullptr}};
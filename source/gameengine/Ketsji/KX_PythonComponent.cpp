@@ -30,9 +30,14 @@
 
 #  include "CM_Message.h"
 #  include "KX_GameObject.h"
+#  include "KX_Scene.h"
 
 KX_PythonComponent::KX_PythonComponent(const std::string &name)
-    : KX_PythonProxy(), m_gameobj(nullptr), m_name(name)
+    : KX_PythonProxy(),
+      m_gameobj(nullptr),
+      m_name(name),
+      m_schedulerGroup(-1),
+      m_schedulerSlot(-1)
 {
 }
 
@@ -55,6 +60,8 @@ void KX_PythonComponent::ProcessReplica()
   KX_PythonProxy::ProcessReplica();
 
   m_gameobj = nullptr;
+  m_schedulerGroup = -1;
+  m_schedulerSlot = -1;
 }
 
 KX_GameObject *KX_PythonComponent::GetGameObject() const
@@ -67,6 +74,32 @@ void KX_PythonComponent::SetGameObject(KX_GameObject *gameobj)
   m_gameobj = gameobj;
 }
 
+void KX_PythonComponent::Start()
+{
+  const bool started = IsStarted();
+  KX_PythonProxy::Start();
+
+  if (!started && IsStarted() && m_gameobj) {
+    m_gameobj->GetScene()->GetPythonProxyManager().RegisterComponent(this);
+  }
+}
+
+int KX_PythonComponent::GetSchedulerGroup() const
+{
+  return m_schedulerGroup;
+}
+
+int KX_PythonComponent::GetSchedulerSlot() const
+{
+  return m_schedulerSlot;
+}
+
+void KX_PythonComponent::SetSchedulerSlot(int group, int slot)
+{
+  m_schedulerGroup = group;
+  m_schedulerSlot = slot;
+}
+
 PyObject *KX_PythonComponent::py_component_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
   KX_PythonComponent *comp = new KX_PythonComponent(type->tp_name);
@@ -33,6 +33,9 @@ class KX_PythonComponent : public KX_PythonProxy {
 
       private : KX_GameObject *m_gameobj;
   std::string m_name;
+  /// Group and slot in the scene proxy manager when the class declares an update schedule.
+  int m_schedulerGroup;
+  int m_schedulerSlot;
 
  public:
   KX_PythonComponent(const std::string &name);
@@ -46,6 +49,13 @@ class KX_PythonComponent : public KX_PythonProxy {
   KX_GameObject *GetGameObject() const;
   void SetGameObject(KX_GameObject *gameobj);
 
+  /// Start the component and register it in the scene proxy manager.
+  virtual void Start();
+
+  int GetSchedulerGroup() const;
+  int GetSchedulerSlot() const;
+  void SetSchedulerSlot(int group, int slot);
+
   virtual KX_PythonProxy *NewInstance();
 
   static PyObject *py_component_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
@@ -52,11 +52,16 @@
 #  include "BKE_idtype.hh"
 #  include "BKE_library.hh"
 #  include "BKE_main.hh"
+#  include "BKE_text.h"
 #  include "BLI_blenlib.h"
 #  include "BLI_utildefines.h"
 #  include "CLG_log.h"
 #  include "DNA_ID.h"
+#  include "DNA_controller_types.h"
+#  include "DNA_object_types.h"
+#  include "DNA_python_proxy_types.h"
 #  include "DNA_scene_types.h"
+#  include "DNA_text_types.h"
 #  include "MEM_guardedalloc.h"
 #  include "bgl.h"
 #  include "bl_math_py_api.hh"
@@ -111,6 +116,7 @@
 #include "KX_PyConstraintBinding.h"
 #include "KX_PyMath.h"
 #include "KX_PythonInitTypes.h"
+#include "KX_StreamingManager.h"
 #include "PHY_IPhysicsEnvironment.h"
 #include "RAS_2DFilterManager.h"
 #include "RAS_ICanvas.h"
@@ -168,6 +174,7 @@ static void KX_MACRO_addTypesToDict_fn(PyObject *dict, const char *name, long va
 
 // temporarily python stuff, will be put in another place later !
 #  include "EXP_Python.h"
+#  include "SCA_PythonCodeCache.h"
 #  include "SCA_PythonController.h"
 // List of methods defined in the module
 
@@ -399,6 +406,33 @@ static PyObject *gPyGetMaxPhysicsFrame(PyObject *)
   return PyLong_FromLong(KX_GetActiveEngine()->GetMaxPhysicsFrame());
 }
 
+static PyObject *gPySetMaxSoundVoices(PyObject *, PyObject *args)
+{
+  int voices;
+  if (!PyArg_ParseTuple(args, "i:setMaxSoundVoices", &voices))
+    return nullptr;
+
+  if (voices < 0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "bge.logic.setMaxSoundVoices(voices): expected a positive value or 0");
+    return nullptr;
+  }
+
+  KX_GetActiveEngine()->GetSoundVoiceManager()->SetMaxVoices(voices);
+  Py_RETURN_NONE;
+}
+
+static PyObject *gPyGetMaxSoundVoices(PyObject *)
+{
+  return PyLong_FromLong(KX_GetActiveEngine()->GetSoundVoiceManager()->GetMaxVoices());
+}
+
+static PyObject *gPyGetSoundVoices(PyObject *)
+{
+  KX_SoundVoiceManager *manager = KX_GetActiveEngine()->GetSoundVoiceManager();
+  return Py_BuildValue("(II)", manager->GetNumVoices(), manager->GetNumVirtualVoices());
+}
+
 static PyObject *gPySetPhysicsTicRate(PyObject *, PyObject *args)
 {
   float ticrate;
@@ -446,6 +480,22 @@ static PyObject *gPySetUseExternalClock(PyObject *, PyObject *args)
   Py_RETURN_NONE;
 }
 
+static PyObject *gPyGetUseFrameInterpolation(PyObject *)
+{
+  return PyBool_FromLong(KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::INTERPOLATE_FRAMES));
+}
+
+static PyObject *gPySetUseFrameInterpolation(PyObject *, PyObject *args)
+{
+  int useFrameInterpolation;
+
+  if (!PyArg_ParseTuple(args, "p:setUseFrameInterpolation", &useFrameInterpolation))
+    return nullptr;
+
+  KX_GetActiveEngine()->SetFlag(KX_KetsjiEngine::INTERPOLATE_FRAMES, (bool)useFrameInterpolation);
+  Py_RETURN_NONE;
+}
+
 static PyObject *gPyGetClockTime(PyObject *)
 {
   return PyFloat_FromDouble(KX_GetActiveEngine()->GetClockTime());
@@ -821,6 +871,18 @@ static struct PyMethodDef game_methods[] = {
      (PyCFunction)gPySetMaxPhysicsFrame,
      METH_VARARGS,
      (const char *)"Sets the max number of physics farme per render frame"},
+    {"getMaxSoundVoices",
+     (PyCFunction)gPyGetMaxSoundVoices,
+     METH_NOARGS,
+     (const char *)"Gets the max number of audible sounds played at once"},
+    {"setMaxSoundVoices",
+     (PyCFunction)gPySetMaxSoundVoices,
+     METH_VARARGS,
+     (const char *)"Sets the max number of audible sounds played at once, 0 for no limit"},
+    {"getSoundVoices",
+     (PyCFunction)gPyGetSoundVoices,
+     METH_NOARGS,
+     (const char *)"Gets the number of playing sounds and of virtual sounds"},
     {"getLogicTicRate",
      (PyCFunction)gPyGetLogicTicRate,
      METH_NOARGS,
@@ -861,6 +923,14 @@ static struct PyMethodDef game_methods[] = {
      (PyCFunction)gPySetUseExternalClock,
      METH_VARARGS,
      (const char *)"Set if we use the time provided by an external clock"},
+    {"getUseFrameInterpolation",
+     (PyCFunction)gPyGetUseFrameInterpolation,
+     METH_NOARGS,
+     (const char *)"Get if the rendered transforms are interpolated between the logic tics"},
+    {"setUseFrameInterpolation",
+     (PyCFunction)gPySetUseFrameInterpolation,
+     METH_VARARGS,
+     (const char *)"Set if the rendered transforms are interpolated between the logic tics"},
     {"getClockTime",
      (PyCFunction)gPyGetClockTime,
      METH_NOARGS,
@@ -1815,6 +1885,14 @@ PyMODINIT_FUNC initGameLogicPythonBinding()
   KX_MACRO_addTypesToDict(d, KX_ACTION_BLEND_BLEND, BL_Action::ACT_BLEND_BLEND);
   KX_MACRO_addTypesToDict(d, KX_ACTION_BLEND_ADD, BL_Action::ACT_BLEND_ADD);
 
+  /* KX_StreamingManager cell states */
+  KX_MACRO_addTypesToDict(d, KX_STREAMING_CELL_UNLOADED, KX_StreamingManager::CELL_UNLOADED);
+  KX_MACRO_addTypesToDict(d, KX_STREAMING_CELL_READING, KX_StreamingManager::CELL_READING);
+  KX_MACRO_addTypesToDict(d, KX_STREAMING_CELL_READ, KX_StreamingManager::CELL_READ);
+  KX_MACRO_addTypesToDict(d, KX_STREAMING_CELL_LOADING, KX_StreamingManager::CELL_LOADING);
+  KX_MACRO_addTypesToDict(d, KX_STREAMING_CELL_RESIDENT, KX_StreamingManager::CELL_RESIDENT);
+  KX_MACRO_addTypesToDict(d, KX_STREAMING_CELL_FAILED, KX_StreamingManager::CELL_FAILED);
+
   /* Mouse Actuator object axis*/
   KX_MACRO_addTypesToDict(
       d, KX_ACT_MOUSE_OBJECT_AXIS_X, SCA_MouseActuator::KX_ACT_MOUSE_OBJECT_AXIS_X);
@@ -1930,6 +2008,137 @@ static void initPySysObjects(Main *maggie)
   initPySysObjects__append(sys_path, KX_GetMainPath().c_str());
 }
 
+/// Return the text block imported as a module or nullptr.
+static Text *findModuleText(Main *maggie, const std::string &module)
+{
+  const std::string textname = module + ".py";
+  return (Text *)BLI_findstring(&maggie->texts, textname.c_str(), offsetof(ID, name) + 2);
+}
+
+/** Give a text block its code from the cache, compile it and store it in the cache
+ * when \a compile is true and the text is not cached yet.
+ */
+static void setPyTextCode(Text *text, bool compile)
+{
+  if (text->compiled) {
+    return;
+  }
+
+  // Same file name as bpy_text_compile.
+  char filename[FILE_MAX];
+  bpy_text_filename_get(filename, sizeof(filename), text);
+
+  size_t buf_len;
+  char *buf = txt_to_buf(text, &buf_len);
+  const std::string source(buf, buf_len);
+  MEM_freeN(buf);
+
+  if (compile) {
+    text->compiled = SCA_PythonCodeCache::Compile(source, filename);
+    if (!text->compiled) {
+      // The error is reported again when the module is imported.
+      PyErr_Clear();
+    }
+  }
+  else {
+    text->compiled = SCA_PythonCodeCache::Find(source, filename);
+  }
+}
+
+void compilePythonModules(Main *maggie)
+{
+  LISTBASE_FOREACH (Object *, ob, &maggie->objects) {
+    LISTBASE_FOREACH (bController *, cont, &ob->controllers) {
+      if (cont->type != CONT_PYTHON) {
+        continue;
+      }
+
+      const bPythonCont *pycont = (bPythonCont *)cont->data;
+      if (pycont->mode != CONT_PY_MODULE) {
+        continue;
+      }
+
+      // The module of "SomeModule.Func".
+      const std::string path = pycont->module;
+      const size_t pos = path.rfind('.');
+      if (pos == std::string::npos) {
+        continue;
+      }
+
+      Text *text = findModuleText(maggie, path.substr(0, pos));
+      if (text) {
+        setPyTextCode(text, true);
+      }
+    }
+
+    LISTBASE_FOREACH (PythonProxy *, pp, &ob->components) {
+      Text *text = findModuleText(maggie, pp->module);
+      if (text) {
+        setPyTextCode(text, true);
+      }
+    }
+
+    if (ob->custom_object) {
+      Text *text = findModuleText(maggie, ob->custom_object->module);
+      if (text) {
+        setPyTextCode(text, true);
+      }
+    }
+  }
+}
+
+/** Use the code cache next to the blend file and give the text blocks which could be
+ * imported as modules their code from the cache, so that they are not compiled at their
+ * first import in the game. The texts imported by the components and the module mode
+ * controllers are compiled now if not cached, the others only when imported.
+ */
+static void initPyCodeCache(Main *maggie)
+{
+  const std::string &mainPath = KX_GetMainPath();
+  if (!mainPath.empty()) {
+    char cachedir[FILE_MAX];
+    BLI_path_split_dir_part(mainPath.c_str(), cachedir, sizeof(cachedir));
+    BLI_path_append_dir(cachedir, sizeof(cachedir), "__bgecache__");
+    SCA_PythonCodeCache::SetDirectory(cachedir);
+  }
+
+  compilePythonModules(maggie);
+
+  if (mainPath.empty()) {
+    return;
+  }
+
+  LISTBASE_FOREACH (Text *, text, &maggie->texts) {
+    if (BLI_path_extension_check(text->id.name + 2, ".py")) {
+      setPyTextCode(text, false);
+    }
+  }
+}
+
+/// Store the code of the text blocks imported during the game in the cache and clear it.
+static void exitPyCodeCache()
+{
+  Main *maggie = bpy_import_main_get();
+  if (maggie) {
+    LISTBASE_FOREACH (Text *, text, &maggie->texts) {
+      if (!text->compiled || !BLI_path_extension_check(text->id.name + 2, ".py")) {
+        continue;
+      }
+
+      char filename[FILE_MAX];
+      bpy_text_filename_get(filename, sizeof(filename), text);
+
+      size_t buf_len;
+      char *buf = txt_to_buf(text, &buf_len);
+      SCA_PythonCodeCache::Store(
+          std::string(buf, buf_len), filename, (PyObject *)text->compiled);
+      MEM_freeN(buf);
+    }
+  }
+
+  SCA_PythonCodeCache::Clear();
+}
+
 static void restorePySysObjects(void)
 {
   if (gp_sys_backup.path == nullptr) {
@@ -2029,6 +2238,8 @@ void InitGamePlayerPythonScripting(
 
   initPySysObjects(maggie);
 
+  initPyCodeCache(maggie);
+
   PyDict_SetItemString(PyImport_GetModuleDict(), "bge", initBGE());
 
   EXP_PyObjectPlus::ClearDeprecationWarning();
@@ -2056,6 +2267,8 @@ void exitGamePlayerPythonScripting()
    * pointer */
   restorePySysObjects(); /* get back the original sys.path and clear the backup */
 
+  exitPyCodeCache();
+
   // Py_Finalize();
   bpy_import_main_set(nullptr);
   EXP_PyObjectPlus::ClearDeprecationWarning();
@@ -2074,6 +2287,8 @@ void initGamePythonScripting(Main *maggie, bContext *C, bool *audioDeviceIsIniti
 
   initPySysObjects(maggie);
 
+  initPyCodeCache(maggie);
+
   PyDict_SetItemString(PyImport_GetModuleDict(), "bge", initBGE());
 
   BPY_python_reset(C);
@@ -2098,6 +2313,7 @@ void exitGamePythonScripting()
   }
 
   restorePySysObjects(); /* get back the original sys.path and clear the backup */
+  exitPyCodeCache();
   bpy_import_main_set(nullptr);
   EXP_PyObjectPlus::ClearDeprecationWarning();
 }
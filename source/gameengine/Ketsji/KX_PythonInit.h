@@ -82,6 +82,8 @@ void updatePythonJoysticks(short (&addrem)[JOYINDEX_MAX]);
 
 void addImportMain(struct Main *maggie);
 void removeImportMain(struct Main *maggie);
+/// Compile the text blocks imported by the components and the module mode controllers.
+void compilePythonModules(struct Main *maggie);
 
 typedef int (*PyNextFrameFunc)(void *);
 
@@ -60,6 +60,11 @@ void KX_PythonProxy::SetPrototype(PythonProxy *pp)
   m_pp = pp;
 }
 
+bool KX_PythonProxy::IsStarted() const
+{
+  return m_init;
+}
+
 void KX_PythonProxy::Start()
 {
   if (!m_pp || m_init) {
@@ -54,6 +54,8 @@ class KX_PythonProxy : public EXP_Value {
 
   virtual void Start();
 
+  bool IsStarted() const;
+
   virtual void Update();
 
   virtual void Dispose();
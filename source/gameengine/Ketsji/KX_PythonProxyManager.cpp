@@ -22,49 +22,383 @@
 
 #include "KX_PythonProxyManager.h"
 
-#include "CM_List.h"
-#include "KX_GameObject.h"
+#include <algorithm>
 
-static bool compareObjectDepth(KX_GameObject *o1, KX_GameObject *o2)
-{
-  return o1->GetSGNode()->GetDepth() > o2->GetSGNode()->GetDepth();
-}
+#include "BLI_time.h"
+
+#include "KX_GameObject.h"
+#include "KX_PythonComponent.h"
 
 KX_PythonProxyManager::KX_PythonProxyManager()
+    : m_updating(false), m_hasRemovedEntries(false), m_frame(0)
 {
 }
 
 KX_PythonProxyManager::~KX_PythonProxyManager()
 {
+#ifdef WITH_PYTHON
+  for (ComponentGroup &group : m_groups) {
+    Py_XDECREF(group.m_updateGroup);
+    Py_DECREF(group.m_type);
+  }
+#endif
 }
 
 void KX_PythonProxyManager::Register(KX_GameObject *gameobj)
 {
   // Always register only once an object.
-  m_objects.push_back(gameobj);
-  m_objects_changed = true;
+  BLI_assert(gameobj->GetPythonProxySlot() == -1);
+
+  // The object lists can't be modified while iterated.
+  if (m_updating) {
+    m_pendingObjects.push_back(gameobj);
+    return;
+  }
+
+  const unsigned short depth = gameobj->GetSGNode()->GetDepth();
+  if (depth >= m_objects.size()) {
+    m_objects.resize(depth + 1);
+  }
+
+  std::vector<KX_GameObject *> &objects = m_objects[depth];
+  gameobj->SetPythonProxySlot(objects.size(), depth);
+  objects.push_back(gameobj);
 }
 
 void KX_PythonProxyManager::Unregister(KX_GameObject *gameobj)
 {
-  CM_ListRemoveIfFound(m_objects, gameobj);
-  m_objects_changed = true;
+#ifdef WITH_PYTHON
+  EXP_ListValue<KX_PythonComponent> *components = gameobj->GetComponents();
+  if (components) {
+    for (KX_PythonComponent *comp : components) {
+      UnregisterComponent(comp);
+    }
+  }
+#endif
+
+  const int slot = gameobj->GetPythonProxySlot();
+  if (slot == -1) {
+    // The object was registered during the update.
+    for (std::vector<KX_GameObject *>::iterator it = m_pendingObjects.begin(),
+                                                end = m_pendingObjects.end();
+         it != end;
+         ++it)
+    {
+      if (*it == gameobj) {
+        m_pendingObjects.erase(it);
+        break;
+      }
+    }
+    return;
+  }
+
+  std::vector<KX_GameObject *> &objects = m_objects[gameobj->GetPythonProxyDepth()];
+  gameobj->SetPythonProxySlot(-1, 0);
+
+  if (m_updating) {
+    objects[slot] = nullptr;
+    m_hasRemovedEntries = true;
+    return;
+  }
+
+  // Swap remove, the last object takes the slot of the removed one.
+  KX_GameObject *last = objects.back();
+  if (last != gameobj) {
+    objects[slot] = last;
+    last->SetPythonProxySlot(slot, last->GetPythonProxyDepth());
+  }
+  objects.pop_back();
 }
 
+void KX_PythonProxyManager::CompactObjects()
+{
+  for (std::vector<KX_GameObject *> &objects : m_objects) {
+    unsigned int size = 0;
+    for (KX_GameObject *gameobj : objects) {
+      if (gameobj) {
+        gameobj->SetPythonProxySlot(size, gameobj->GetPythonProxyDepth());
+        objects[size++] = gameobj;
+      }
+    }
+    objects.resize(size);
+  }
+
+#ifdef WITH_PYTHON
+  for (unsigned int i = 0, size = m_groups.size(); i < size; ++i) {
+    CompactGroup(i);
+  }
+#endif
+}
+
+#ifdef WITH_PYTHON
+
+int KX_PythonProxyManager::FindGroup(PyTypeObject *type)
+{
+  std::unordered_map<PyTypeObject *, int>::iterator it = m_groupIndices.find(type);
+  if (it != m_groupIndices.end()) {
+    return it->second;
+  }
+
+  PyObject *pytype = (PyObject *)type;
+  int interval = 1;
+  double budget = 0.0;
+  PyObject *updateGroup = nullptr;
+
+  if (PyObject_HasAttrString(pytype, "updateInterval")) {
+    PyObject *value = PyObject_GetAttrString(pytype, "updateInterval");
+    interval = PyLong_AsLong(value);
+    Py_XDECREF(value);
+  }
+  if (PyObject_HasAttrString(pytype, "updateBudget")) {
+    PyObject *value = PyObject_GetAttrString(pytype, "updateBudget");
+    budget = PyFloat_AsDouble(value);
+    Py_XDECREF(value);
+  }
+  if (PyObject_HasAttrString(pytype, "updateGroup")) {
+    updateGroup = PyObject_GetAttrString(pytype, "updateGroup");
+    if (updateGroup && !PyCallable_Check(updateGroup)) {
+      Py_CLEAR(updateGroup);
+    }
+  }
+
+  if (PyErr_Occurred()) {
+    PyErr_Print();
+    interval = 1;
+    budget = 0.0;
+  }
+
+  int index = -1;
+  if (interval > 1 || budget > 0.0 || updateGroup) {
+    index = m_groups.size();
+    // Keep the class alive as long as it is used as a key.
+    Py_INCREF(type);
+    m_groups.push_back(
+        {type, {}, (unsigned int)std::max(interval, 1), budget, updateGroup, 0, 0.0});
+  }
+
+  m_groupIndices[type] = index;
+  return index;
+}
+
+bool KX_PythonProxyManager::RegisterComponent(KX_PythonComponent *comp)
+{
+  PyObject *proxy = comp->GetProxy();
+  const int index = FindGroup(Py_TYPE(proxy));
+  Py_DECREF(proxy);
+
+  if (index == -1) {
+    return false;
+  }
+
+  comp->SetSchedulerSlot(index, -1);
+
+  // The groups can't be modified while iterated, the component is started and updated next frame.
+  if (m_updating) {
+    m_pendingComponents.push_back(comp);
+    return true;
+  }
+
+  std::vector<KX_PythonComponent *> &components = m_groups[index].m_components;
+  comp->SetSchedulerSlot(index, components.size());
+  components.push_back(comp);
+
+  return true;
+}
+
+void KX_PythonProxyManager::UnregisterComponent(KX_PythonComponent *comp)
+{
+  const int index = comp->GetSchedulerGroup();
+  if (index == -1) {
+    return;
+  }
+
+  const int slot = comp->GetSchedulerSlot();
+  comp->SetSchedulerSlot(-1, -1);
+
+  if (slot == -1) {
+    for (std::vector<KX_PythonComponent *>::iterator it = m_pendingComponents.begin(),
+                                                     end = m_pendingComponents.end();
+         it != end;
+         ++it)
+    {
+      if (*it == comp) {
+        m_pendingComponents.erase(it);
+        break;
+      }
+    }
+    return;
+  }
+
+  std::vector<KX_PythonComponent *> &components = m_groups[index].m_components;
+  if (m_updating) {
+    components[slot] = nullptr;
+    m_hasRemovedEntries = true;
+    return;
+  }
+
+  KX_PythonComponent *last = components.back();
+  if (last != comp) {
+    components[slot] = last;
+    last->SetSchedulerSlot(index, slot);
+  }
+  components.pop_back();
+}
+
+void KX_PythonProxyManager::CompactGroup(unsigned int index)
+{
+  ComponentGroup &group = m_groups[index];
+  unsigned int size = 0;
+  for (KX_PythonComponent *comp : group.m_components) {
+    if (comp) {
+      comp->SetSchedulerSlot(index, size);
+      group.m_components[size++] = comp;
+    }
+  }
+  group.m_components.resize(size);
+}
+
+void KX_PythonProxyManager::UpdateGroup(ComponentGroup &group)
+{
+  const unsigned int size = group.m_components.size();
+  if (size == 0) {
+    return;
+  }
+
+  // Select the components to update this frame.
+  std::vector<KX_PythonComponent *> components;
+  if (group.m_budget > 0.0) {
+    unsigned int count = size;
+    // With a grouped update the count is estimated from the previous updates.
+    if (group.m_updateGroup && group.m_componentTime > 0.0) {
+      count = std::min(size, std::max(1u, (unsigned int)(group.m_budget / group.m_componentTime)));
+    }
+    group.m_cursor %= size;
+    for (unsigned int i = 0; i < count; ++i) {
+      KX_PythonComponent *comp = group.m_components[(group.m_cursor + i) % size];
+      // Skip the components removed during the update of the objects.
+      if (comp) {
+        components.push_back(comp);
+      }
+    }
+  }
+  else {
+    // Spread the components over the frames of the interval.
+    for (unsigned int i = m_frame % group.m_interval; i < size; i += group.m_interval) {
+      KX_PythonComponent *comp = group.m_components[i];
+      if (comp) {
+        components.push_back(comp);
+      }
+    }
+  }
+
+  if (components.empty()) {
+    return;
+  }
+
+  const double startTime = BLI_time_now_seconds();
+
+  if (group.m_updateGroup) {
+    PyObject *list = PyList_New(0);
+    for (KX_PythonComponent *comp : components) {
+      KX_GameObject *gameobj = comp->GetGameObject();
+      if (!gameobj->IsLogicSuspended()) {
+        PyObject *proxy = comp->GetProxy();
+        PyList_Append(list, proxy);
+        Py_DECREF(proxy);
+      }
+    }
+
+    if (PyList_GET_SIZE(list) > 0) {
+      PyObject *ret = PyObject_CallOneArg(group.m_updateGroup, list);
+      if (ret) {
+        Py_DECREF(ret);
+      }
+      else {
+        components.front()->LogError("Failed to invoke the updateGroup callback.");
+      }
+    }
+    Py_DECREF(list);
+
+    group.m_cursor += components.size();
+    group.m_componentTime = (BLI_time_now_seconds() - startTime) / components.size();
+  }
+  else if (group.m_budget > 0.0) {
+    // Update at least one component per frame to ensure progress.
+    for (KX_PythonComponent *comp : components) {
+      ++group.m_cursor;
+      // Component removed by a previous update of the group.
+      if (comp->GetSchedulerSlot() == -1) {
+        continue;
+      }
+      if (!comp->GetGameObject()->IsLogicSuspended()) {
+        comp->Update();
+      }
+      if ((BLI_time_now_seconds() - startTime) >= group.m_budget) {
+        break;
+      }
+    }
+  }
+  else {
+    for (KX_PythonComponent *comp : components) {
+      // Component removed by a previous update of the group.
+      if (comp->GetSchedulerSlot() == -1) {
+        continue;
+      }
+      if (!comp->GetGameObject()->IsLogicSuspended()) {
+        comp->Update();
+      }
+    }
+  }
+}
+
+#endif  // WITH_PYTHON
+
 void KX_PythonProxyManager::Update()
 {
-  if (m_objects_changed) {
-    std::sort(m_objects.begin(), m_objects.end(), compareObjectDepth);
+  /* Objects and components registered during the update are added after it, the
+   * removed ones are replaced by nullptr, this avoids to copy the lists every frame. */
+  m_updating = true;
+
+  for (unsigned short depth = m_objects.size(); depth-- > 0;) {
+    std::vector<KX_GameObject *> &objects = m_objects[depth];
+    // Index based, the list is never reallocated during the update.
+    for (unsigned int i = 0, size = objects.size(); i < size; ++i) {
+      KX_GameObject *gameobj = objects[i];
+      if (gameobj) {
+        gameobj->Update();
+      }
+    }
+  }
+
+#ifdef WITH_PYTHON
+  for (unsigned int i = 0, size = m_groups.size(); i < size; ++i) {
+    UpdateGroup(m_groups[i]);
+  }
+#endif
+
+  m_updating = false;
+  ++m_frame;
+
+  if (m_hasRemovedEntries) {
+    CompactObjects();
+    m_hasRemovedEntries = false;
+  }
 
-    m_objects_changed = false;
+  if (!m_pendingObjects.empty()) {
+    std::vector<KX_GameObject *> pendingObjects;
+    pendingObjects.swap(m_pendingObjects);
+    for (KX_GameObject *gameobj : pendingObjects) {
+      Register(gameobj);
+    }
   }
 
-  /* Update object components, we copy the object pointer in a second list to make
-   * sure that we iterate on a list which will not be modified, indeed components
-   * can add objects in theirs update.
-   */
-  const std::vector<KX_GameObject *> objects = m_objects;
-  for (KX_GameObject *gameobj : objects) {
-    gameobj->Update();
+#ifdef WITH_PYTHON
+  if (!m_pendingComponents.empty()) {
+    std::vector<KX_PythonComponent *> pendingComponents;
+    pendingComponents.swap(m_pendingComponents);
+    for (KX_PythonComponent *comp : pendingComponents) {
+      RegisterComponent(comp);
+    }
   }
+#endif
 }
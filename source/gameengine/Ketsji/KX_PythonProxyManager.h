@@ -1,13 +1,68 @@
 #pragma once
 
+#include <deque>
+#include <unordered_map>
 #include <vector>
 
+#ifdef WITH_PYTHON
+#  include "EXP_Python.h"
+#endif
+
 class KX_GameObject;
+class KX_PythonComponent;
 
+/** Update the python proxies of the game objects: custom game object classes and components.
+ * The objects are updated from the deepest in the hierarchy to the roots.
+ *
+ * Components declaring an update schedule in their class are updated apart, per class,
+ * after the objects:
+ * - updateInterval: each component is updated every N frames, the components of the class
+ *   are spread over the frames.
+ * - updateBudget: time in seconds per frame allowed for the components of the class,
+ *   they are updated in round robin until the budget is spent.
+ * - updateGroup(components): class method called with the list of the components to
+ *   update instead of calling update() of every component.
+ */
 class KX_PythonProxyManager {
  private:
-  std::vector<KX_GameObject *> m_objects;
-  bool m_objects_changed = false;
+  /// Registered objects per depth in the scene graph, unordered in a depth.
+  std::vector<std::vector<KX_GameObject *>> m_objects;
+  /// Objects registered during the update, added after it.
+  std::vector<KX_GameObject *> m_pendingObjects;
+
+#ifdef WITH_PYTHON
+  struct ComponentGroup {
+    /// Python class of the components.
+    PyTypeObject *m_type;
+    std::vector<KX_PythonComponent *> m_components;
+    unsigned int m_interval;
+    double m_budget;
+    /// Class method receiving the list of components to update, can be nullptr.
+    PyObject *m_updateGroup;
+    /// Next component to update in budget mode.
+    unsigned int m_cursor;
+    /// Estimated update time of a component, used to size the groups in budget mode.
+    double m_componentTime;
+  };
+
+  /// Groups of scheduled components, a deque keeps the groups in place when a class is added.
+  std::deque<ComponentGroup> m_groups;
+  /// Group index per python class, -1 for classes using the default update.
+  std::unordered_map<PyTypeObject *, int> m_groupIndices;
+  /// Components started during the update, scheduled after it.
+  std::vector<KX_PythonComponent *> m_pendingComponents;
+
+  int FindGroup(PyTypeObject *type);
+  void UpdateGroup(ComponentGroup &group);
+  void CompactGroup(unsigned int index);
+#endif
+
+  /// The object or component lists are iterated, removed entries are set to nullptr.
+  bool m_updating;
+  bool m_hasRemovedEntries;
+  unsigned int m_frame;
+
+  void CompactObjects();
 
  public:
   KX_PythonProxyManager();
@@ -16,5 +71,13 @@ class KX_PythonProxyManager {
   void Register(KX_GameObject *gameobj);
   void Unregister(KX_GameObject *gameobj);
 
+#ifdef WITH_PYTHON
+  /** Schedule the update of a started component if its class declares a schedule.
+   * \return True if the component is updated by the manager instead of its object.
+   */
+  bool RegisterComponent(KX_PythonComponent *comp);
+  void UnregisterComponent(KX_PythonComponent *comp);
+#endif
+
   void Update();
 };
@@ -101,19 +101,28 @@ bool KX_RayCast::RayTest(PHY_IPhysicsEnvironment *physics_environment,
     // Note that retrieving in a single shot multiple hit points would be possible
     // but it would require some change in Bullet.
     prevpoint = callback.m_hitPoint;
-    /* We add 0.001 of fudge, so that if the margin && radius == 0.0, we don't endless loop. */
-    MT_Scalar marg = 0.001f + hit_controller->GetMargin();
-    marg *= 2.f;
-    /* Calculate the other side of this object */
-    MT_Scalar h = MT_abs(todir.dot(callback.m_hitNormal));
-    if (h <= 0.01f)
-      // the normal is almost orthogonal to the ray direction, cannot compute the other side
-      break;
-    marg /= h;
-    frompoint = callback.m_hitPoint + marg * todir;
-    // verify that we are not passed the to point
-    if ((topoint - frompoint).dot(todir) < 0.f)
+    if (!NextRayStart(hit_controller, callback, topoint, todir, frompoint))
       break;
   }
   return false;
 }
+
+bool KX_RayCast::NextRayStart(PHY_IPhysicsController *hit_controller,
+                              const KX_RayCast &callback,
+                              const MT_Vector3 &topoint,
+                              const MT_Vector3 &todir,
+                              MT_Vector3 &frompoint)
+{
+  /* We add 0.001 of fudge, so that if the margin && radius == 0.0, we don't endless loop. */
+  MT_Scalar marg = 0.001f + hit_controller->GetMargin();
+  marg *= 2.f;
+  /* Calculate the other side of this object */
+  MT_Scalar h = MT_abs(todir.dot(callback.m_hitNormal));
+  if (h <= 0.01f)
+    // the normal is almost orthogonal to the ray direction, cannot compute the other side
+    return false;
+  marg /= h;
+  frompoint = callback.m_hitPoint + marg * todir;
+  // verify that we are not passed the to point
+  return ((topoint - frompoint).dot(todir) >= 0.f);
+}
@@ -97,6 +97,15 @@ class KX_RayCast : public PHY_IRayCastFilterCallback {
                       const MT_Vector3 &frompoint,
                       const MT_Vector3 &topoint,
                       KX_RayCast &callback);
+
+  /** Compute the point after the object hit by the callback to continue tracing.
+   * Return false if the ray can't progress further.
+   */
+  static bool NextRayStart(PHY_IPhysicsController *hit_controller,
+                           const KX_RayCast &callback,
+                           const MT_Vector3 &topoint,
+                           const MT_Vector3 &todir,
+                           MT_Vector3 &frompoint);
 };
 
 template<class T, class dataT> class KX_RayCast::Callback : public KX_RayCast {
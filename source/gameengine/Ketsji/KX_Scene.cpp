@@ -79,6 +79,7 @@
 #include "KX_NodeRelationships.h"
 #include "KX_ObstacleSimulation.h"
 #include "KX_PyMath.h"
+#include "KX_StreamingManager.h"
 #include "PHY_IPhysicsController.h"
 #include "PHY_IPhysicsEnvironment.h"
 #include "RAS_BucketManager.h"
@@ -89,6 +90,7 @@
 #include "SCA_JoystickManager.h"
 #include "SCA_KeyboardManager.h"
 #include "SCA_MouseManager.h"
+#include "SCA_PythonController.h"
 #include "SCA_TimeEventManager.h"
 #include "SG_Controller.h"
 
@@ -160,14 +162,24 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
   m_dbvt_culling = false;
   m_dbvt_occlusion_res = 0;
   m_activityCulling = false;
+  m_interpolationTick = 0;
+  m_interpolationFactor = 1.0f;
   m_objectlist = new EXP_ListValue<KX_GameObject>();
   m_parentlist = new EXP_ListValue<KX_GameObject>();
   m_lightlist = new EXP_ListValue<KX_LightObject>();
   m_inactivelist = new EXP_ListValue<KX_GameObject>();
   m_cameralist = new EXP_ListValue<KX_Camera>();
   m_fontlist = new EXP_ListValue<KX_FontObject>();
+  /* Search and remove the objects in constant time, the order of these lists is kept. The
+   * camera list is not indexed as it only holds a few cameras. */
+  m_objectlist->SetIndexed(true);
+  m_parentlist->SetIndexed(true);
+  m_lightlist->SetIndexed(true);
+  m_inactivelist->SetIndexed(true);
+  m_fontlist->SetIndexed(true);
 
   m_filterManager = new KX_2DFilterManager();
+  m_streamingManager = new KX_StreamingManager(this);
   m_logicmgr = new SCA_LogicManager();
 
   m_timemgr = new SCA_TimeEventManager(m_logicmgr);
@@ -389,6 +401,8 @@ KX_Scene::~KX_Scene()
     BLI_task_pool_free(m_animationPool);
   }
 
+  m_activityCullingGrid.Invalidate();
+
   if (m_objectlist)
     m_objectlist->Release();
 
@@ -420,6 +434,10 @@ KX_Scene::~KX_Scene()
     delete m_filterManager;
   }
 
+  if (m_streamingManager) {
+    delete m_streamingManager;
+  }
+
   if (m_logicmgr)
     delete m_logicmgr;
 
@@ -1429,7 +1447,7 @@ KX_GameObject *KX_Scene::AddDuplicaObject(KX_GameObject *gameobj,
       // lifespan of zero means 'this object lives forever'
       if (lifespan > 0.0f) {
         // for now, convert between so called frames and realtime
-        m_tempObjectList.push_back(replica);
+        m_tempObjectList.Add(replica);
         // this convert the life from frames to sort-of seconds, hard coded 0.02 that assumes we
         // have 50 frames per second if you change this value, make sure you change it in
         // KX_GameObject::pyattr_get_life property too
@@ -1535,6 +1553,14 @@ EXP_ListValue<KX_FontObject> *KX_Scene::GetFontList() const
   return m_fontlist;
 }
 
+void KX_Scene::AddModifiedFont(KX_FontObject *font)
+{
+  if (!font->IsTextModified()) {
+    font->SetTextModified(true);
+    m_modifiedFonts.push_back(font);
+  }
+}
+
 void KX_Scene::SetFramingType(RAS_FrameSettings &frame_settings)
 {
   m_frame_settings = frame_settings;
@@ -1554,6 +1580,23 @@ const RAS_FrameSettings &KX_Scene::GetFramingType() const
 void KX_Scene::SetActivityCulling(bool b)
 {
   m_activityCulling = b;
+  // Untrack all objects, the grid is rebuilt when the culling is enabled again.
+  m_activityCullingGrid.Invalidate();
+}
+
+KX_ActivityCullingGrid &KX_Scene::GetActivityCullingGrid()
+{
+  return m_activityCullingGrid;
+}
+
+KX_PickingCache &KX_Scene::GetPickingCache()
+{
+  return m_pickingCache;
+}
+
+KX_StreamingManager *KX_Scene::GetStreamingManager() const
+{
+  return m_streamingManager;
 }
 
 void KX_Scene::AddObjectDebugProperties(class KX_GameObject *gameobj)
@@ -1643,13 +1686,16 @@ KX_GameObject *KX_Scene::AddNodeReplicaObject(SG_Node *node, KX_GameObject *game
 
   // this is the list of object that are send to the graphics pipeline
   m_objectlist->Add(CM_AddRef(newobj));
+  m_activityCullingGrid.AddObject(newobj);
   switch (newobj->GetGameObjectType()) {
     case SCA_IObject::OBJ_LIGHT: {
       m_lightlist->Add(CM_AddRef(static_cast<KX_LightObject *>(newobj)));
       break;
     }
     case SCA_IObject::OBJ_TEXT: {
-      m_fontlist->Add(CM_AddRef(static_cast<KX_FontObject *>(newobj)));
+      KX_FontObject *font = static_cast<KX_FontObject *>(newobj);
+      m_fontlist->Add(CM_AddRef(font));
+      AddModifiedFont(font);
       break;
     }
     case SCA_IObject::OBJ_CAMERA: {
@@ -1991,7 +2037,7 @@ KX_GameObject *KX_Scene::AddReplicaObject(KX_GameObject *originalobject,
   // lifespan of zero means 'this object lives forever'
   if (lifespan > 0.0f) {
     // for now, convert between so called frames and realtime
-    m_tempObjectList.push_back(replica);
+    m_tempObjectList.Add(replica);
     // this convert the life from frames to sort-of seconds, hard coded 0.016666667 that assumes we have
     // 60 frames per second if you change this value, make sure you change it in
     // KX_GameObject::pyattr_get_life property too
@@ -2122,6 +2168,8 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
    */
   gameobj->InvalidateProxy();
 
+  m_streamingManager->RemoveObject(gameobj);
+
   // keep the blender->game object association up to date
   // note that all the replicas of an object will have the same
   // blender object, that's why we need to check the game object
@@ -2178,6 +2226,7 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
   }
 
   m_proxyManager.Unregister(gameobj);
+  m_activityCullingGrid.RemoveObject(gameobj);
 
   gameobj->RemoveMeshes();
 
@@ -2195,6 +2244,9 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
     ret = (gameobj->Release() != nullptr);
   }
   if (m_fontlist->RemoveValue(gameobj)) {
+    m_modifiedFonts.erase(
+        std::remove(m_modifiedFonts.begin(), m_modifiedFonts.end(), gameobj),
+        m_modifiedFonts.end());
     ret = (gameobj->Release() != nullptr);
   }
   if (m_cameralist->RemoveValue(gameobj)) {
@@ -2372,6 +2424,10 @@ void KX_Scene::LogicBeginFrame(double curtime, double framestep)
       BLI_assert(false);
     }
   }
+
+  // The cameras and objects moved since the last frame.
+  m_pickingCache.Invalidate();
+
   m_logicmgr->BeginFrame(curtime, framestep);
 }
 
@@ -2380,6 +2436,15 @@ void KX_Scene::AddAnimatedObject(KX_GameObject *gameobj)
   CM_ListAddIfNotFound(m_animatedlist, gameobj);
 }
 
+void KX_Scene::UpdateObjectName(KX_GameObject *gameobj)
+{
+  m_objectlist->UpdateValueName(gameobj);
+  m_parentlist->UpdateValueName(gameobj);
+  m_lightlist->UpdateValueName(gameobj);
+  m_inactivelist->UpdateValueName(gameobj);
+  m_fontlist->UpdateValueName(gameobj);
+}
+
 // static void update_anim_thread_func(TaskPool *pool, void *taskdata, int UNUSED(threadid))
 //{
 //  KX_GameObject *gameobj, *parent;
@@ -2455,6 +2520,9 @@ void KX_Scene::LogicEndFrame()
 {
   m_logicmgr->EndFrame();
 
+  // Don't keep the hit objects which could be removed.
+  m_pickingCache.Invalidate();
+
   /* Don't remove the objects from the euthanasy list here as the child objects of a deleted
    * parent object are destructed directly from the sgnode in the same time the parent
    * object is destructed. These child objects must be removed automatically from the
@@ -2465,13 +2533,18 @@ void KX_Scene::LogicEndFrame()
     RemoveObject(m_euthanasyobjects.front());
   }
 
+  // Load and free the world cells once the removed objects are gone.
+  m_streamingManager->Update();
+
   // prepare obstacle simulation for new frame
   if (m_obstacleSimulation)
     m_obstacleSimulation->UpdateObstacles();
 
-  for (KX_FontObject *font : m_fontlist) {
+  for (KX_FontObject *font : m_modifiedFonts) {
+    font->SetTextModified(false);
     font->UpdateTextFromProperty();
   }
+  m_modifiedFonts.clear();
 }
 
 /**
@@ -2548,24 +2621,37 @@ void KX_Scene::UpdateObjectActivity(void)
     return;
   }
 
-  for (KX_GameObject *gameobj : m_objectlist) {
-    // If the object doesn't manage activity culling we don't compute distance.
-    if (gameobj->GetActivityCullingInfo().m_flags ==
-        KX_GameObject::ActivityCullingInfo::ACTIVITY_NONE) {
-      continue;
-    }
+  if (m_activityCullingGrid.IsInvalid()) {
+    m_activityCullingGrid.Rebuild(m_objectlist);
+  }
 
-    // For each camera compute the distance to objects and keep the minimum distance.
-    const MT_Vector3 &obpos = gameobj->NodeGetWorldPosition();
-    float dist = FLT_MAX;
-    for (const MT_Vector3 &campos : camPositions) {
-      // Keep the minimum distance.
-      dist = min_ff((obpos - campos).length2(), dist);
-    }
-    gameobj->UpdateActivity(dist);
+  // Only the objects of cells which changed of distance band are evaluated.
+  m_activityCullingGrid.Update(camPositions);
+}
+
+void KX_Scene::SaveTickTransforms()
+{
+  ++m_interpolationTick;
+  for (KX_GameObject *gameobj : m_objectlist) {
+    gameobj->GetSGNode()->SaveTickTransform(m_interpolationTick);
   }
 }
 
+void KX_Scene::SetInterpolationFactor(float factor)
+{
+  m_interpolationFactor = factor;
+}
+
+unsigned int KX_Scene::GetInterpolationTick() const
+{
+  return m_interpolationTick;
+}
+
+float KX_Scene::GetInterpolationFactor() const
+{
+  return m_interpolationFactor;
+}
+
 KX_NetworkMessageScene *KX_Scene::GetNetworkMessageScene()
 {
   return m_networkScene;
@@ -2624,6 +2710,17 @@ static void MergeScene_LogicBrick(SCA_ILogicBrick *brick, KX_Scene *from, KX_Sce
   if (filter_actuator) {
     filter_actuator->SetScene(to, to->Get2DFilterManager());
   }
+
+#ifdef WITH_PYTHON
+  /* The scripts of the libloaded controllers are not compiled during the conversion which can
+   * be run without the GIL, compile them now to avoid a hitch at their first execution. */
+  SCA_PythonController *pyctrl = dynamic_cast<SCA_PythonController *>(brick);
+  if (pyctrl && pyctrl->GetMode() == SCA_PythonController::SCA_PYEXEC_SCRIPT &&
+      pyctrl->IsScriptModified())
+  {
+    pyctrl->Compile();
+  }
+#endif  // WITH_PYTHON
 }
 
 static void MergeScene_GameObject(KX_GameObject *gameobj, KX_Scene *to, KX_Scene *from)
@@ -2695,6 +2792,10 @@ bool KX_Scene::MergeScene(KX_Scene *other)
 
   GetBucketManager()->MergeBucketManager(other->GetBucketManager());
 
+  // Objects of the other scene are moved, both activity culling grids are rebuilt.
+  other->GetActivityCullingGrid().Invalidate();
+  m_activityCullingGrid.Invalidate();
+
   /* active + inactive == all ??? - lets hope so */
   for (KX_GameObject *gameobj : *other->GetObjectList()) {
     MergeScene_GameObject(gameobj, this, other);
@@ -2746,6 +2847,9 @@ bool KX_Scene::MergeScene(KX_Scene *other)
 
   GetFontList()->MergeList(other->GetFontList());
   other->GetFontList()->ReleaseAndRemoveAll();
+  m_modifiedFonts.insert(
+      m_modifiedFonts.end(), other->m_modifiedFonts.begin(), other->m_modifiedFonts.end());
+  other->m_modifiedFonts.clear();
 
   /* move materials across, assume they both use the same scene-converters
    * Do this after lights are merged so materials can use the lights in shaders
@@ -2807,6 +2911,9 @@ void KX_Scene::RunDrawingCallbacks(DrawingCallbackType callbackType, KX_Camera *
     return;
   }
 
+  // The callbacks could access the physics simulated during the render.
+  KX_GetActiveEngine()->FinishPhysicsStep();
+
   if (camera) {
     PyObject *args[1] = {camera->GetProxy()};
     EXP_RunPythonCallBackList(list, args, 0, 1);
@@ -3050,6 +3157,14 @@ PyObject *KX_Scene::pyattr_get_filter_manager(EXP_PyObjectPlus *self_v,
   return filterManager->GetProxy();
 }
 
+PyObject *KX_Scene::pyattr_get_streaming(EXP_PyObjectPlus *self_v,
+                                         const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_Scene *self = static_cast<KX_Scene *>(self_v);
+
+  return self->GetStreamingManager()->GetProxy();
+}
+
 PyObject *KX_Scene::pyattr_get_texts(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef)
 {
   KX_Scene *self = static_cast<KX_Scene *>(self_v);
@@ -3185,6 +3300,14 @@ int KX_Scene::pyattr_set_remove_callback(EXP_PyObjectPlus *self_v,
   return PY_SET_ATTR_SUCCESS;
 }
 
+PyObject *KX_Scene::pyattr_get_activity_culling_updates(EXP_PyObjectPlus *self_v,
+                                                        const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_Scene *self = static_cast<KX_Scene *>(self_v);
+
+  return PyLong_FromLong(self->m_activityCullingGrid.GetEvaluatedCount());
+}
+
 PyObject *KX_Scene::pyattr_get_gravity(EXP_PyObjectPlus *self_v,
                                        const EXP_PYATTRIBUTE_DEF *attrdef)
 {
@@ -3215,6 +3338,7 @@ PyAttributeDef KX_Scene::Attributes[] = {
     EXP_PYATTRIBUTE_RO_FUNCTION("texts", KX_Scene, pyattr_get_texts),
     EXP_PYATTRIBUTE_RO_FUNCTION("cameras", KX_Scene, pyattr_get_cameras),
     EXP_PYATTRIBUTE_RO_FUNCTION("filterManager", KX_Scene, pyattr_get_filter_manager),
+    EXP_PYATTRIBUTE_RO_FUNCTION("streaming", KX_Scene, pyattr_get_streaming),
     EXP_PYATTRIBUTE_RW_FUNCTION(
         "active_camera", KX_Scene, pyattr_get_active_camera, pyattr_set_active_camera),
     EXP_PYATTRIBUTE_RW_FUNCTION("overrideCullingCamera",
@@ -3231,6 +3355,8 @@ PyAttributeDef KX_Scene::Attributes[] = {
         "pre_draw_setup", KX_Scene, pyattr_get_drawing_callback, pyattr_set_drawing_callback),
     EXP_PYATTRIBUTE_RW_FUNCTION("gravity", KX_Scene, pyattr_get_gravity, pyattr_set_gravity),
     EXP_PYATTRIBUTE_BOOL_RO("activityCulling", KX_Scene, m_activityCulling),
+    EXP_PYATTRIBUTE_RO_FUNCTION(
+        "activityCullingUpdates", KX_Scene, pyattr_get_activity_culling_updates),
     EXP_PYATTRIBUTE_BOOL_RO("dbvt_culling", KX_Scene, m_dbvt_culling),
     EXP_PYATTRIBUTE_RO_FUNCTION("logger", KX_Scene, KX_PythonProxy::pyattr_get_logger),
     EXP_PYATTRIBUTE_RO_FUNCTION("loggerName", KX_Scene, KX_PythonProxy::pyattr_get_logger_name),
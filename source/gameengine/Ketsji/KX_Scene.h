@@ -37,9 +37,12 @@
 
 #include "DNA_ID.h"  // For IDRecalcFlag
 
+#include "CM_List.h"
 #include "EXP_PyObjectPlus.h"
 #include "EXP_Value.h"
+#include "KX_ActivityCullingGrid.h"
 #include "KX_PhysicsEngineEnums.h"
+#include "KX_PickingCache.h"
 #include "KX_PythonProxy.h"
 #include "KX_PythonProxyManager.h"
 #include "MT_Transform.h"
@@ -80,6 +83,7 @@ class RAS_DebugDraw;
 class RAS_FrameBuffer;
 class RAS_2DFilterManager;
 class KX_2DFilterManager;
+class KX_StreamingManager;
 class BL_SceneConverter;
 struct KX_ClientObjectInfo;
 class KX_ObstacleSimulation;
@@ -151,26 +155,28 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
 
   RAS_BucketManager *m_bucketmanager;
 
-  std::vector<KX_GameObject *> m_tempObjectList;
+  CM_IndexedList<KX_GameObject *> m_tempObjectList;
 
   /**
    * The list of objects which have been removed during the
    * course of one frame. They are actually destroyed in
    * LogicEndFrame() via a call to RemoveObject().
    */
-  std::vector<KX_GameObject *> m_euthanasyobjects;
+  CM_IndexedList<KX_GameObject *> m_euthanasyobjects;
 
   EXP_ListValue<KX_GameObject> *m_objectlist;
   EXP_ListValue<KX_GameObject> *m_parentlist;  // all 'root' parents
   EXP_ListValue<KX_LightObject> *m_lightlist;
   EXP_ListValue<KX_GameObject> *m_inactivelist;  // all objects that are not in the active layer
   /// All animated objects, no need of EXP_ListValue because the list isn't exposed in python.
-  std::vector<KX_GameObject *> m_animatedlist;
+  CM_IndexedList<KX_GameObject *> m_animatedlist;
 
   /// The set of cameras for this scene
   EXP_ListValue<KX_Camera> *m_cameralist;
   /// The set of fonts for this scene
   EXP_ListValue<KX_FontObject> *m_fontlist;
+  /// Fonts whose text property changed during the logic frame.
+  std::vector<KX_FontObject *> m_modifiedFonts;
 
   SG_QList m_sghead;  // list of nodes that needs scenegraph update
                       // the Dlist is not object that must be updated
@@ -264,6 +270,17 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
    */
   bool m_activityCulling;
 
+  /// Spatial grid of the objects using activity culling.
+  KX_ActivityCullingGrid m_activityCullingGrid;
+
+  /// Mouse picking rays shared by the mouse focus sensors during a logic frame.
+  KX_PickingCache m_pickingCache;
+
+  /// Index of the current logic and physics step, used to interpolate the object transforms.
+  unsigned int m_interpolationTick;
+  /// Blend factor between the two last steps of the rendered transforms.
+  float m_interpolationFactor;
+
   /**
    * Toggle to enable or disable culling via DBVT broadphase of Bullet.
    */
@@ -295,6 +312,9 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
 
   KX_2DFilterManager *m_filterManager;
 
+  /// Cells of the world loaded and freed around a focus object.
+  KX_StreamingManager *m_streamingManager;
+
   KX_ObstacleSimulation *m_obstacleSimulation;
 
   AnimationPoolData m_animationPoolData;
@@ -405,6 +425,8 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   void ReplaceMesh(KX_GameObject *gameobj, RAS_MeshObject *mesh, bool use_gfx, bool use_phys);
 
   void AddAnimatedObject(KX_GameObject *gameobj);
+  /// Update the name index of the object lists after the object was renamed.
+  void UpdateObjectName(KX_GameObject *gameobj);
 
   /**
    * \section Logic stuff
@@ -430,6 +452,8 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   EXP_ListValue<KX_Camera> *GetCameraList() const;
   void SetCameraList(EXP_ListValue<KX_Camera> *camList);
   EXP_ListValue<KX_FontObject> *GetFontList() const;
+  /// Update the text of the font at the end of the logic frame.
+  void AddModifiedFont(KX_FontObject *font);
 
   /** Find the currently active camera. */
   KX_Camera *GetActiveCamera();
@@ -501,6 +525,17 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   // Enable/disable activity culling.
   void SetActivityCulling(bool b);
 
+  KX_ActivityCullingGrid &GetActivityCullingGrid();
+
+  KX_PickingCache &GetPickingCache();
+  KX_StreamingManager *GetStreamingManager() const;
+
+  /// Save the world transform of all the objects before a logic and physics step.
+  void SaveTickTransforms();
+  void SetInterpolationFactor(float factor);
+  unsigned int GetInterpolationTick() const;
+  float GetInterpolationFactor() const;
+
   // use of DBVT tree for camera culling
   void SetDbvtCulling(bool b)
   {
@@ -588,6 +623,8 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
                                       const EXP_PYATTRIBUTE_DEF *attrdef);
   static PyObject *pyattr_get_filter_manager(EXP_PyObjectPlus *self_v,
                                              const EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_streaming(EXP_PyObjectPlus *self_v,
+                                        const EXP_PYATTRIBUTE_DEF *attrdef);
   static PyObject *pyattr_get_active_camera(EXP_PyObjectPlus *self_v,
                                             const EXP_PYATTRIBUTE_DEF *attrdef);
   static int pyattr_set_active_camera(EXP_PyObjectPlus *self_v,
@@ -608,6 +645,8 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   static int pyattr_set_remove_callback(EXP_PyObjectPlus *self_v,
                                         const EXP_PYATTRIBUTE_DEF *attrdef,
                                         PyObject *value);
+  static PyObject *pyattr_get_activity_culling_updates(EXP_PyObjectPlus *self_v,
+                                                       const EXP_PYATTRIBUTE_DEF *attrdef);
   static PyObject *pyattr_get_gravity(EXP_PyObjectPlus *self_v,
                                       const EXP_PYATTRIBUTE_DEF *attrdef);
   static int pyattr_set_gravity(EXP_PyObjectPlus *self_v,
@@ -0,0 +1,121 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_SoundVoiceManager.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_SoundVoiceManager.h"
+
+#include <algorithm>
+
+#include "CM_List.h"
+#include "SCA_SoundActuator.h"
+
+KX_SoundVoiceManager::KX_SoundVoiceManager()
+    : m_maxVoices(0), m_audibleGain(0.001f), m_numVirtualVoices(0), m_time(0.0)
+{
+}
+
+KX_SoundVoiceManager::~KX_SoundVoiceManager()
+{
+}
+
+void KX_SoundVoiceManager::AddVoice(SCA_SoundActuator *voice)
+{
+  CM_ListAddIfNotFound(m_voices, voice);
+}
+
+void KX_SoundVoiceManager::RemoveVoice(SCA_SoundActuator *voice)
+{
+  CM_ListRemoveIfFound(m_voices, voice);
+}
+
+void KX_SoundVoiceManager::Update(double time)
+{
+  m_time = time;
+  m_numVirtualVoices = 0;
+
+  if (m_voices.empty()) {
+    return;
+  }
+
+  // The most important voices first, the loudest ones for a same priority.
+  std::stable_sort(
+      m_voices.begin(), m_voices.end(), [](SCA_SoundActuator *a, SCA_SoundActuator *b) {
+        if (a->GetPriority() != b->GetPriority()) {
+          return a->GetPriority() > b->GetPriority();
+        }
+        return a->GetVoiceGain() > b->GetVoiceGain();
+      });
+
+  unsigned int numRealVoices = 0;
+  /* Virtualizing a voice could stop it when it ended while virtual,
+   * iterate over a copy as it is then removed from the list. */
+  const std::vector<SCA_SoundActuator *> voices = m_voices;
+  for (SCA_SoundActuator *voice : voices) {
+    const bool real = (voice->GetVoiceGain() >= m_audibleGain) &&
+                      (m_maxVoices == 0 || numRealVoices < m_maxVoices);
+    if (real) {
+      ++numRealVoices;
+    }
+    else {
+      ++m_numVirtualVoices;
+    }
+    voice->SetVirtual(!real, time);
+  }
+}
+
+unsigned int KX_SoundVoiceManager::GetMaxVoices() const
+{
+  return m_maxVoices;
+}
+
+void KX_SoundVoiceManager::SetMaxVoices(unsigned int maxVoices)
+{
+  m_maxVoices = maxVoices;
+}
+
+float KX_SoundVoiceManager::GetAudibleGain() const
+{
+  return m_audibleGain;
+}
+
+void KX_SoundVoiceManager::SetAudibleGain(float gain)
+{
+  m_audibleGain = gain;
+}
+
+unsigned int KX_SoundVoiceManager::GetNumVoices() const
+{
+  return m_voices.size();
+}
+
+unsigned int KX_SoundVoiceManager::GetNumVirtualVoices() const
+{
+  return m_numVirtualVoices;
+}
+
+double KX_SoundVoiceManager::GetTime() const
+{
+  return m_time;
+}
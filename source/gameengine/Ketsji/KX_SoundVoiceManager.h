@@ -0,0 +1,70 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_SoundVoiceManager.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <vector>
+
+class SCA_SoundActuator;
+
+/** Virtualization of the sounds played by the sound actuators.
+ * Each frame the playing sounds are sorted by priority and estimated gain, the ones
+ * inaudible or exceeding the maximum number of voices are paused so that they are not
+ * read and mixed by the audio device. A virtual sound keeps track of its play time and
+ * resumes at the position it would have reached once it is audible again.
+ */
+class KX_SoundVoiceManager {
+ private:
+  /// All the playing sounds, real or virtual.
+  std::vector<SCA_SoundActuator *> m_voices;
+  /// Maximum number of real voices, 0 for no limit.
+  unsigned int m_maxVoices;
+  /// Gain under which a sound is inaudible.
+  float m_audibleGain;
+  /// Number of virtual voices after the last update.
+  unsigned int m_numVirtualVoices;
+  /// Time of the last update.
+  double m_time;
+
+ public:
+  KX_SoundVoiceManager();
+  ~KX_SoundVoiceManager();
+
+  void AddVoice(SCA_SoundActuator *voice);
+  void RemoveVoice(SCA_SoundActuator *voice);
+
+  /// Virtualize or resume the voices depending on their priority and gain.
+  void Update(double time);
+
+  unsigned int GetMaxVoices() const;
+  void SetMaxVoices(unsigned int maxVoices);
+  float GetAudibleGain() const;
+  void SetAudibleGain(float gain);
+
+  unsigned int GetNumVoices() const;
+  unsigned int GetNumVirtualVoices() const;
+  double GetTime() const;
+};
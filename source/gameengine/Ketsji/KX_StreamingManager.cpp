@@ -0,0 +1,498 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_StreamingManager.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_StreamingManager.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#include "BLI_fileops.h"
+#include "BLI_path_utils.hh"
+#include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
+#include "MEM_guardedalloc.h"
+
+#include "BL_Converter.h"
+#include "CM_Message.h"
+#include "KX_GameObject.h"
+#include "KX_Globals.h"
+#include "KX_KetsjiEngine.h"
+#include "KX_LibLoadStatus.h"
+#include "KX_Scene.h"
+#include "MT_Vector2.h"
+
+static void read_cell_task(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  KX_StreamingManager::Cell *cell = static_cast<KX_StreamingManager::Cell *>(taskdata);
+  cell->m_data = BLI_file_read_binary_as_mem(cell->m_path.c_str(), 0, &cell->m_size);
+  cell->m_readDone = true;
+}
+
+KX_StreamingManager::KX_StreamingManager(KX_Scene *scene)
+    : m_scene(scene),
+      m_focus(nullptr),
+      m_cellSize(100.0f),
+      m_loadRadius(150.0f),
+      m_unloadRadius(200.0f),
+      m_prefetchTime(1.0f),
+      m_maxLoadsPerFrame(1),
+      m_maxFreesPerFrame(1),
+      m_maxPendingLoads(4),
+      m_taskPool(nullptr)
+{
+}
+
+KX_StreamingManager::~KX_StreamingManager()
+{
+  if (m_taskPool) {
+    // The reading tasks use the cells.
+    BLI_task_pool_work_and_wait(m_taskPool);
+    BLI_task_pool_free(m_taskPool);
+  }
+
+  for (std::unique_ptr<Cell> &cell : m_cells) {
+    if (cell->m_data) {
+      MEM_freeN(cell->m_data);
+    }
+  }
+}
+
+KX_StreamingManager::Cell *KX_StreamingManager::FindCell(int x, int y) const
+{
+  for (const std::unique_ptr<Cell> &cell : m_cells) {
+    if (cell->m_x == x && cell->m_y == y) {
+      return cell.get();
+    }
+  }
+
+  return nullptr;
+}
+
+bool KX_StreamingManager::AddCell(int x, int y, const std::string &path)
+{
+  if (FindCell(x, y)) {
+    return false;
+  }
+
+  Cell *cell = new Cell();
+  cell->m_x = x;
+  cell->m_y = y;
+  cell->m_path = path;
+  cell->m_state = CELL_UNLOADED;
+  cell->m_data = nullptr;
+  cell->m_size = 0;
+  cell->m_readDone = false;
+  cell->m_status = nullptr;
+  cell->m_fileSize = 0;
+  cell->m_distance = FLT_MAX;
+  cell->m_priority = FLT_MAX;
+
+  m_cells.emplace_back(cell);
+
+  return true;
+}
+
+KX_GameObject *KX_StreamingManager::GetFocus() const
+{
+  return m_focus;
+}
+
+void KX_StreamingManager::SetFocus(KX_GameObject *focus)
+{
+  m_focus = focus;
+}
+
+void KX_StreamingManager::RemoveObject(KX_GameObject *gameobj)
+{
+  if (m_focus == gameobj) {
+    m_focus = nullptr;
+  }
+}
+
+void KX_StreamingManager::UpdatePriorities()
+{
+  const MT_Vector3 &position = m_focus->NodeGetWorldPosition();
+  const MT_Vector3 predicted = position + m_focus->GetLinearVelocity() * m_prefetchTime;
+
+  for (std::unique_ptr<Cell> &cell : m_cells) {
+    const MT_Vector2 center((cell->m_x + 0.5f) * m_cellSize, (cell->m_y + 0.5f) * m_cellSize);
+    cell->m_distance = (MT_Vector2(position.x(), position.y()) - center).length();
+    const float predictedDistance = (MT_Vector2(predicted.x(), predicted.y()) - center).length();
+    cell->m_priority = std::min(cell->m_distance, predictedDistance);
+  }
+}
+
+void KX_StreamingManager::LinkCell(BL_Converter *converter, Cell *cell)
+{
+  char *err_str = nullptr;
+  KX_LibLoadStatus *status = converter->LinkBlendFileMemory(cell->m_data,
+                                                           cell->m_size,
+                                                           cell->m_path.c_str(),
+                                                           (char *)"Scene",
+                                                           m_scene,
+                                                           &err_str,
+                                                           BL_Converter::LIB_LOAD_ASYNC);
+
+  // The file content is only used to link the data blocks.
+  cell->m_fileSize = cell->m_size;
+  DiscardCellData(cell);
+
+  if (status) {
+    cell->m_status = status;
+    cell->m_state = CELL_LOADING;
+  }
+  else {
+    CM_Error("could not stream cell (" << cell->m_x << ", " << cell->m_y << ") \"" << cell->m_path
+                                       << "\": " << (err_str ? err_str : ""));
+    cell->m_state = CELL_FAILED;
+  }
+}
+
+void KX_StreamingManager::DiscardCellData(Cell *cell)
+{
+  if (cell->m_data) {
+    MEM_freeN(cell->m_data);
+    cell->m_data = nullptr;
+  }
+  cell->m_size = 0;
+}
+
+void KX_StreamingManager::Update()
+{
+  if (m_cells.empty()) {
+    return;
+  }
+
+  int numPendingLoads = 0;
+  for (std::unique_ptr<Cell> &cell : m_cells) {
+    if (cell->m_state == CELL_READING && cell->m_readDone) {
+      if (cell->m_data) {
+        cell->m_state = CELL_READ;
+      }
+      else {
+        CM_Error("could not read streaming cell file \"" << cell->m_path << "\"");
+        cell->m_state = CELL_FAILED;
+      }
+    }
+    // The asynchronous loads are finished when merged at the beginning of the frame.
+    else if (cell->m_state == CELL_LOADING && cell->m_status->IsFinished()) {
+      cell->m_status = nullptr;
+      cell->m_state = CELL_RESIDENT;
+    }
+
+    if (ELEM(cell->m_state, CELL_READING, CELL_READ, CELL_LOADING)) {
+      ++numPendingLoads;
+    }
+  }
+
+  if (!m_focus) {
+    return;
+  }
+
+  UpdatePriorities();
+
+  // The nearest cells first.
+  std::vector<Cell *> cells(m_cells.size());
+  std::transform(m_cells.begin(),
+                 m_cells.end(),
+                 cells.begin(),
+                 [](const std::unique_ptr<Cell> &cell) { return cell.get(); });
+  std::sort(cells.begin(), cells.end(), [](const Cell *a, const Cell *b) {
+    return a->m_priority < b->m_priority;
+  });
+
+  BL_Converter *converter = KX_GetActiveEngine()->GetConverter();
+  int numLoads = 0;
+
+  for (Cell *cell : cells) {
+    switch (cell->m_state) {
+      case CELL_UNLOADED: {
+        if (cell->m_priority <= m_loadRadius && numPendingLoads < m_maxPendingLoads) {
+          if (!m_taskPool) {
+            m_taskPool = BLI_task_pool_create(nullptr, TASK_PRIORITY_LOW);
+          }
+          cell->m_readDone = false;
+          cell->m_state = CELL_READING;
+          BLI_task_pool_push(m_taskPool, read_cell_task, cell, false, nullptr);
+          ++numPendingLoads;
+        }
+        break;
+      }
+      case CELL_READ: {
+        // The focus went away while reading the file.
+        if (cell->m_priority > m_unloadRadius) {
+          DiscardCellData(cell);
+          cell->m_state = CELL_UNLOADED;
+        }
+        else if (numLoads < m_maxLoadsPerFrame) {
+          LinkCell(converter, cell);
+          ++numLoads;
+        }
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+  }
+
+  // The farthest cells first.
+  int numFrees = 0;
+  for (std::vector<Cell *>::reverse_iterator it = cells.rbegin(), end = cells.rend();
+       it != end && numFrees < m_maxFreesPerFrame;
+       ++it)
+  {
+    Cell *cell = *it;
+    if (cell->m_state == CELL_RESIDENT && cell->m_priority > m_unloadRadius) {
+      converter->FreeBlendFile(cell->m_path);
+      cell->m_state = CELL_UNLOADED;
+      cell->m_fileSize = 0;
+      ++numFrees;
+    }
+  }
+}
+
+unsigned int KX_StreamingManager::GetNumCells(CellState state) const
+{
+  return std::count_if(m_cells.begin(), m_cells.end(), [state](const std::unique_ptr<Cell> &cell) {
+    return cell->m_state == state;
+  });
+}
+
+size_t KX_StreamingManager::GetResidentFileSize() const
+{
+  size_t size = 0;
+  for (const std::unique_ptr<Cell> &cell : m_cells) {
+    if (cell->m_state == CELL_RESIDENT) {
+      size += cell->m_fileSize;
+    }
+  }
+
+  return size;
+}
+
+#ifdef WITH_PYTHON
+
+PyMethodDef KX_StreamingManager::Methods[] = {
+    EXP_PYMETHODTABLE(KX_StreamingManager, addCell),
+    EXP_PYMETHODTABLE(KX_StreamingManager, getCellState),
+    EXP_PYMETHODTABLE_NOARGS(KX_StreamingManager, getStatistics),
+    {nullptr, nullptr}  // Sentinel
+};
+
+PyAttributeDef KX_StreamingManager::Attributes[] = {
+    EXP_PYATTRIBUTE_RW_FUNCTION("focus", KX_StreamingManager, pyattr_get_focus, pyattr_set_focus),
+    EXP_PYATTRIBUTE_FLOAT_RW("cellSize", 0.001f, FLT_MAX, KX_StreamingManager, m_cellSize),
+    EXP_PYATTRIBUTE_FLOAT_RW("loadRadius", 0.0f, FLT_MAX, KX_StreamingManager, m_loadRadius),
+    EXP_PYATTRIBUTE_FLOAT_RW("unloadRadius", 0.0f, FLT_MAX, KX_StreamingManager, m_unloadRadius),
+    EXP_PYATTRIBUTE_FLOAT_RW("prefetchTime", 0.0f, FLT_MAX, KX_StreamingManager, m_prefetchTime),
+    EXP_PYATTRIBUTE_INT_RW(
+        "maxLoadsPerFrame", 1, INT_MAX, true, KX_StreamingManager, m_maxLoadsPerFrame),
+    EXP_PYATTRIBUTE_INT_RW(
+        "maxFreesPerFrame", 1, INT_MAX, true, KX_StreamingManager, m_maxFreesPerFrame),
+    EXP_PYATTRIBUTE_INT_RW(
+        "maxPendingLoads", 1, INT_MAX, true, KX_StreamingManager, m_maxPendingLoads),
+    EXP_PYATTRIBUTE_RW_FUNCTION(
+        "maxMergesPerFrame", KX_StreamingManager, pyattr_get_max_merges, pyattr_set_max_merges),
+    EXP_PYATTRIBUTE_NULL  // Sentinel
+};
+
+PyTypeObject KX_StreamingManager::Type = {PyVarObject_HEAD_INIT(nullptr, 0) "KX_StreamingManager",
+                                          sizeof(EXP_PyObjectPlus_Proxy),
+                                          0,
+                                          py_base_dealloc,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          py_base_repr,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          Methods,
+                                          0,
+                                          0,
+                                          &EXP_PyObjectPlus::Type,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          0,
+                                          py_base_new};
+
+EXP_PYMETHODDEF_DOC(KX_StreamingManager, addCell, " addCell(x, y, filepath)")
+{
+  int x;
+  int y;
+  const char *path;
+
+  if (!PyArg_ParseTuple(args, "iis:addCell", &x, &y, &path)) {
+    return nullptr;
+  }
+
+  char abs_path[FILE_MAX];
+  // Make the path absolute
+  BLI_strncpy(abs_path, path, sizeof(abs_path));
+  BLI_path_abs(abs_path, KX_GetMainPath().c_str());
+
+  if (!AddCell(x, y, abs_path)) {
+    PyErr_Format(PyExc_ValueError,
+                 "streaming.addCell(x, y, filepath): KX_StreamingManager, "
+                 "found existing cell at (%i, %i)",
+                 x,
+                 y);
+    return nullptr;
+  }
+
+  Py_RETURN_NONE;
+}
+
+EXP_PYMETHODDEF_DOC(KX_StreamingManager, getCellState, " getCellState(x, y)")
+{
+  int x;
+  int y;
+
+  if (!PyArg_ParseTuple(args, "ii:getCellState", &x, &y)) {
+    return nullptr;
+  }
+
+  Cell *cell = FindCell(x, y);
+  if (!cell) {
+    PyErr_Format(PyExc_ValueError,
+                 "streaming.getCellState(x, y): KX_StreamingManager, no cell at (%i, %i)",
+                 x,
+                 y);
+    return nullptr;
+  }
+
+  return PyLong_FromLong(cell->m_state);
+}
+
+EXP_PYMETHODDEF_DOC_NOARGS(KX_StreamingManager, getStatistics, " getStatistics()")
+{
+  PyObject *stats = PyDict_New();
+
+  const std::pair<const char *, unsigned int> counts[] = {
+      {"cells", m_cells.size()},
+      {"resident", GetNumCells(CELL_RESIDENT)},
+      {"reading", GetNumCells(CELL_READING) + GetNumCells(CELL_READ)},
+      {"loading", GetNumCells(CELL_LOADING)},
+      {"failed", GetNumCells(CELL_FAILED)},
+  };
+
+  for (const std::pair<const char *, unsigned int> &count : counts) {
+    PyObject *value = PyLong_FromUnsignedLong(count.second);
+    PyDict_SetItemString(stats, count.first, value);
+    Py_DECREF(value);
+  }
+
+  PyObject *value = PyLong_FromSize_t(GetResidentFileSize());
+  PyDict_SetItemString(stats, "residentFileSize", value);
+  Py_DECREF(value);
+
+  value = PyLong_FromSize_t(MEM_get_memory_in_use());
+  PyDict_SetItemString(stats, "memoryInUse", value);
+  Py_DECREF(value);
+
+  return stats;
+}
+
+PyObject *KX_StreamingManager::pyattr_get_focus(EXP_PyObjectPlus *self_v,
+                                                const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_StreamingManager *self = static_cast<KX_StreamingManager *>(self_v);
+
+  if (self->m_focus) {
+    return self->m_focus->GetProxy();
+  }
+
+  Py_RETURN_NONE;
+}
+
+int KX_StreamingManager::pyattr_set_focus(EXP_PyObjectPlus *self_v,
+                                          const EXP_PYATTRIBUTE_DEF *attrdef,
+                                          PyObject *value)
+{
+  KX_StreamingManager *self = static_cast<KX_StreamingManager *>(self_v);
+  KX_GameObject *focus;
+
+  if (!ConvertPythonToGameObject(self->m_scene->GetLogicManager(),
+                                 value,
+                                 &focus,
+                                 true,
+                                 "streaming.focus = value: KX_StreamingManager")) {
+    return PY_SET_ATTR_FAIL;
+  }
+
+  self->SetFocus(focus);
+
+  return PY_SET_ATTR_SUCCESS;
+}
+
+PyObject *KX_StreamingManager::pyattr_get_max_merges(EXP_PyObjectPlus *self_v,
+                                                     const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  return PyLong_FromLong(KX_GetActiveEngine()->GetConverter()->GetMaxMergesPerFrame());
+}
+
+int KX_StreamingManager::pyattr_set_max_merges(EXP_PyObjectPlus *self_v,
+                                               const EXP_PYATTRIBUTE_DEF *attrdef,
+                                               PyObject *value)
+{
+  const int merges = PyLong_AsLong(value);
+  if (merges == -1 && PyErr_Occurred()) {
+    PyErr_SetString(PyExc_TypeError, "streaming.maxMergesPerFrame = int: KX_StreamingManager");
+    return PY_SET_ATTR_FAIL;
+  }
+  if (merges < 0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "streaming.maxMergesPerFrame = int: KX_StreamingManager, expected a positive "
+                    "value or 0");
+    return PY_SET_ATTR_FAIL;
+  }
+
+  KX_GetActiveEngine()->GetConverter()->SetMaxMergesPerFrame(merges);
+
+  return PY_SET_ATTR_SUCCESS;
+}
+
+#endif  // WITH_PYTHON
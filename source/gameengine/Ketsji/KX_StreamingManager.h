@@ -0,0 +1,146 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_StreamingManager.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "EXP_PyObjectPlus.h"
+
+class BL_Converter;
+class KX_GameObject;
+class KX_LibLoadStatus;
+class KX_Scene;
+struct TaskPool;
+
+/** World streaming of a scene split in a grid of cells, each cell is a blend file
+ * of which the scenes are merged into the scene when the cell is near a focus object
+ * and freed when it is far.
+ *
+ * The cell files are read from the disk in worker threads, then linked and converted
+ * asynchronously as a LibLoad. The number of cells linked, merged and freed per frame
+ * is limited to avoid stalls when moving from a cell to another.
+ */
+class KX_StreamingManager : public EXP_PyObjectPlus {
+  Py_Header
+
+ public:
+  enum CellState {
+    CELL_UNLOADED = 0,
+    /// The file is being read by a worker thread.
+    CELL_READING,
+    /// The file content is waiting to be linked.
+    CELL_READ,
+    /// The file is linked and its scenes converted and merged asynchronously.
+    CELL_LOADING,
+    CELL_RESIDENT,
+    /// The file couldn't be read or linked, the cell is not loaded again.
+    CELL_FAILED,
+  };
+
+  struct Cell {
+    int m_x;
+    int m_y;
+    std::string m_path;
+    CellState m_state;
+    /// File content read by a worker thread.
+    void *m_data;
+    size_t m_size;
+    std::atomic<bool> m_readDone;
+    KX_LibLoadStatus *m_status;
+    /// Size of the file of the cell, used as an estimate of its memory.
+    size_t m_fileSize;
+    /// Distance to the focus object.
+    float m_distance;
+    /// Minimal distance to the focus object and its predicted position.
+    float m_priority;
+  };
+
+ private:
+  KX_Scene *m_scene;
+  std::vector<std::unique_ptr<Cell>> m_cells;
+  KX_GameObject *m_focus;
+
+  /// Size of a cell along the X and Y axes.
+  float m_cellSize;
+  /// Distance under which the cells are loaded.
+  float m_loadRadius;
+  /// Distance over which the cells are freed, greater than the load radius.
+  float m_unloadRadius;
+  /// Time used to predict the position of the focus object from its velocity.
+  float m_prefetchTime;
+  /// Maximum number of cells linked per frame.
+  int m_maxLoadsPerFrame;
+  /// Maximum number of cells freed per frame.
+  int m_maxFreesPerFrame;
+  /// Maximum number of cells read or converted at the same time.
+  int m_maxPendingLoads;
+
+  TaskPool *m_taskPool;
+
+  Cell *FindCell(int x, int y) const;
+  /// Compute the distances and priorities of the cells from the focus object.
+  void UpdatePriorities();
+  void LinkCell(BL_Converter *converter, Cell *cell);
+  void DiscardCellData(Cell *cell);
+
+ public:
+  KX_StreamingManager(KX_Scene *scene);
+  virtual ~KX_StreamingManager();
+
+  /// Register a cell, return false if a cell already exists at the same coordinates.
+  bool AddCell(int x, int y, const std::string &path);
+
+  KX_GameObject *GetFocus() const;
+  void SetFocus(KX_GameObject *focus);
+  /// Forget the focus object when it is removed from the scene.
+  void RemoveObject(KX_GameObject *gameobj);
+
+  /// Read, link and free the cells depending on the focus position, called once per frame.
+  void Update();
+
+  unsigned int GetNumCells(CellState state) const;
+  size_t GetResidentFileSize() const;
+
+#ifdef WITH_PYTHON
+  EXP_PYMETHOD_DOC(KX_StreamingManager, addCell);
+  EXP_PYMETHOD_DOC(KX_StreamingManager, getCellState);
+  EXP_PYMETHOD_DOC_NOARGS(KX_StreamingManager, getStatistics);
+
+  static PyObject *pyattr_get_focus(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
+  static int pyattr_set_focus(EXP_PyObjectPlus *self_v,
+                              const EXP_PYATTRIBUTE_DEF *attrdef,
+                              PyObject *value);
+  static PyObject *pyattr_get_max_merges(EXP_PyObjectPlus *self_v,
+                                         const EXP_PYATTRIBUTE_DEF *attrdef);
+  static int pyattr_set_max_merges(EXP_PyObjectPlus *self_v,
+                                   const EXP_PYATTRIBUTE_DEF *attrdef,
+                                   PyObject *value);
+#endif  // WITH_PYTHON
+};
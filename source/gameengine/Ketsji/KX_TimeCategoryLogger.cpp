@@ -109,3 +109,8 @@ double KX_TimeCategoryLogger::GetAverage()
 
   return time;
 }
+
+double KX_TimeCategoryLogger::GetLastMeasurement(TimeCategory tc)
+{
+  return m_loggers[tc].GetLastMeasurement();
+}
@@ -113,6 +113,11 @@ class KX_TimeCategoryLogger {
    */
   double GetAverage();
 
+  /**
+   * Returns the last complete measurement time of a category.
+   */
+  double GetLastMeasurement(TimeCategory tc);
+
  protected:
   const CM_Clock &m_clock;
   /// Storage for the loggers.
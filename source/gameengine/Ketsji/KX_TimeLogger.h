@@ -87,6 +87,12 @@ class KX_TimeLogger {
    */
   double GetAverage() const;
 
+  /**
+   * Returns the last complete measurement.
+   * \return The measurement before the current one.
+   */
+  double GetLastMeasurement() const;
+
  protected:
   /// Storage for the measurements.
   std::deque<double> m_measurements;
@@ -387,6 +387,8 @@ PyMethodDef KX_VehicleWrapper::Methods[] = {
 PyAttributeDef KX_VehicleWrapper::Attributes[] = {
     EXP_PYATTRIBUTE_RW_FUNCTION(
         "rayMask", KX_VehicleWrapper, pyattr_get_ray_mask, pyattr_set_ray_mask),
+    EXP_PYATTRIBUTE_RW_FUNCTION(
+        "useConvexCast", KX_VehicleWrapper, pyattr_get_convex_cast, pyattr_set_convex_cast),
     EXP_PYATTRIBUTE_RO_FUNCTION("constraint_id", KX_VehicleWrapper, pyattr_get_constraintId),
     EXP_PYATTRIBUTE_RO_FUNCTION("constraint_type", KX_VehicleWrapper, pyattr_get_constraintType),
     EXP_PYATTRIBUTE_NULL  // Sentinel
@@ -438,4 +440,29 @@ int KX_VehicleWrapper::pyattr_set_ray_mask(EXP_PyObjectPlus *self,
   return PY_SET_ATTR_SUCCESS;
 }
 
+PyObject *KX_VehicleWrapper::pyattr_get_convex_cast(EXP_PyObjectPlus *self,
+                                                    const struct EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_VehicleWrapper *wrapper = static_cast<KX_VehicleWrapper *>(self);
+  return PyBool_FromLong(wrapper->m_vehicle->GetConvexCast());
+}
+
+int KX_VehicleWrapper::pyattr_set_convex_cast(EXP_PyObjectPlus *self,
+                                              const struct EXP_PYATTRIBUTE_DEF *attrdef,
+                                              PyObject *value)
+{
+  KX_VehicleWrapper *wrapper = static_cast<KX_VehicleWrapper *>(self);
+
+  const int convexCast = PyObject_IsTrue(value);
+  if (convexCast == -1) {
+    PyErr_SetString(PyExc_TypeError,
+                    "useConvexCast = bool: KX_VehicleWrapper, expected True or False");
+    return PY_SET_ATTR_FAIL;
+  }
+
+  wrapper->m_vehicle->SetConvexCast(convexCast);
+
+  return PY_SET_ATTR_SUCCESS;
+}
+
 #endif  // WITH_PYTHON
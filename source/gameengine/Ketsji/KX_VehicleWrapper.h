@@ -51,6 +51,11 @@ class KX_VehicleWrapper : public EXP_Value {
   static int pyattr_set_ray_mask(EXP_PyObjectPlus *self,
                                  const struct EXP_PYATTRIBUTE_DEF *attrdef,
                                  PyObject *value);
+  static PyObject *pyattr_get_convex_cast(EXP_PyObjectPlus *self,
+                                          const struct EXP_PYATTRIBUTE_DEF *attrdef);
+  static int pyattr_set_convex_cast(EXP_PyObjectPlus *self,
+                                    const struct EXP_PYATTRIBUTE_DEF *attrdef,
+                                    PyObject *value);
   static PyObject *pyattr_get_constraintId(EXP_PyObjectPlus *self_v,
                                            const EXP_PYATTRIBUTE_DEF *attrdef);
   static PyObject *pyattr_get_constraintType(EXP_PyObjectPlus *self_v,
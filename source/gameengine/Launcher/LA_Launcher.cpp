@@ -45,7 +45,9 @@
 #include "GHOST_C-api.h"
 #include "GHOST_ISystem.hh"
 #include "GPG_Canvas.h"
+#include "KX_GameObject.h"
 #include "KX_Globals.h"
+#include "KX_InputRecorder.h"
 #include "KX_NetworkMessageManager.h"
 #include "KX_PyConstraintBinding.h"
 #include "KX_PythonInit.h"
@@ -82,6 +84,8 @@ LA_Launcher::LA_Launcher(GHOST_ISystem *system,
       m_kxsystem(nullptr),
       m_inputDevice(nullptr),
       m_eventConsumer(nullptr),
+      m_inputRecorder(nullptr),
+      m_inputRecorderError(false),
       m_canvas(nullptr),
       m_rasterizer(nullptr),
       m_converter(nullptr),
@@ -93,7 +97,10 @@ LA_Launcher::LA_Launcher(GHOST_ISystem *system,
       m_stereoMode(stereoMode),
       m_argc(argc),
       m_argv(argv),
-      m_audioDeviceIsInitialized(false)
+      m_audioDeviceIsInitialized(false),
+      m_fakeRender(false),
+      m_fakeRenderFrames(0),
+      m_fakeRenderHash(14695981039346656037ULL)
 {
   m_pythonConsole.use = false;
 }
@@ -114,6 +121,11 @@ KX_ExitRequest LA_Launcher::GetExitRequested()
   return m_exitRequested;
 }
 
+bool LA_Launcher::GetInputRecorderError() const
+{
+  return m_inputRecorderError;
+}
+
 GlobalSettings *LA_Launcher::GetGlobalSettings()
 {
   return m_ketsjiEngine->GetGlobalSettings();
@@ -142,6 +154,9 @@ void LA_Launcher::InitEngine()
   bool frameRate = (SYS_GetCommandLineInt(syshandle, "show_framerate", 0) != 0);
   bool nodepwarnings = (SYS_GetCommandLineInt(syshandle, "ignore_deprecation_warnings", 1) != 0);
   bool restrictAnimFPS = (gm.flag & GAME_RESTRICT_ANIM_UPDATES) != 0;
+  const KX_FramePipeline framePipeline = (KX_FramePipeline)SYS_GetCommandLineInt(
+      syshandle, "frame_pipeline", (int)KX_FramePipeline::NONE);
+  m_fakeRender = (SYS_GetCommandLineInt(syshandle, "fake_render", 0) != 0);
 
   // Setup python console keys used as shortcut.
   for (unsigned short i = 0; i < 4; ++i) {
@@ -214,6 +229,28 @@ void LA_Launcher::InitEngine()
   m_ketsjiEngine->SetRasterizer(m_rasterizer);
   m_ketsjiEngine->SetNetworkMessageManager(m_networkMessageManager);
 
+  // Record or replay the inputs and frame times, and write the timings of each frame.
+  const std::string recordPath = SYS_GetCommandLineString(syshandle, "record_input", "");
+  const std::string replayPath = SYS_GetCommandLineString(syshandle, "replay_input", "");
+  const std::string timingsPath = SYS_GetCommandLineString(syshandle, "input_timings", "");
+  m_inputRecorderError = false;
+  if (!replayPath.empty()) {
+    m_inputRecorder = new KX_InputRecorder(KX_InputRecorder::REPLAY, replayPath);
+    // The game is not run live instead, see EngineMainLoop.
+    m_inputRecorderError = !m_inputRecorder->Read();
+  }
+  else if (!recordPath.empty()) {
+    m_inputRecorder = new KX_InputRecorder(KX_InputRecorder::RECORD, recordPath);
+    m_inputRecorderError = !m_inputRecorder->Create();
+  }
+  if (!timingsPath.empty()) {
+    if (!m_inputRecorder) {
+      m_inputRecorder = new KX_InputRecorder(KX_InputRecorder::NONE, "");
+    }
+    m_inputRecorder->SetTimingsFile(timingsPath);
+  }
+  m_ketsjiEngine->SetInputRecorder(m_inputRecorder);
+
   DEV_Joystick::Init();
 
   m_ketsjiEngine->SetExitKey(BL_ConvertKeyCode(gm.exitkey));
@@ -225,6 +262,9 @@ void LA_Launcher::InitEngine()
 
   m_ketsjiEngine->SetFlag(flags, true);
   m_ketsjiEngine->SetRender(true);
+  if (framePipeline >= KX_FramePipeline::NONE && framePipeline <= KX_FramePipeline::SEQUENTIAL) {
+    m_ketsjiEngine->SetFramePipeline(framePipeline);
+  }
 
   m_ketsjiEngine->SetTicRate(gm.ticrate);
   m_ketsjiEngine->SetMaxLogicFrame(gm.maxlogicstep);
@@ -295,6 +335,21 @@ void LA_Launcher::ExitEngine()
   DEV_Joystick::Close();
   m_ketsjiEngine->StopEngine();
 
+  if (m_inputRecorder) {
+    // Don't write the timings of a game which was not run.
+    if (!m_inputRecorderError && !m_inputRecorder->Write()) {
+      m_inputRecorderError = true;
+    }
+    m_ketsjiEngine->SetInputRecorder(nullptr);
+    delete m_inputRecorder;
+    m_inputRecorder = nullptr;
+  }
+
+  if (m_fakeRender) {
+    CM_Message("Fake render: " << m_fakeRenderFrames << " frames, transform hash " << std::hex
+                               << m_fakeRenderHash << std::dec);
+  }
+
 #ifdef WITH_PYTHON
 
   /* Clears the dictionary by hand:
@@ -442,6 +497,26 @@ void LA_Launcher::RenderEngine()
   m_ketsjiEngine->Render();
 }
 
+void LA_Launcher::FakeRenderEngine()
+{
+  /* Hash the transforms the render would send to the depsgraph. The threaded and sequential
+   * frame pipelines render the same transforms, but one physics step later than without
+   * a frame pipeline, so their hashes differ from the one without a frame pipeline. */
+  for (KX_Scene *scene : m_ketsjiEngine->CurrentScenes()) {
+    for (KX_GameObject *gameobj : scene->GetObjectList()) {
+      bool interpolated;
+      float mat[16];
+      gameobj->NodeGetRenderTransform(interpolated).getValue(mat);
+      const unsigned char *bytes = reinterpret_cast<const unsigned char *>(mat);
+      for (unsigned int i = 0; i < sizeof(mat); ++i) {
+        // FNV-1a
+        m_fakeRenderHash = (m_fakeRenderHash ^ bytes[i]) * 1099511628211ULL;
+      }
+    }
+  }
+  ++m_fakeRenderFrames;
+}
+
 #ifdef WITH_PYTHON
 
 bool LA_Launcher::GetPythonMainLoopCode(std::string &pythonCode, std::string &pythonFileName)
@@ -482,10 +557,18 @@ bool LA_Launcher::EngineNextFrame()
 
   if (m_exitRequested == KX_ExitRequest::NO_REQUEST) {
     if (renderFrame) {
-      RenderEngine();
+      if (m_fakeRender) {
+        FakeRenderEngine();
+      }
+      else {
+        RenderEngine();
+      }
     }
   }
 
+  // The physics step of the frame pipeline runs during the render.
+  m_ketsjiEngine->FinishPhysicsStep();
+
   m_system->processEvents(false);
   m_system->dispatchEvents();
 
@@ -508,6 +591,13 @@ bool LA_Launcher::EngineNextFrame()
 
 void LA_Launcher::EngineMainLoop()
 {
+  // The input record to replay or to write is not usable, quit with an error.
+  if (m_inputRecorderError) {
+    m_exitRequested = KX_ExitRequest::QUIT_GAME;
+    m_exitString = "";
+    return;
+  }
+
 #ifdef WITH_PYTHON
   std::string pythonCode;
   std::string pythonFileName;
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 #include "KX_ISystem.h"
@@ -37,6 +38,7 @@ class KX_Scene;
 class KX_ISystem;
 class BL_Converter;
 class KX_NetworkMessageManager;
+class KX_InputRecorder;
 class RAS_ICanvas;
 class DEV_EventConsumer;
 class DEV_InputDevice;
@@ -70,6 +72,10 @@ class LA_Launcher {
   /// The game engine's input device abstraction.
   DEV_InputDevice *m_inputDevice;
   DEV_EventConsumer *m_eventConsumer;
+  /// Record or replay of the inputs, optional.
+  KX_InputRecorder *m_inputRecorder;
+  /// The input record couldn't be read or written, the game is not run.
+  bool m_inputRecorderError;
   /// The game engine's canvas abstraction.
   RAS_ICanvas *m_canvas;
   /// The rasterizer.
@@ -97,6 +103,12 @@ class LA_Launcher {
   /// avoid to run audaspace code if audio device fails to initialize
   bool m_audioDeviceIsInitialized;
 
+  /// Replace the render by a stage only consuming the object transforms, for headless runs.
+  bool m_fakeRender;
+  /// Number of frames and hash of the transforms consumed by the fake render stage.
+  unsigned int m_fakeRenderFrames;
+  uint64_t m_fakeRenderHash;
+
   /// Saved data to restore at the game end.
   struct SavedData {
     int vsync;
@@ -115,6 +127,8 @@ class LA_Launcher {
 
   /// Execute engine render, overrided to render background.
   virtual void RenderEngine();
+  /// Consume the snapshot of the rendered object transforms without drawing.
+  void FakeRenderEngine();
 
 #ifdef WITH_PYTHON
   /** Return true if the user use a valid python script for main loop and copy the python code
@@ -152,6 +166,8 @@ class LA_Launcher {
 #endif  // WITH_PYTHON
 
   KX_ExitRequest GetExitRequested();
+  /// Return true if the input record to replay or to write failed.
+  bool GetInputRecorderError() const;
   const std::string &GetExitString();
   GlobalSettings *GetGlobalSettings();
 
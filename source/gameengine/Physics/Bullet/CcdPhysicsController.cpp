@@ -25,6 +25,10 @@
 
 #include "CcdPhysicsController.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
 #include "BKE_context.hh"
 #include "BKE_mesh.hh"
 #include "BKE_mesh_legacy_convert.hh"
@@ -37,6 +41,12 @@
 #include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
 #include "LinearMath/btConvexHull.h"
 
+#include "BLI_fileops.h"
+#include "BLI_system.h"
+#include "BLI_task.h"
+
+#include BLI_SYSTEM_PID_H
+
 #include "CcdPhysicsEnvironment.h"
 #include "KX_GameObject.h"
 #include "RAS_DisplayArray.h"
@@ -53,6 +63,48 @@ extern bool gDisableDeactivation;
 float gLinearSleepingTreshold;
 float gAngularSleepingTreshold;
 
+/// Same as btKinematicClosestNotMeConvexResultCallback which is private to bullet.
+class CcdCharacterSweepCallback : public btCollisionWorld::ClosestConvexResultCallback {
+ private:
+  btCollisionObject *m_me;
+  const btVector3 m_up;
+  btScalar m_minSlopeDot;
+
+ public:
+  CcdCharacterSweepCallback(btCollisionObject *me, const btVector3 &up, btScalar minSlopeDot)
+      : btCollisionWorld::ClosestConvexResultCallback(btVector3(0.0f, 0.0f, 0.0f),
+                                                      btVector3(0.0f, 0.0f, 0.0f)),
+        m_me(me),
+        m_up(up),
+        m_minSlopeDot(minSlopeDot)
+  {
+    m_collisionFilterGroup = me->getBroadphaseHandle()->m_collisionFilterGroup;
+    m_collisionFilterMask = me->getBroadphaseHandle()->m_collisionFilterMask;
+  }
+
+  virtual btScalar addSingleResult(btCollisionWorld::LocalConvexResult &convexResult,
+                                   bool normalInWorldSpace)
+  {
+    if (convexResult.m_hitCollisionObject == m_me ||
+        !convexResult.m_hitCollisionObject->hasContactResponse())
+    {
+      return 1.0f;
+    }
+
+    const btVector3 hitNormalWorld = normalInWorldSpace ?
+                                         convexResult.m_hitNormalLocal :
+                                         convexResult.m_hitCollisionObject->getWorldTransform()
+                                                 .getBasis() *
+                                             convexResult.m_hitNormalLocal;
+
+    if (m_up.dot(hitNormalWorld) < m_minSlopeDot) {
+      return 1.0f;
+    }
+
+    return ClosestConvexResultCallback::addSingleResult(convexResult, normalInWorldSpace);
+  }
+};
+
 CcdCharacter::CcdCharacter(CcdPhysicsController *ctrl,
                                                                    btMotionState *motionState,
                                                                    btPairCachingGhostObject *ghost,
@@ -62,17 +114,324 @@ CcdCharacter::CcdCharacter(CcdPhysicsController *ctrl,
       m_ctrl(ctrl),
       m_motionState(motionState),
       m_jumps(0),
-      m_maxJumps(1)
+      m_maxJumps(1),
+      m_stepMoving(false),
+      m_sweepShape(nullptr)
+{
+  CreateSweepShape();
+}
+
+CcdCharacter::~CcdCharacter()
+{
+  delete m_sweepShape;
+}
+
+/// Return a copy of a convex shape or nullptr if its type is not supported.
+static btConvexShape *copy_convex_shape(const btConvexShape *shape)
+{
+  btConvexShape *copy = nullptr;
+  switch (shape->getShapeType()) {
+    case BOX_SHAPE_PROXYTYPE: {
+      copy = new btBoxShape(*static_cast<const btBoxShape *>(shape));
+      break;
+    }
+    case SPHERE_SHAPE_PROXYTYPE: {
+      copy = new btSphereShape(*static_cast<const btSphereShape *>(shape));
+      break;
+    }
+    case CAPSULE_SHAPE_PROXYTYPE: {
+      const btCapsuleShape *capsule = static_cast<const btCapsuleShape *>(shape);
+      const int upAxis = capsule->getUpAxis();
+      copy = (upAxis == 0) ? new btCapsuleShapeX(*static_cast<const btCapsuleShapeX *>(shape)) :
+             (upAxis == 1) ? new btCapsuleShape(*capsule) :
+                             new btCapsuleShapeZ(*static_cast<const btCapsuleShapeZ *>(shape));
+      break;
+    }
+    case CYLINDER_SHAPE_PROXYTYPE: {
+      const btCylinderShape *cylinder = static_cast<const btCylinderShape *>(shape);
+      const int upAxis = cylinder->getUpAxis();
+      copy = (upAxis == 0) ? new btCylinderShapeX(*static_cast<const btCylinderShapeX *>(shape)) :
+             (upAxis == 1) ? new btCylinderShape(*cylinder) :
+                             new btCylinderShapeZ(*static_cast<const btCylinderShapeZ *>(shape));
+      break;
+    }
+    case CONE_SHAPE_PROXYTYPE: {
+      const btConeShape *cone = static_cast<const btConeShape *>(shape);
+      const int upAxis = cone->getConeUpIndex();
+      copy = (upAxis == 0) ? new btConeShapeX(*static_cast<const btConeShapeX *>(shape)) :
+             (upAxis == 1) ? new btConeShape(*cone) :
+                             new btConeShapeZ(*static_cast<const btConeShapeZ *>(shape));
+      break;
+    }
+    case CONVEX_HULL_SHAPE_PROXYTYPE: {
+      // Not copied to not share the polyhedron of the shape.
+      const btConvexHullShape *hull = static_cast<const btConvexHullShape *>(shape);
+      if (hull->getNumPoints() == 0) {
+        break;
+      }
+      copy = new btConvexHullShape(
+          &hull->getUnscaledPoints()[0][0], hull->getNumPoints(), sizeof(btVector3));
+      copy->setLocalScaling(hull->getLocalScaling());
+      copy->setMargin(hull->getMargin());
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+
+  return copy;
+}
+
+void CcdCharacter::CreateSweepShape()
+{
+  delete m_sweepShape;
+  m_sweepShape = m_convexShape ? copy_convex_shape(m_convexShape) : nullptr;
+  UpdateSweepShape();
+}
+
+void CcdCharacter::UpdateSweepShape()
+{
+  if (!m_sweepShape) {
+    return;
+  }
+
+  // The scaling of the object could have changed.
+  if (m_sweepShape->getLocalScaling() != m_convexShape->getLocalScaling()) {
+    m_sweepShape->setLocalScaling(m_convexShape->getLocalScaling());
+  }
+  const btScalar margin = m_convexShape->getMargin() + m_addedMargin;
+  if (m_sweepShape->getMargin() != margin) {
+    m_sweepShape->setMargin(margin);
+  }
+}
+
+bool CcdCharacter::HasSweepShape() const
 {
+  return (m_sweepShape != nullptr);
 }
 
 void CcdCharacter::updateAction(btCollisionWorld *collisionWorld, btScalar dt)
 {
-  if (onGround())
+  if (BeginStep(collisionWorld, dt)) {
+    StepUp(collisionWorld);
+    if (m_sweepShape) {
+      StepForward(collisionWorld, dt);
+    }
+    else {
+      // Same as bullet, the margin of the shape is only modified during the sweep.
+      const btScalar margin = m_convexShape->getMargin();
+      m_convexShape->setMargin(margin + m_addedMargin);
+      StepForward(collisionWorld, dt);
+      m_convexShape->setMargin(margin);
+    }
+    StepDown(collisionWorld, dt);
+  }
+  EndStep(collisionWorld);
+}
+
+bool CcdCharacter::BeginStep(btCollisionWorld *collisionWorld, btScalar dt)
+{
+  if (onGround()) {
     m_jumps = 0;
+  }
+
+  preStep(collisionWorld);
+  UpdateSweepShape();
+
+  if (m_AngVel.length2() > 0.0f) {
+    m_AngVel *= btPow(btScalar(1) - m_angularDamping, dt);
+  }
+
+  // Integrate the angular velocity.
+  if (m_AngVel.length2() > 0.0f) {
+    btTransform xform = m_ghostObject->getWorldTransform();
+    const btQuaternion rot(m_AngVel.normalized(), m_AngVel.length() * dt);
+    xform.setRotation(rot * xform.getRotation());
+    m_ghostObject->setWorldTransform(xform);
+
+    m_currentPosition = m_targetPosition = xform.getOrigin();
+    m_currentOrientation = m_targetOrientation = xform.getRotation();
+  }
+
+  m_stepMoving = (m_useWalkDirection ||
+                  (m_velocityTimeInterval > 0.0f && !m_walkDirection.fuzzyZero()));
+  if (!m_stepMoving) {
+    return false;
+  }
+
+  m_wasOnGround = onGround();
+
+  if (m_walkDirection.length2() > 0.0f) {
+    m_walkDirection *= btPow(btScalar(1) - m_linearDamping, dt);
+  }
+
+  m_verticalVelocity *= btPow(btScalar(1) - m_linearDamping, dt);
+
+  // Update fall velocity.
+  m_verticalVelocity -= m_gravity * dt;
+  if (m_verticalVelocity > 0.0f && m_verticalVelocity > m_jumpSpeed) {
+    m_verticalVelocity = m_jumpSpeed;
+  }
+  if (m_verticalVelocity < 0.0f && btFabs(m_verticalVelocity) > btFabs(m_fallSpeed)) {
+    m_verticalVelocity = -btFabs(m_fallSpeed);
+  }
+  m_verticalOffset = m_verticalVelocity * dt;
+
+  m_stepTransform = m_ghostObject->getWorldTransform();
 
-  btKinematicCharacterController::updateAction(collisionWorld, dt);
-  m_motionState->setWorldTransform(getGhostObject()->getWorldTransform());
+  return true;
+}
+
+void CcdCharacter::StepUp(btCollisionWorld *collisionWorld)
+{
+  const btScalar stepHeight = (m_verticalVelocity < 0.0f) ? m_stepHeight : 0.0f;
+
+  btTransform start(m_currentOrientation, m_currentPosition);
+
+  m_targetPosition = m_currentPosition + m_up * stepHeight +
+                     m_jumpAxis * ((m_verticalOffset > 0.0f) ? m_verticalOffset : 0.0f);
+  m_currentPosition = m_targetPosition;
+
+  btTransform end(m_targetOrientation, m_targetPosition);
+
+  CcdCharacterSweepCallback callback(m_ghostObject, -m_up, m_maxSlopeCosine);
+  if (m_useGhostObjectSweepTest) {
+    m_ghostObject->convexSweepTest(m_convexShape,
+                                   start,
+                                   end,
+                                   callback,
+                                   collisionWorld->getDispatchInfo().m_allowedCcdPenetration);
+  }
+  else {
+    collisionWorld->convexSweepTest(m_convexShape,
+                                    start,
+                                    end,
+                                    callback,
+                                    collisionWorld->getDispatchInfo().m_allowedCcdPenetration);
+  }
+
+  if (callback.hasHit() && m_ghostObject->hasContactResponse() &&
+      needsCollision(m_ghostObject, callback.m_hitCollisionObject))
+  {
+    // Only modify the position if the hit was a slope and not a wall or ceiling.
+    if (callback.m_hitNormalWorld.dot(m_up) > 0.0f) {
+      // We moved up only a fraction of the step height.
+      m_currentStepOffset = stepHeight * callback.m_closestHitFraction;
+      if (m_interpolateUp) {
+        m_currentPosition.setInterpolate3(
+            m_currentPosition, m_targetPosition, callback.m_closestHitFraction);
+      }
+      else {
+        m_currentPosition = m_targetPosition;
+      }
+    }
+
+    /* Unlike bullet the ghost object is not moved and recovered from the ceiling penetration
+     * here, the recovery is done with the one of the end of the step. */
+    m_targetPosition = m_currentPosition;
+
+    if (m_verticalOffset > 0.0f) {
+      m_verticalOffset = 0.0f;
+      m_verticalVelocity = 0.0f;
+      m_currentStepOffset = m_stepHeight;
+    }
+  }
+  else {
+    m_currentStepOffset = stepHeight;
+    m_currentPosition = m_targetPosition;
+  }
+}
+
+void CcdCharacter::StepForward(btCollisionWorld *collisionWorld, btScalar dt)
+{
+  btVector3 walkMove;
+  if (m_useWalkDirection) {
+    walkMove = m_walkDirection;
+  }
+  else {
+    // Still have some time left for moving.
+    const btScalar dtMoving = (dt < m_velocityTimeInterval) ? dt : m_velocityTimeInterval;
+    m_velocityTimeInterval -= dt;
+    walkMove = m_walkDirection * dtMoving;
+  }
+
+  /* Same as btKinematicCharacterController::stepForwardAndStrafe, the added margin is in the
+   * sweep shape instead of being added to the shape. */
+  btConvexShape *shape = m_sweepShape ? m_sweepShape : m_convexShape;
+  m_targetPosition = m_currentPosition + walkMove;
+
+  btScalar fraction = 1.0f;
+  for (int maxIter = 10; fraction > btScalar(0.01) && maxIter-- > 0;) {
+    const btTransform start(m_currentOrientation, m_currentPosition);
+    const btTransform end(m_targetOrientation, m_targetPosition);
+    const btVector3 sweepDirNegative(m_currentPosition - m_targetPosition);
+
+    CcdCharacterSweepCallback callback(m_ghostObject, sweepDirNegative, 0.0f);
+
+    if (!(start == end)) {
+      if (m_useGhostObjectSweepTest) {
+        m_ghostObject->convexSweepTest(shape,
+                                       start,
+                                       end,
+                                       callback,
+                                       collisionWorld->getDispatchInfo().m_allowedCcdPenetration);
+      }
+      else {
+        collisionWorld->convexSweepTest(shape,
+                                        start,
+                                        end,
+                                        callback,
+                                        collisionWorld->getDispatchInfo().m_allowedCcdPenetration);
+      }
+    }
+
+    fraction -= callback.m_closestHitFraction;
+
+    if (callback.hasHit() && m_ghostObject->hasContactResponse() &&
+        needsCollision(m_ghostObject, callback.m_hitCollisionObject))
+    {
+      updateTargetPositionBasedOnCollision(callback.m_hitNormalWorld);
+      btVector3 currentDir = m_targetPosition - m_currentPosition;
+      if (currentDir.length2() <= SIMD_EPSILON) {
+        break;
+      }
+
+      currentDir.normalize();
+      // If velocity is against original velocity, stop to avoid tiny oscillations in corners.
+      if (currentDir.dot(m_normalizedDirection) <= 0.0f) {
+        break;
+      }
+    }
+    else {
+      m_currentPosition = m_targetPosition;
+    }
+  }
+}
+
+void CcdCharacter::StepDown(btCollisionWorld *collisionWorld, btScalar dt)
+{
+  // Only sweeps from the character, safe to use in parallel.
+  stepDown(collisionWorld, dt);
+}
+
+void CcdCharacter::EndStep(btCollisionWorld *collisionWorld)
+{
+  if (m_stepMoving) {
+    m_stepTransform.setOrigin(m_currentPosition);
+    m_ghostObject->setWorldTransform(m_stepTransform);
+
+    m_touchingContact = false;
+    for (int numPenetrationLoops = 0; recoverFromPenetration(collisionWorld);) {
+      m_touchingContact = true;
+      if (++numPenetrationLoops > 4) {
+        break;
+      }
+    }
+    m_stepMoving = false;
+  }
+
+  m_motionState->setWorldTransform(m_ghostObject->getWorldTransform());
 }
 
 unsigned char CcdCharacter::getMaxJumps() const
@@ -158,6 +517,7 @@ void CcdCharacter::ReplaceShape(btConvexShape *shape)
 {
   m_convexShape = shape;
   m_ghostObject->setCollisionShape(m_convexShape);
+  CreateSweepShape();
 }
 
 void CcdCharacter::SetVelocity(const MT_Vector3 &vel, float time, bool local)
@@ -187,10 +547,16 @@ bool CleanPairCallback::processOverlap(btBroadphasePair &pair)
   return false;
 }
 
+/// Identifier of the next controller, zero is never used.
+static std::atomic<uint64_t> nextControllerId(1);
+
 CcdPhysicsController::CcdPhysicsController(const CcdConstructionInfo &ci) : m_cci(ci)
 {
+  m_uniqueId = nextControllerId++;
   m_prototypeTransformInitialized = false;
   m_softbodyMappingDone = false;
+  m_softBodyMesh = nullptr;
+  m_softBodyPositions = nullptr;
   m_newClientInfo = 0;
   m_registerCount = 0;
   m_softBodyTransformInitialized = false;
@@ -254,14 +620,34 @@ btTransform CcdPhysicsController::GetTransformFromMotionState(PHY_IMotionState *
 
 class BlenderBulletMotionState : public btMotionState {
   PHY_IMotionState *m_blenderMotionState;
+  /// Transform read before an asynchronous step.
+  btTransform m_stepTransform;
+  /// The simulation is stepped asynchronously, the motion state is not accessed.
+  bool m_asyncStep;
 
  public:
-  BlenderBulletMotionState(PHY_IMotionState *bms) : m_blenderMotionState(bms)
+  BlenderBulletMotionState(PHY_IMotionState *bms) : m_blenderMotionState(bms), m_asyncStep(false)
   {
   }
 
+  void BeginAsyncStep()
+  {
+    getWorldTransform(m_stepTransform);
+    m_asyncStep = true;
+  }
+
+  void EndAsyncStep()
+  {
+    m_asyncStep = false;
+  }
+
   void getWorldTransform(btTransform &worldTrans) const
   {
+    if (m_asyncStep) {
+      worldTrans = m_stepTransform;
+      return;
+    }
+
     const MT_Vector3 pos = m_blenderMotionState->GetWorldPosition();
     const MT_Matrix3x3 mat = m_blenderMotionState->GetWorldOrientation();
     worldTrans.setOrigin(ToBullet(pos));
@@ -270,6 +656,11 @@ class BlenderBulletMotionState : public btMotionState {
 
   void setWorldTransform(const btTransform &worldTrans)
   {
+    // Applied from the snapshot of the step.
+    if (m_asyncStep) {
+      return;
+    }
+
     m_blenderMotionState->SetWorldPosition(ToMoto(worldTrans.getOrigin()));
     m_blenderMotionState->SetWorldOrientation(ToMoto(worldTrans.getRotation()));
     m_blenderMotionState->CalculateWorldTransformations();
@@ -504,6 +895,10 @@ bool CcdPhysicsController::CreateSoftbody()
     if (rasMesh && !m_softbodyMappingDone) {
       RAS_MeshMaterial *mmat;
 
+      // the mesh vertex table depends on the node indices, compute it again at next update
+      m_softBodyMesh = nullptr;
+      m_softBodyVertexNodes.clear();
+
       // for each material
       for (int m = 0; m < rasMesh->NumMaterials(); m++) {
         mmat = rasMesh->GetMeshMaterial(m);
@@ -837,76 +1232,161 @@ bool CcdPhysicsController::SynchronizeMotionStates(float time)
   return true;
 }
 
-void CcdPhysicsController::UpdateSoftBody()
+void CcdPhysicsController::BeginAsyncStep()
 {
-  btSoftBody *sb = GetSoftBody();
-  if (sb) {
-    if (sb->m_pose.m_bframe || sb->m_pose.m_bvolume) {
+  if (m_bulletMotionState) {
+    static_cast<BlenderBulletMotionState *>(m_bulletMotionState)->BeginAsyncStep();
+  }
+}
 
-      RAS_MeshObject *rasMesh = GetShapeInfo()->GetMesh();
+void CcdPhysicsController::EndAsyncStep()
+{
+  if (m_bulletMotionState) {
+    static_cast<BlenderBulletMotionState *>(m_bulletMotionState)->EndAsyncStep();
+  }
+}
 
-      if (rasMesh) {
-        KX_GameObject *gameobj = KX_GameObject::GetClientObject(
-            (KX_ClientObjectInfo *)GetNewClientInfo());
-        Object *ob = gameobj->GetBlenderObject();
-        Mesh *me = (Mesh *)ob->data;
-        BKE_mesh_tessface_ensure(me);
+void CcdPhysicsController::SetMotionStateTransform(const btTransform &xform)
+{
+  m_MotionState->SetWorldOrientation(ToMoto(xform.getBasis()));
+  m_MotionState->SetWorldPosition(ToMoto(xform.getOrigin()));
+  m_MotionState->CalculateWorldTransformations();
 
-        const int *index_mf_to_mpoly = (const int *)CustomData_get_layer(&me->fdata_legacy, CD_ORIGINDEX);
-        const int *index_mp_to_orig = (const int *)CustomData_get_layer(&me->face_data, CD_ORIGINDEX);
-        if (!index_mf_to_mpoly) {
-          index_mp_to_orig = nullptr;
+  const MT_Vector3 &scale = m_MotionState->GetWorldScaling();
+  GetCollisionShape()->setLocalScaling(ToBullet(scale));
+}
+
+/// Number of mesh vertices written by a single soft body write-back task.
+static const int SOFT_BODY_VERTEX_CHUNK = 1024;
+
+struct SoftBodyWriteData {
+  float (*positions)[3];
+  const int *vertexNodes;
+  const btSoftBody::Node *nodes;
+  btVector3 com;
+  int numVerts;
+};
+
+static void soft_body_write_task(void *__restrict userdata,
+                                 const int chunk,
+                                 const TaskParallelTLS *__restrict /*tls*/)
+{
+  const SoftBodyWriteData *data = static_cast<const SoftBodyWriteData *>(userdata);
+  const int start = chunk * SOFT_BODY_VERTEX_CHUNK;
+  const int end = std::min(start + SOFT_BODY_VERTEX_CHUNK, data->numVerts);
+
+  for (int v = start; v < end; ++v) {
+    const int n = data->vertexNodes[v];
+    if (n != -1) {
+      // Do we need object_to_world? maybe
+      const btVector3 pos = data->nodes[n].m_x - data->com;
+      data->positions[v][0] = pos.x();
+      data->positions[v][1] = pos.y();
+      data->positions[v][2] = pos.z();
+    }
+  }
+}
+
+void CcdPhysicsController::BuildSoftBodyVertexNodes(Mesh *me, RAS_MeshObject *rasMesh)
+{
+  BKE_mesh_tessface_ensure(me);
+
+  const int *index_mf_to_mpoly = (const int *)CustomData_get_layer(&me->fdata_legacy,
+                                                                   CD_ORIGINDEX);
+  const int *index_mp_to_orig = (const int *)CustomData_get_layer(&me->face_data, CD_ORIGINDEX);
+  if (!index_mf_to_mpoly) {
+    index_mp_to_orig = nullptr;
+  }
+
+  const MFace *faces = (MFace *)CustomData_get_layer(&me->fdata_legacy, CD_MFACE);
+  const int numpolys = me->totface_legacy;
+  const int numnodes = GetSoftBody()->m_nodes.size();
+
+  m_softBodyVertexNodes.assign(me->verts_num, -1);
+
+  for (int p2 = 0; p2 < numpolys; p2++) {
+    const MFace *face = &faces[p2];
+    const int origi = index_mf_to_mpoly ?
+                          DM_origindex_mface_mpoly(index_mf_to_mpoly, index_mp_to_orig, p2) :
+                          p2;
+    RAS_Polygon *poly = (origi != ORIGINDEX_NONE) ? rasMesh->GetPolygon(origi) : nullptr;
+
+    // only add polygons that have the collisionflag set
+    if (poly) {
+      const unsigned int verts[4] = {face->v1, face->v2, face->v3, face->v4};
+      const unsigned int numverts = face->v4 ? 4 : 3;
+      for (unsigned int i = 0; i < numverts; ++i) {
+        const int node = poly->GetVertexInfo(i).getSoftBodyIndex();
+        if (node < numnodes) {
+          m_softBodyVertexNodes[verts[i]] = node;
         }
+      }
+    }
+  }
 
-        float(*positions)[3] = reinterpret_cast<float(*)[3]>(
-            me->vert_positions_for_write().data());
-        const MFace *faces = (MFace *)CustomData_get_layer(&me->fdata_legacy, CD_MFACE);
-        int numpolys = me->totface_legacy;
+  m_softBodyMesh = me;
+}
 
-        btSoftBody::tNodeArray &nodes(sb->m_nodes);
+Mesh *CcdPhysicsController::BeginSoftBodyUpdate()
+{
+  btSoftBody *sb = GetSoftBody();
+  if (!sb || !(sb->m_pose.m_bframe || sb->m_pose.m_bvolume)) {
+    return nullptr;
+  }
 
-        for (int p2 = 0; p2 < numpolys; p2++) {
-          const MFace *face = &faces[p2];
-          const int origi = index_mf_to_mpoly ?
-                                DM_origindex_mface_mpoly(index_mf_to_mpoly, index_mp_to_orig, p2) :
-                                p2;
-          RAS_Polygon *poly = (origi != ORIGINDEX_NONE) ? rasMesh->GetPolygon(origi) : nullptr;
+  RAS_MeshObject *rasMesh = GetShapeInfo()->GetMesh();
+  if (!rasMesh) {
+    return nullptr;
+  }
 
-          // only add polygons that have the collisionflag set
-          if (poly) {
-            float *v1 = &positions[face->v1][0];
-            float *v2 = &positions[face->v2][0];
-            float *v3 = &positions[face->v3][0];
+  KX_GameObject *gameobj = KX_GameObject::GetClientObject(
+      (KX_ClientObjectInfo *)GetNewClientInfo());
+  Mesh *me = (Mesh *)gameobj->GetBlenderObject()->data;
 
-            int i1 = poly->GetVertexInfo(0).getSoftBodyIndex();
-            int i2 = poly->GetVertexInfo(1).getSoftBodyIndex();
-            int i3 = poly->GetVertexInfo(2).getSoftBodyIndex();
+  if (me != m_softBodyMesh || int(m_softBodyVertexNodes.size()) != me->verts_num) {
+    BuildSoftBodyVertexNodes(me, rasMesh);
+  }
 
-            MT_Vector3 p1 = ToMoto(nodes.at(i1).m_x - sb->m_pose.m_com);
-            MT_Vector3 p2 = ToMoto(nodes.at(i2).m_x - sb->m_pose.m_com);
-            MT_Vector3 p3 = ToMoto(nodes.at(i3).m_x - sb->m_pose.m_com);
+  m_softBodyPositions = reinterpret_cast<float(*)[3]>(me->vert_positions_for_write().data());
 
-            // Do we need object_to_world? maybe
-            copy_v3_v3(v1, p1.getValue());
-            copy_v3_v3(v2, p2.getValue());
-            copy_v3_v3(v3, p3.getValue());
+  return me;
+}
 
-            if (face->v4) {
-              float *v4 = &positions[face->v4][0];
+void CcdPhysicsController::WriteSoftBodyVertices()
+{
+  btSoftBody *sb = GetSoftBody();
 
-              int i4 = poly->GetVertexInfo(3).getSoftBodyIndex();
+  SoftBodyWriteData data;
+  data.positions = m_softBodyPositions;
+  data.vertexNodes = m_softBodyVertexNodes.data();
+  data.nodes = &sb->m_nodes[0];
+  data.com = sb->m_pose.m_com;
+  data.numVerts = m_softBodyVertexNodes.size();
 
-              MT_Vector3 p4 = ToMoto(nodes.at(i4).m_x - sb->m_pose.m_com);
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
 
-              copy_v3_v3(v4, p4.getValue());
+  const int numchunks = (data.numVerts + SOFT_BODY_VERTEX_CHUNK - 1) / SOFT_BODY_VERTEX_CHUNK;
+  BLI_task_parallel_range(0, numchunks, &data, soft_body_write_task, &settings);
+}
 
-            }
-          }
-        }
-        me->tag_positions_changed();
-        DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
-      }
-    }
+void CcdPhysicsController::EndSoftBodyUpdate()
+{
+  KX_GameObject *gameobj = KX_GameObject::GetClientObject(
+      (KX_ClientObjectInfo *)GetNewClientInfo());
+  Object *ob = gameobj->GetBlenderObject();
+
+  m_softBodyMesh->tag_positions_changed();
+  DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
+  m_softBodyPositions = nullptr;
+}
+
+void CcdPhysicsController::UpdateSoftBody()
+{
+  if (BeginSoftBodyUpdate()) {
+    WriteSoftBodyVertices();
+    EndSoftBodyUpdate();
   }
 }
 
@@ -936,6 +1416,7 @@ void CcdPhysicsController::PostProcessReplica(class PHY_IMotionState *motionstat
                                               class PHY_IPhysicsController *parentctrl)
 {
   SetParentRoot((CcdPhysicsController *)parentctrl);
+  m_uniqueId = nextControllerId++;
   m_softBodyTransformInitialized = false;
   m_MotionState = motionstate;
   m_registerCount = 0;
@@ -1991,6 +2472,418 @@ CcdShapeConstructionInfo *CcdShapeConstructionInfo::FindMesh(RAS_MeshObject *mes
   return nullptr;
 }
 
+CM_ThreadMutex CcdOptimizedBvh::m_refMutex;
+
+CcdOptimizedBvh::CcdOptimizedBvh(btStridingMeshInterface *meshInterface,
+                                 int numVertices,
+                                 int numTriangles,
+                                 uint64_t hash,
+                                 const std::string &cacheDirectory)
+    : m_bvh(nullptr),
+      m_buffer(nullptr),
+      m_numVertices(numVertices),
+      m_numTriangles(numTriangles),
+      m_hash(hash)
+{
+  std::string filepath;
+  if (!cacheDirectory.empty()) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bvh", (unsigned long long)hash);
+    filepath = cacheDirectory + "/" + name;
+    if (Load(filepath)) {
+      return;
+    }
+  }
+
+  btVector3 aabbMin;
+  btVector3 aabbMax;
+  meshInterface->calculateAabbBruteForce(aabbMin, aabbMax);
+
+  void *mem = btAlignedAlloc(sizeof(btOptimizedBvh), 16);
+  m_bvh = new (mem) btOptimizedBvh();
+  m_bvh->build(meshInterface, true, aabbMin, aabbMax);
+
+  if (!filepath.empty()) {
+    Save(filepath);
+  }
+}
+
+CcdOptimizedBvh::~CcdOptimizedBvh()
+{
+  if (m_buffer) {
+    // The BVH was deserialized in place, its arrays are pointing in the buffer.
+    m_bvh->~btOptimizedBvh();
+    btAlignedFree(m_buffer);
+  }
+  else {
+    m_bvh->~btOptimizedBvh();
+    btAlignedFree(m_bvh);
+  }
+}
+
+/// Header of the BVH cache files.
+struct CcdOptimizedBvhFileHeader {
+  char m_code[4];
+  /// Version of the file layout, see bvhFileVersion.
+  int m_version;
+  /// Version of Bullet which serialized the BVH.
+  int m_bulletVersion;
+  int m_scalarSize;
+  int m_numVertices;
+  int m_numTriangles;
+  /// Geometry hash, also used in the file name.
+  uint64_t m_hash;
+  unsigned int m_size;
+};
+
+static const char bvhFileCode[4] = {'U', 'B', 'V', 'H'};
+/// Increase when the content of the BVH cache files changes.
+static const int bvhFileVersion = 2;
+/// Number of BVH cache files written by this process, names their temporary file.
+static std::atomic<unsigned int> bvhFileWriteCount(0);
+
+bool CcdOptimizedBvh::Load(const std::string &filepath)
+{
+  FILE *file = fopen(filepath.c_str(), "rb");
+  if (!file) {
+    return false;
+  }
+
+  CcdOptimizedBvhFileHeader header;
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      memcmp(header.m_code, bvhFileCode, sizeof(bvhFileCode)) != 0 ||
+      header.m_version != bvhFileVersion || header.m_bulletVersion != BT_BULLET_VERSION ||
+      header.m_scalarSize != sizeof(btScalar) || header.m_numVertices != m_numVertices ||
+      header.m_numTriangles != m_numTriangles || header.m_hash != m_hash || header.m_size == 0)
+  {
+    fclose(file);
+    return false;
+  }
+
+  m_buffer = btAlignedAlloc(header.m_size, 16);
+  // The file must end with the BVH.
+  if (fread(m_buffer, header.m_size, 1, file) != 1 || fgetc(file) != EOF) {
+    btAlignedFree(m_buffer);
+    m_buffer = nullptr;
+    fclose(file);
+    return false;
+  }
+  fclose(file);
+
+  m_bvh = (btOptimizedBvh *)btOptimizedBvh::deSerializeInPlace(m_buffer, header.m_size, false);
+  if (!m_bvh) {
+    btAlignedFree(m_buffer);
+    m_buffer = nullptr;
+    return false;
+  }
+
+  return true;
+}
+
+void CcdOptimizedBvh::Save(const std::string &filepath) const
+{
+  CcdOptimizedBvhFileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.m_code, bvhFileCode, sizeof(bvhFileCode));
+  header.m_version = bvhFileVersion;
+  header.m_bulletVersion = BT_BULLET_VERSION;
+  header.m_scalarSize = sizeof(btScalar);
+  header.m_numVertices = m_numVertices;
+  header.m_numTriangles = m_numTriangles;
+  header.m_hash = m_hash;
+  header.m_size = m_bvh->calculateSerializeBufferSize();
+
+  void *buffer = btAlignedAlloc(header.m_size, 16);
+  if (m_bvh->serialize(buffer, header.m_size, false)) {
+    /* Written to a temporary file first so that a crash or another instance never leaves a
+     * partial file, named from the process and the write as the BVHs are built in parallel. */
+    const std::string tmppath = filepath + "." + std::to_string(abs(getpid())) + "." +
+                                std::to_string(bvhFileWriteCount++) + ".tmp";
+    FILE *file = BLI_fopen(tmppath.c_str(), "wb");
+    if (file) {
+      bool written = (fwrite(&header, sizeof(header), 1, file) == 1 &&
+                      fwrite(buffer, header.m_size, 1, file) == 1);
+      written = (fclose(file) == 0) && written;
+
+      if (!written || BLI_rename_overwrite(tmppath.c_str(), filepath.c_str()) != 0) {
+        BLI_delete(tmppath.c_str(), false, false);
+      }
+    }
+  }
+  btAlignedFree(buffer);
+}
+
+btOptimizedBvh *CcdOptimizedBvh::GetBvh() const
+{
+  return m_bvh;
+}
+
+CcdOptimizedBvh *CcdOptimizedBvh::AddSharedRef()
+{
+  m_refMutex.Lock();
+  AddRef();
+  m_refMutex.Unlock();
+  return this;
+}
+
+void CcdOptimizedBvh::ReleaseShared()
+{
+  m_refMutex.Lock();
+  Release();
+  m_refMutex.Unlock();
+}
+
+CcdBvhTriangleMeshShape::CcdBvhTriangleMeshShape(btStridingMeshInterface *meshInterface)
+    : btBvhTriangleMeshShape(meshInterface, true, false), m_optimizedBvh(nullptr)
+{
+}
+
+CcdBvhTriangleMeshShape::~CcdBvhTriangleMeshShape()
+{
+  if (m_optimizedBvh) {
+    m_optimizedBvh->ReleaseShared();
+  }
+}
+
+void CcdBvhTriangleMeshShape::SetOptimizedBvh(CcdOptimizedBvh *bvh)
+{
+  BLI_assert(!m_optimizedBvh);
+  m_optimizedBvh = bvh->AddSharedRef();
+  setOptimizedBvh(bvh->GetBvh());
+}
+
+std::unordered_multimap<uint64_t, CcdShapeConstructionInfo *>
+    CcdShapeConstructionInfo::m_geometryShapeMap;
+std::string CcdShapeConstructionInfo::m_bvhCacheDirectory;
+CM_ThreadMutex CcdShapeConstructionInfo::m_cacheMutex;
+
+/// Shape infos waiting for a BVH build, only used between Begin/EndDeferredBvhBuild.
+static thread_local std::vector<CcdShapeConstructionInfo *> *deferredBvhShapeInfos = nullptr;
+/// Number of nested calls to BeginDeferredBvhBuild().
+static thread_local unsigned int deferredBvhDepth = 0;
+
+static uint64_t hash_buffer(uint64_t hash, const void *data, size_t size)
+{
+  // FNV-1a.
+  const unsigned char *bytes = (const unsigned char *)data;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+uint64_t CcdShapeConstructionInfo::ComputeGeometryHash() const
+{
+  uint64_t hash = 14695981039346656037ULL;
+  if (m_vertexArray.size() > 0) {
+    hash = hash_buffer(hash, &m_vertexArray[0], m_vertexArray.size() * sizeof(btScalar));
+  }
+  hash = hash_buffer(hash, m_triFaceArray.data(), m_triFaceArray.size() * sizeof(int));
+  // Zero is used for unregistered geometry.
+  return (hash == 0) ? 1 : hash;
+}
+
+bool CcdShapeConstructionInfo::HasSameGeometry(const CcdShapeConstructionInfo *other) const
+{
+  // Only the data used to build the BVH are compared.
+  if (m_shapeType != other->m_shapeType || m_weldingThreshold1 != other->m_weldingThreshold1 ||
+      m_vertexArray.size() != other->m_vertexArray.size() ||
+      m_polygonIndexArray.size() != other->m_polygonIndexArray.size() ||
+      m_triFaceArray != other->m_triFaceArray)
+  {
+    return false;
+  }
+
+  return (m_vertexArray.size() == 0 || memcmp(&m_vertexArray[0],
+                                              &other->m_vertexArray[0],
+                                              m_vertexArray.size() * sizeof(btScalar)) == 0);
+}
+
+void CcdShapeConstructionInfo::RegisterGeometry()
+{
+  UnregisterGeometry();
+
+  const uint64_t hash = ComputeGeometryHash();
+
+  m_cacheMutex.Lock();
+  m_geometryHash = hash;
+  m_geometryShapeMap.emplace(m_geometryHash, this);
+  m_cacheMutex.Unlock();
+}
+
+void CcdShapeConstructionInfo::UnregisterGeometry()
+{
+  if (m_geometryHash == 0) {
+    return;
+  }
+
+  m_cacheMutex.Lock();
+  const auto range = m_geometryShapeMap.equal_range(m_geometryHash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == this) {
+      m_geometryShapeMap.erase(it);
+      break;
+    }
+  }
+  m_geometryHash = 0;
+  m_cacheMutex.Unlock();
+}
+
+CcdOptimizedBvh *CcdShapeConstructionInfo::FindSharedBvh() const
+{
+  if (m_geometryHash == 0) {
+    return nullptr;
+  }
+
+  CcdOptimizedBvh *bvh = nullptr;
+
+  m_cacheMutex.Lock();
+  const auto range = m_geometryShapeMap.equal_range(m_geometryHash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const CcdShapeConstructionInfo *other = it->second;
+    if (other != this && other->m_optimizedBvh && other->HasSameGeometry(this)) {
+      bvh = other->m_optimizedBvh->AddSharedRef();
+      break;
+    }
+  }
+  m_cacheMutex.Unlock();
+
+  return bvh;
+}
+
+CcdOptimizedBvh *CcdShapeConstructionInfo::EnsureOptimizedBvh()
+{
+  if (m_optimizedBvh) {
+    return m_optimizedBvh;
+  }
+
+  // A different mesh can have the same geometry, e.g. linked from an other library.
+  CcdOptimizedBvh *bvh = FindSharedBvh();
+  if (!bvh) {
+    m_cacheMutex.Lock();
+    const std::string cacheDirectory = m_bvhCacheDirectory;
+    m_cacheMutex.Unlock();
+
+    // Build out of the lock, the geometry is owned by this shape info.
+    const uint64_t hash = (m_geometryHash != 0) ? m_geometryHash : ComputeGeometryHash();
+    bvh = new CcdOptimizedBvh(m_triangleIndexVertexArray,
+                              m_vertexArray.size() / 3,
+                              m_polygonIndexArray.size(),
+                              hash,
+                              cacheDirectory);
+  }
+
+  m_cacheMutex.Lock();
+  m_optimizedBvh = bvh;
+  m_cacheMutex.Unlock();
+
+  return m_optimizedBvh;
+}
+
+void CcdShapeConstructionInfo::ReleaseOptimizedBvh()
+{
+  m_cacheMutex.Lock();
+  CcdOptimizedBvh *bvh = m_optimizedBvh;
+  m_optimizedBvh = nullptr;
+  m_cacheMutex.Unlock();
+
+  // The bullet shapes using the BVH keep their own reference.
+  if (bvh) {
+    bvh->ReleaseShared();
+  }
+}
+
+static void build_bvh_task(TaskPool *__restrict pool, void *taskdata)
+{
+  CcdShapeConstructionInfo *shapeInfo = static_cast<CcdShapeConstructionInfo *>(taskdata);
+  shapeInfo->BuildDeferredBvh();
+}
+
+void CcdShapeConstructionInfo::BuildDeferredBvh()
+{
+  CcdOptimizedBvh *bvh = EnsureOptimizedBvh();
+  for (CcdBvhTriangleMeshShape *shape : m_deferredBvhShapes) {
+    shape->SetOptimizedBvh(bvh);
+  }
+  m_deferredBvhShapes.clear();
+}
+
+void CcdShapeConstructionInfo::BeginDeferredBvhBuild()
+{
+  if (deferredBvhDepth++ == 0) {
+    deferredBvhShapeInfos = new std::vector<CcdShapeConstructionInfo *>();
+  }
+}
+
+void CcdShapeConstructionInfo::EndDeferredBvhBuild()
+{
+  BLI_assert(deferredBvhDepth > 0);
+  // The BVHs are built by the outermost conversion.
+  if (--deferredBvhDepth > 0) {
+    return;
+  }
+
+  std::vector<CcdShapeConstructionInfo *> *shapeInfos = deferredBvhShapeInfos;
+  deferredBvhShapeInfos = nullptr;
+
+  /* Build each geometry only once, the shape infos with the same geometry as an other
+   * deferred shape info get its BVH after the parallel build. */
+  std::vector<CcdShapeConstructionInfo *> builds;
+  std::vector<CcdShapeConstructionInfo *> shares;
+  std::unordered_multimap<uint64_t, CcdShapeConstructionInfo *> geometries;
+  for (CcdShapeConstructionInfo *shapeInfo : *shapeInfos) {
+    bool shared = false;
+    if (shapeInfo->m_geometryHash != 0) {
+      const auto range = geometries.equal_range(shapeInfo->m_geometryHash);
+      for (auto it = range.first; it != range.second; ++it) {
+        if (it->second->HasSameGeometry(shapeInfo)) {
+          shared = true;
+          break;
+        }
+      }
+    }
+
+    if (shared) {
+      shares.push_back(shapeInfo);
+    }
+    else {
+      builds.push_back(shapeInfo);
+      if (shapeInfo->m_geometryHash != 0) {
+        geometries.emplace(shapeInfo->m_geometryHash, shapeInfo);
+      }
+    }
+  }
+
+  if (builds.size() == 1) {
+    builds[0]->BuildDeferredBvh();
+  }
+  else if (!builds.empty()) {
+    TaskPool *taskpool = BLI_task_pool_create(nullptr, TASK_PRIORITY_HIGH);
+    for (CcdShapeConstructionInfo *shapeInfo : builds) {
+      BLI_task_pool_push(taskpool, build_bvh_task, shapeInfo, false, nullptr);
+    }
+    BLI_task_pool_work_and_wait(taskpool);
+    BLI_task_pool_free(taskpool);
+  }
+
+  for (CcdShapeConstructionInfo *shapeInfo : shares) {
+    shapeInfo->BuildDeferredBvh();
+  }
+
+  for (CcdShapeConstructionInfo *shapeInfo : *shapeInfos) {
+    shapeInfo->Release();
+  }
+  delete shapeInfos;
+}
+
+void CcdShapeConstructionInfo::SetBvhCacheDirectory(const std::string &path)
+{
+  m_cacheMutex.Lock();
+  m_bvhCacheDirectory = path;
+  m_cacheMutex.Unlock();
+}
+
 CcdShapeConstructionInfo *CcdShapeConstructionInfo::GetReplica()
 {
   CcdShapeConstructionInfo *replica = new CcdShapeConstructionInfo(*this);
@@ -2005,6 +2898,9 @@ void CcdShapeConstructionInfo::ProcessReplica()
   m_triangleIndexVertexArray = nullptr;
   m_forceReInstance = false;
   m_shapeProxy = nullptr;
+  m_geometryHash = 0;
+  m_optimizedBvh = nullptr;
+  m_deferredBvhShapes.clear();
   m_vertexArray.clear();
   m_polygonIndexArray.clear();
   m_triFaceArray.clear();
@@ -2309,6 +3205,8 @@ bool CcdShapeConstructionInfo::SetMesh(class KX_Scene *kxscene,
   if (!polytope) {
     // triangle shape can be shared, store the mesh object in the map
     m_meshShapeMap.insert(std::pair<RAS_MeshObject *, CcdShapeConstructionInfo *>(meshobj, this));
+    // and also by content for the same geometry in other meshes.
+    RegisterGeometry();
   }
   return true;
 
@@ -2366,6 +3264,9 @@ bool CcdShapeConstructionInfo::UpdateMesh(class KX_GameObject *from_gameobj,
     return false;
   }
 
+  // The geometry is modified, the shape can't be shared by content anymore.
+  UnregisterGeometry();
+
   Mesh *me = nullptr;
   if (from_meshobj) {
     me = nullptr;
@@ -2773,11 +3674,34 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
                                                                         3 * sizeof(btScalar));
           }
 
+          // The BVH was built for the previous geometry, the existing shapes keep it.
+          ReleaseOptimizedBvh();
           m_forceReInstance = false;
         }
 
-        btBvhTriangleMeshShape *unscaledShape = new btBvhTriangleMeshShape(
-            m_triangleIndexVertexArray, true, useBvh);
+        btBvhTriangleMeshShape *unscaledShape;
+        // Welded meshes are rebuilt for each shape and can't share their BVH.
+        if (useBvh && m_weldingThreshold1 == 0.0f) {
+          CcdBvhTriangleMeshShape *sharedBvhShape = new CcdBvhTriangleMeshShape(
+              m_triangleIndexVertexArray);
+          if (m_optimizedBvh) {
+            sharedBvhShape->SetOptimizedBvh(m_optimizedBvh);
+          }
+          else if (deferredBvhShapeInfos) {
+            // Build the BVH with all the other shapes at the end of the conversion.
+            if (m_deferredBvhShapes.empty()) {
+              deferredBvhShapeInfos->push_back(AddRef());
+            }
+            m_deferredBvhShapes.push_back(sharedBvhShape);
+          }
+          else {
+            sharedBvhShape->SetOptimizedBvh(EnsureOptimizedBvh());
+          }
+          unscaledShape = sharedBvhShape;
+        }
+        else {
+          unscaledShape = new btBvhTriangleMeshShape(m_triangleIndexVertexArray, true, useBvh);
+        }
         unscaledShape->setMargin(margin);
         collisionShape = new btScaledBvhTriangleMeshShape(unscaledShape,
                                                           btVector3(1.0f, 1.0f, 1.0f));
@@ -2823,6 +3747,9 @@ CcdShapeConstructionInfo::~CcdShapeConstructionInfo()
   }
   m_shapeArray.clear();
 
+  UnregisterGeometry();
+  ReleaseOptimizedBvh();
+
   if (m_triangleIndexVertexArray)
     delete m_triangleIndexVertexArray;
   m_vertexArray.clear();
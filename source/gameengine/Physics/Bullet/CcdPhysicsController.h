@@ -23,6 +23,8 @@
 #pragma once
 
 #include <map>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 ///	PHY_IPhysicsController is the abstract simplified Interface to a physical object.
@@ -32,6 +34,7 @@
 #include "btBulletDynamicsCommon.h"
 
 #include "CM_RefCount.h"
+#include "CM_Thread.h"
 #include "CcdMathUtils.h"
 #include "PHY_ICharacter.h"
 #include "PHY_IMotionState.h"
@@ -46,6 +49,7 @@ class CcdPhysicsController;
 class btMotionState;
 class RAS_MeshObject;
 struct DerivedMesh;
+struct Mesh;
 class btCollisionShape;
 
 #define CCD_BSB_SHAPE_MATCHING 2
@@ -59,6 +63,56 @@ class btCollisionShape;
 #define CCD_BSB_COL_CL_SS 8  /* Cluster based soft vs soft */
 #define CCD_BSB_COL_VF_SS 16 /* Vertex/Face based soft vs soft */
 
+/** Quantized BVH of a triangle mesh geometry. The BVH is shared by all the
+ * shapes using the same geometry and optionally stored in a disk cache.
+ * Use AddSharedRef() and ReleaseShared(), the BVHs are shared between the
+ * asynchronous conversions.
+ */
+class CcdOptimizedBvh : public CM_RefCount<CcdOptimizedBvh> {
+ private:
+  btOptimizedBvh *m_bvh;
+  /// Buffer containing the BVH when it was loaded in place from the disk cache.
+  void *m_buffer;
+  int m_numVertices;
+  int m_numTriangles;
+  uint64_t m_hash;
+
+  /// Protects the reference counts of all the BVHs.
+  static CM_ThreadMutex m_refMutex;
+
+  bool Load(const std::string &filepath);
+  void Save(const std::string &filepath) const;
+
+ public:
+  /** Build the BVH or load it from the disk cache.
+   * \param hash The geometry content hash used to name the cache file.
+   * \param cacheDirectory The disk cache directory, empty to disable the disk cache.
+   */
+  CcdOptimizedBvh(btStridingMeshInterface *meshInterface,
+                  int numVertices,
+                  int numTriangles,
+                  uint64_t hash,
+                  const std::string &cacheDirectory);
+  ~CcdOptimizedBvh();
+
+  btOptimizedBvh *GetBvh() const;
+
+  CcdOptimizedBvh *AddSharedRef();
+  void ReleaseShared();
+};
+
+/// Triangle mesh shape holding a reference on its shared BVH.
+class CcdBvhTriangleMeshShape : public btBvhTriangleMeshShape {
+ private:
+  CcdOptimizedBvh *m_optimizedBvh;
+
+ public:
+  CcdBvhTriangleMeshShape(btStridingMeshInterface *meshInterface);
+  virtual ~CcdBvhTriangleMeshShape();
+
+  void SetOptimizedBvh(CcdOptimizedBvh *bvh);
+};
+
 // Shape contructor
 // It contains all the information needed to create a simple bullet shape at runtime
 class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
@@ -69,6 +123,16 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
 
   static CcdShapeConstructionInfo *FindMesh(class RAS_MeshObject *mesh,
                                             bool polytope);
+  /** Defer the BVH build of the triangle mesh shapes created by the current thread
+   * until EndDeferredBvhBuild(), the BVHs are then built in parallel.
+   */
+  static void BeginDeferredBvhBuild();
+  static void EndDeferredBvhBuild();
+
+  /// Set the directory used to store the built BVHs, empty to disable the disk cache.
+  static void SetBvhCacheDirectory(const std::string &path);
+  /// Build the BVH of the shapes deferred by BeginDeferredBvhBuild().
+  void BuildDeferredBvh();
 
   CcdShapeConstructionInfo()
       : m_shapeType(PHY_SHAPE_NONE),
@@ -81,7 +145,9 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
         m_triangleIndexVertexArray(nullptr),
         m_forceReInstance(false),
         m_weldingThreshold1(0.0f),
-        m_shapeProxy(nullptr)
+        m_shapeProxy(nullptr),
+        m_geometryHash(0),
+        m_optimizedBvh(nullptr)
   {
     m_childTrans.setIdentity();
   }
@@ -190,6 +256,11 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
 
  protected:
   static std::map<RAS_MeshObject *, CcdShapeConstructionInfo *> m_meshShapeMap;
+  /// Triangle mesh shapes indexed by geometry content hash, used to share their BVHs.
+  static std::unordered_multimap<uint64_t, CcdShapeConstructionInfo *> m_geometryShapeMap;
+  static std::string m_bvhCacheDirectory;
+  /// Protects the geometry shape map and the shape info BVHs, used by asynchronous LibLoad.
+  static CM_ThreadMutex m_cacheMutex;
   /// Keep a pointer to the original mesh
   RAS_MeshObject *m_meshObject;
   /// The list of vertexes and indexes for the triangle mesh, shared between Bullet shape.
@@ -202,6 +273,22 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
   float m_weldingThreshold1;
   /// only used for PHY_SHAPE_PROXY, pointer to actual shape info
   CcdShapeConstructionInfo *m_shapeProxy;
+  /// Hash of the triangle mesh geometry, zero when not registered in the geometry map.
+  uint64_t m_geometryHash;
+  /// BVH of the current geometry, shared with the shape infos of the same geometry.
+  CcdOptimizedBvh *m_optimizedBvh;
+  /// Bullet shapes waiting for the BVH build, see BeginDeferredBvhBuild().
+  std::vector<CcdBvhTriangleMeshShape *> m_deferredBvhShapes;
+
+  uint64_t ComputeGeometryHash() const;
+  bool HasSameGeometry(const CcdShapeConstructionInfo *other) const;
+  void RegisterGeometry();
+  void UnregisterGeometry();
+  /// Return a new reference on the BVH of an other shape info with the same geometry.
+  CcdOptimizedBvh *FindSharedBvh() const;
+  /// Get the BVH of the current geometry from an other shape info or build it.
+  CcdOptimizedBvh *EnsureOptimizedBvh();
+  void ReleaseOptimizedBvh();
 };
 
 struct CcdConstructionInfo {
@@ -460,15 +547,50 @@ class CcdCharacter : public btKinematicCharacterController,
   unsigned char m_jumps;
   unsigned char m_maxJumps;
 
+  /// The character moves during the current step.
+  bool m_stepMoving;
+  /// Transform of the ghost object at the beginning of the step.
+  btTransform m_stepTransform;
+  /** Copy of the shape with the added margin used by the forward sweep, so that the shape
+   * of the ghost object, possibly shared, is never modified during the parallel sweeps.
+   * nullptr if the shape type can't be copied, the character is then stepped serially.
+   */
+  btConvexShape *m_sweepShape;
+
+  /// Copy the shape of the character into m_sweepShape.
+  void CreateSweepShape();
+  /// Update the scaling and the margin of m_sweepShape from the shape of the character.
+  void UpdateSweepShape();
+
  public:
   CcdCharacter(CcdPhysicsController *ctrl,
                                    btMotionState *motionState,
                                    btPairCachingGhostObject *ghost,
                                    btConvexShape *shape,
                                    float stepHeight);
+  virtual ~CcdCharacter();
 
+  /// Step a single character, the characters of a world are stepped by CcdCharacterBatch.
   virtual void updateAction(btCollisionWorld *collisionWorld, btScalar dt);
 
+  /** The step of btKinematicCharacterController split in phases, so that the sweeps of all
+   * the characters run in parallel. The sweep phases only modify the character and read the
+   * world, the ghost objects keep their transform of the beginning of the step and their
+   * shape, the penetration recovery using the dispatcher is done in EndStep.
+   */
+  /// Integrate the velocities and prepare the sweeps, return true if the character moves.
+  bool BeginStep(btCollisionWorld *collisionWorld, btScalar dt);
+  /// Sweep up by the step height or the jump offset.
+  void StepUp(btCollisionWorld *collisionWorld);
+  /// Sweep along the walk direction with the sweep shape.
+  void StepForward(btCollisionWorld *collisionWorld, btScalar dt);
+  /// Sweep down to the ground.
+  void StepDown(btCollisionWorld *collisionWorld, btScalar dt);
+  /// Move the ghost object to the new position and recover from the penetrations.
+  void EndStep(btCollisionWorld *collisionWorld);
+  /// Return true if the phases of the step can run in parallel with the other characters.
+  bool HasSweepShape() const;
+
   unsigned char getMaxJumps() const;
 
   void setMaxJumps(unsigned char maxJumps);
@@ -578,9 +700,17 @@ class CcdPhysicsController : public PHY_IPhysicsController {
   bool m_softBodyTransformInitialized;
   bool m_prototypeTransformInitialized;
   btTransform m_softbodyStartTrans;
+  /// Mesh receiving the soft body node positions, the vertex to node table is computed for it.
+  Mesh *m_softBodyMesh;
+  /// Soft body node index of each mesh vertex, -1 for the vertices without node.
+  std::vector<int> m_softBodyVertexNodes;
+  /// Mesh positions written during the current soft body update.
+  float (*m_softBodyPositions)[3];
 
   void *m_newClientInfo;
   int m_registerCount;        // needed when multiple sensors use the same controller
+  /// Identifier never reused during the game, unlike the controller address.
+  uint64_t m_uniqueId;
   CcdConstructionInfo m_cci;  // needed for replication
 
   CcdPhysicsController *m_parentRoot;
@@ -598,6 +728,8 @@ class CcdPhysicsController : public PHY_IPhysicsController {
   void CreateRigidbody();
   bool CreateSoftbody();
   bool CreateCharacterController();
+  /// Compute the soft body node index of each mesh vertex from the physics mesh polygons.
+  void BuildSoftBodyVertexNodes(Mesh *me, RAS_MeshObject *rasMesh);
 
   bool Register()
   {
@@ -648,6 +780,11 @@ class CcdPhysicsController : public PHY_IPhysicsController {
 
   btRigidBody *GetRigidBody();
   const btRigidBody *GetRigidBody() const;
+  /// Return the identifier of the controller, used to find back the objects in snapshots.
+  uint64_t GetUniqueId() const
+  {
+    return m_uniqueId;
+  }
   btCollisionObject *GetCollisionObject();
   btSoftBody *GetSoftBody();
   btKinematicCharacterController *GetCharacterController();
@@ -671,7 +808,24 @@ class CcdPhysicsController : public PHY_IPhysicsController {
    */
   virtual bool SynchronizeMotionStates(float time);
 
+  /** During an asynchronous step the Bullet motion state doesn't access the scene graph,
+   * the kinematic transform is read once before the step and the simulated transform
+   * is applied after with SetMotionStateTransform.
+   */
+  void BeginAsyncStep();
+  void EndAsyncStep();
+  /// Apply a simulated world transform to the motion state.
+  void SetMotionStateTransform(const btTransform &xform);
+
   virtual void UpdateSoftBody();
+  /** The soft body update is split to update several soft bodies concurrently.
+   * BeginSoftBodyUpdate returns the mesh receiving the node positions, or nullptr if
+   * there is nothing to update. WriteSoftBodyVertices can run in parallel for the
+   * controllers writing to different meshes and EndSoftBodyUpdate tags the mesh modified.
+   */
+  Mesh *BeginSoftBodyUpdate();
+  void WriteSoftBodyVertices();
+  void EndSoftBodyUpdate();
   virtual void SetSoftBodyTransform(const MT_Vector3 &pos, const MT_Matrix3x3 &ori);
 
   /**
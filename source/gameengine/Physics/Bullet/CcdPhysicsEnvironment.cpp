@@ -21,8 +21,11 @@
 
 #include "CcdPhysicsEnvironment.h"
 
+#include <algorithm>
+
 #include "BKE_object.hh"
 #include "BLI_bounds_types.hh"
+#include "BLI_task.h"
 #include "DNA_object_force_types.h"
 #include "DNA_scene_types.h"
 
@@ -100,25 +103,176 @@ class VehicleClosestRayResultCallback : public btCollisionWorld::ClosestRayResul
   }
 };
 
+class VehicleClosestConvexResultCallback : public btCollisionWorld::ClosestConvexResultCallback {
+ private:
+  const btCollisionObject *m_chassis;
+  unsigned short m_mask;
+
+ public:
+  VehicleClosestConvexResultCallback(const btVector3 &from,
+                                     const btVector3 &to,
+                                     const btCollisionObject *chassis,
+                                     short mask)
+      : btCollisionWorld::ClosestConvexResultCallback(from, to), m_chassis(chassis), m_mask(mask)
+  {
+  }
+
+  virtual bool needsCollision(btBroadphaseProxy *proxy0) const
+  {
+    if (!btCollisionWorld::ClosestConvexResultCallback::needsCollision(proxy0)) {
+      return false;
+    }
+
+    btCollisionObject *object = (btCollisionObject *)proxy0->m_clientObject;
+    // The wheel shape starts inside the chassis.
+    if (object == m_chassis) {
+      return false;
+    }
+
+    CcdPhysicsController *phyCtrl = static_cast<CcdPhysicsController *>(object->getUserPointer());
+    return (phyCtrl->GetCollisionGroup() & m_mask);
+  }
+};
+
+/** Minimum cosine of the angle between the hit normal and the suspension axis of a wheel
+ * convex cast, the wheel falls back on a ray cast for the steeper hits.
+ */
+static const btScalar vehicleConvexCastMinNormalDot = 0.5f;
+
 class BlenderVehicleRaycaster : public btDefaultVehicleRaycaster {
  private:
+  /// Suspension cast of a wheel done before the vehicle update.
+  struct WheelCast {
+    btVector3 m_from;
+    btVector3 m_to;
+    btVehicleRaycasterResult m_result;
+    void *m_object;
+  };
+
   btDynamicsWorld *m_dynamicsWorld;
   unsigned short m_mask;
+  /// Sweep a sphere of the wheel radius instead of casting a ray.
+  bool m_convexCast;
+  std::vector<WheelCast> m_wheelCasts;
+  /// Index of the wheel cast returned by the next call to castRay.
+  unsigned int m_nextWheelCast;
 
  public:
   BlenderVehicleRaycaster(btDynamicsWorld *world)
       : btDefaultVehicleRaycaster(world),
         m_dynamicsWorld(world),
-        m_mask((1 << OB_MAX_COL_MASKS) - 1)
+        m_mask((1 << OB_MAX_COL_MASKS) - 1),
+        m_convexCast(false),
+        m_nextWheelCast(0)
+  {
+  }
+
+  /// Prepare the casts of the wheels, computed by CastWheel.
+  void BeginWheelCasts(int numWheels)
+  {
+    m_wheelCasts.resize(numWheels);
+    m_nextWheelCast = 0;
+  }
+
+  void EndWheelCasts()
+  {
+    m_wheelCasts.clear();
+  }
+
+  /** Cast the suspension of a wheel as done by btRaycastVehicle::rayCast, the result is
+   * returned by castRay during the vehicle update. Thread safe for different wheels.
+   */
+  void CastWheel(btRaycastVehicle *vehicle, int index)
+  {
+    btWheelInfo &wheel = vehicle->getWheelInfo(index);
+    vehicle->updateWheelTransformsWS(wheel, false);
+
+    const btScalar rayLength = wheel.getSuspensionRestLength() + wheel.m_wheelsRadius;
+    const btVector3 &from = wheel.m_raycastInfo.m_hardPointWS;
+    const btVector3 to = from + wheel.m_raycastInfo.m_wheelDirectionWS * rayLength;
+
+    WheelCast &cast = m_wheelCasts[index];
+    cast.m_from = from;
+    cast.m_to = to;
+    cast.m_object = nullptr;
+
+    if (m_convexCast) {
+      cast.m_object = ConvexCast(
+          vehicle->getRigidBody(), wheel, from, to, rayLength, cast.m_result);
+    }
+    // A sphere starting in penetration or hitting on its side falls back on the ray.
+    if (!cast.m_object) {
+      cast.m_object = CastRay(from, to, cast.m_result);
+    }
+  }
+
+  void *ConvexCast(const btCollisionObject *chassis,
+                   const btWheelInfo &wheel,
+                   const btVector3 &from,
+                   const btVector3 &to,
+                   btScalar rayLength,
+                   btVehicleRaycasterResult &result)
   {
+    /* The wheels have no width, a sphere of half the wheel radius keeps the cast close to
+     * the suspension axis. The sphere is swept along the suspension, its bottom reaches the
+     * end of the ray. */
+    const btVector3 &direction = wheel.m_raycastInfo.m_wheelDirectionWS;
+    const btScalar radius = wheel.m_wheelsRadius * 0.5f;
+    const btVector3 sweepTo = to - direction * radius;
+
+    btSphereShape sphere(radius);
+    VehicleClosestConvexResultCallback callback(from, sweepTo, chassis, m_mask);
+    m_dynamicsWorld->convexSweepTest(&sphere,
+                                     btTransform(btQuaternion::getIdentity(), from),
+                                     btTransform(btQuaternion::getIdentity(), sweepTo),
+                                     callback);
+
+    if (!callback.hasHit() || callback.m_closestHitFraction <= 0.0f) {
+      return nullptr;
+    }
+
+    const btRigidBody *body = btRigidBody::upcast(callback.m_hitCollisionObject);
+    if (!body || !body->hasContactResponse()) {
+      return nullptr;
+    }
+
+    btVector3 normal = callback.m_hitNormalWorld;
+    normal.normalize();
+    // Reject the side hits (walls, curbs), the contact must face the wheel along the axis.
+    if (-normal.dot(direction) < vehicleConvexCastMinNormalDot) {
+      return nullptr;
+    }
+
+    // Fraction of the ray at the hit point projected on the suspension axis.
+    const btScalar distance = (callback.m_hitPointWorld - from).dot(direction);
+    if (distance <= 0.0f || distance > rayLength) {
+      return nullptr;
+    }
+
+    result.m_hitPointInWorld = callback.m_hitPointWorld;
+    result.m_hitNormalInWorld = normal;
+    result.m_distFraction = distance / rayLength;
+    return (void *)body;
   }
 
   virtual void *castRay(const btVector3 &from,
                         const btVector3 &to,
                         btVehicleRaycasterResult &result)
   {
-    //	RayResultCallback& resultCallback;
+    // Use the cast computed before the update, unless the wheel moved since.
+    if (m_nextWheelCast < m_wheelCasts.size()) {
+      const WheelCast &cast = m_wheelCasts[m_nextWheelCast++];
+      if (cast.m_from.distance2(from) < SIMD_EPSILON && cast.m_to.distance2(to) < SIMD_EPSILON) {
+        result = cast.m_result;
+        return cast.m_object;
+      }
+    }
 
+    return CastRay(from, to, result);
+  }
+
+  void *CastRay(const btVector3 &from, const btVector3 &to, btVehicleRaycasterResult &result)
+  {
     VehicleClosestRayResultCallback rayCallback(from, to, m_mask);
 
     // We override btDefaultVehicleRaycaster so we can set this flag, otherwise our
@@ -145,6 +299,16 @@ class BlenderVehicleRaycaster : public btDefaultVehicleRaycaster {
     return m_mask;
   }
 
+  void SetConvexCast(bool convexCast)
+  {
+    m_convexCast = convexCast;
+  }
+
+  bool GetConvexCast() const
+  {
+    return m_convexCast;
+  }
+
   void SetRayCastMask(short mask)
   {
     m_mask = mask;
@@ -186,6 +350,11 @@ class WrapperVehicle : public PHY_IVehicle {
     return m_chassis;
   }
 
+  BlenderVehicleRaycaster *GetRaycaster()
+  {
+    return m_raycaster;
+  }
+
   virtual void AddWheel(PHY_IMotionState *motionState,
                         MT_Vector3 connectionPoint,
                         MT_Vector3 downDirection,
@@ -342,6 +511,15 @@ class WrapperVehicle : public PHY_IVehicle {
   {
     return m_raycaster->GetRayCastMask();
   }
+
+  virtual void SetConvexCast(bool convexCast)
+  {
+    m_raycaster->SetConvexCast(convexCast);
+  }
+  virtual bool GetConvexCast() const
+  {
+    return m_raycaster->GetConvexCast();
+  }
 };
 
 class CcdOverlapFilterCallBack : public btOverlapFilterCallback {
@@ -359,6 +537,254 @@ class CcdOverlapFilterCallBack : public btOverlapFilterCallback {
   virtual bool needBroadphaseCollision(btBroadphaseProxy *proxy0, btBroadphaseProxy *proxy1) const;
 };
 
+/** Broadphase of which the ray test can be called from several threads, btDbvtBroadphase
+ * shares the same traversal stack between all the ray tests.
+ */
+class CcdDbvtBroadphase : public btDbvtBroadphase {
+ private:
+  struct RayTester : btDbvt::ICollide {
+    btBroadphaseRayCallback &m_rayCallback;
+
+    RayTester(btBroadphaseRayCallback &rayCallback) : m_rayCallback(rayCallback)
+    {
+    }
+
+    void Process(const btDbvtNode *leaf)
+    {
+      m_rayCallback.process((btDbvtProxy *)leaf->data);
+    }
+  };
+
+ public:
+  virtual void rayTest(const btVector3 &rayFrom,
+                       const btVector3 &rayTo,
+                       btBroadphaseRayCallback &rayCallback,
+                       const btVector3 &aabbMin,
+                       const btVector3 &aabbMax)
+  {
+    // One stack per thread, kept between the calls to avoid allocations.
+    static thread_local btAlignedObjectArray<const btDbvtNode *> stack;
+
+    RayTester callback(rayCallback);
+    for (btDbvt &set : m_sets) {
+      set.rayTestInternal(set.m_root,
+                          rayFrom,
+                          rayTo,
+                          rayCallback.m_rayDirectionInverse,
+                          rayCallback.m_signs,
+                          rayCallback.m_lambda_max,
+                          aabbMin,
+                          aabbMax,
+                          stack,
+                          callback);
+    }
+  }
+};
+
+/** Return false for the shapes modified by the queries, the GImpact shapes lock their child
+ * shapes (lockChildShapes) during the ray and convex sweep tests.
+ */
+static bool is_parallel_query_safe_shape(const btCollisionShape *shape)
+{
+  if (shape->getShapeType() == GIMPACT_SHAPE_PROXYTYPE) {
+    return false;
+  }
+
+  if (shape->isCompound()) {
+    const btCompoundShape *compound = static_cast<const btCompoundShape *>(shape);
+    for (int i = 0, size = compound->getNumChildShapes(); i < size; ++i) {
+      if (!is_parallel_query_safe_shape(compound->getChildShape(i))) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/// Return false if a shape of the world can't be queried from several threads.
+static bool world_supports_parallel_queries(const btCollisionWorld *world)
+{
+  const btCollisionObjectArray &objects = world->getCollisionObjectArray();
+  for (int i = 0, size = objects.size(); i < size; ++i) {
+    if (!is_parallel_query_safe_shape(objects[i]->getCollisionShape())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/// Number of characters under which the character steps are not threaded.
+static const int characterBatchMinThreaded = 8;
+
+/** Update all the characters of a world in a single action.
+ * The steps of the characters are split in phases, the sweep tests of a phase are done in
+ * parallel against the start of step transforms of the ghost objects while the transforms of
+ * the ghost objects and the penetration recovery, which modify the broadphase, are serial.
+ */
+class CcdCharacterBatch : public btActionInterface {
+ private:
+  std::vector<CcdCharacter *> m_characters;
+  /// The characters moving in the current step.
+  std::vector<CcdCharacter *> m_moving;
+
+  struct PhaseData {
+    CcdCharacter **characters;
+    btCollisionWorld *collisionWorld;
+    btScalar dt;
+  };
+
+  static void StepUpTask(void *__restrict userdata,
+                         const int iter,
+                         const TaskParallelTLS *__restrict /*tls*/)
+  {
+    PhaseData *data = static_cast<PhaseData *>(userdata);
+    data->characters[iter]->StepUp(data->collisionWorld);
+  }
+
+  static void StepForwardTask(void *__restrict userdata,
+                              const int iter,
+                              const TaskParallelTLS *__restrict /*tls*/)
+  {
+    PhaseData *data = static_cast<PhaseData *>(userdata);
+    data->characters[iter]->StepForward(data->collisionWorld, data->dt);
+  }
+
+  static void StepDownTask(void *__restrict userdata,
+                           const int iter,
+                           const TaskParallelTLS *__restrict /*tls*/)
+  {
+    PhaseData *data = static_cast<PhaseData *>(userdata);
+    data->characters[iter]->StepDown(data->collisionWorld, data->dt);
+  }
+
+ public:
+  void AddCharacter(CcdCharacter *character)
+  {
+    m_characters.push_back(character);
+  }
+
+  void RemoveCharacter(CcdCharacter *character)
+  {
+    CM_ListRemoveIfFound(m_characters, character);
+  }
+
+  virtual void updateAction(btCollisionWorld *collisionWorld, btScalar dt)
+  {
+    m_moving.clear();
+    for (CcdCharacter *character : m_characters) {
+      // The shape of the character is modified during its step, stepped at once.
+      if (!character->HasSweepShape()) {
+        character->updateAction(collisionWorld, dt);
+      }
+      else if (character->BeginStep(collisionWorld, dt)) {
+        m_moving.push_back(character);
+      }
+    }
+
+    if (!m_moving.empty()) {
+      PhaseData data = {m_moving.data(), collisionWorld, dt};
+      const int size = m_moving.size();
+
+      TaskParallelSettings settings;
+      BLI_parallel_range_settings_defaults(&settings);
+      // The GImpact shapes are modified by the sweeps against them.
+      settings.use_threading = (size >= characterBatchMinThreaded &&
+                                world_supports_parallel_queries(collisionWorld));
+      settings.min_iter_per_thread = 4;
+
+      BLI_task_parallel_range(0, size, &data, StepUpTask, &settings);
+      BLI_task_parallel_range(0, size, &data, StepForwardTask, &settings);
+      BLI_task_parallel_range(0, size, &data, StepDownTask, &settings);
+    }
+
+    for (CcdCharacter *character : m_characters) {
+      if (character->HasSweepShape()) {
+        character->EndStep(collisionWorld);
+      }
+    }
+  }
+
+  virtual void debugDraw(btIDebugDraw * /*debugDrawer*/)
+  {
+  }
+};
+
+/// Number of wheels under which the wheel casts are not threaded.
+static const int vehicleBatchMinThreaded = 16;
+
+/** Update all the vehicles of a world in a single action.
+ * The suspension casts of all the wheels are done in parallel before the vehicles are
+ * updated serially, the vehicle update only applies impulses and doesn't move any object.
+ */
+class CcdVehicleBatch : public btActionInterface {
+ private:
+  std::vector<WrapperVehicle *> m_vehicles;
+
+  struct WheelCastItem {
+    WrapperVehicle *m_vehicle;
+    int m_wheel;
+  };
+  std::vector<WheelCastItem> m_wheelCasts;
+
+  static void WheelCastTask(void *__restrict userdata,
+                            const int iter,
+                            const TaskParallelTLS *__restrict /*tls*/)
+  {
+    const WheelCastItem &item = static_cast<WheelCastItem *>(userdata)[iter];
+    item.m_vehicle->GetRaycaster()->CastWheel(item.m_vehicle->GetVehicle(), item.m_wheel);
+  }
+
+ public:
+  void AddVehicle(WrapperVehicle *vehicle)
+  {
+    m_vehicles.push_back(vehicle);
+  }
+
+  void RemoveVehicle(WrapperVehicle *vehicle)
+  {
+    CM_ListRemoveIfFound(m_vehicles, vehicle);
+  }
+
+  virtual void updateAction(btCollisionWorld *collisionWorld, btScalar dt)
+  {
+    m_wheelCasts.clear();
+    for (WrapperVehicle *vehicle : m_vehicles) {
+      const int numWheels = vehicle->GetNumWheels();
+      vehicle->GetRaycaster()->BeginWheelCasts(numWheels);
+      for (int i = 0; i < numWheels; ++i) {
+        m_wheelCasts.push_back({vehicle, i});
+      }
+    }
+
+    if (!m_wheelCasts.empty()) {
+      const int size = m_wheelCasts.size();
+
+      TaskParallelSettings settings;
+      BLI_parallel_range_settings_defaults(&settings);
+      // The GImpact shapes are modified by the casts against them.
+      settings.use_threading = (size >= vehicleBatchMinThreaded &&
+                                world_supports_parallel_queries(collisionWorld));
+      settings.min_iter_per_thread = 8;
+
+      BLI_task_parallel_range(0, size, m_wheelCasts.data(), WheelCastTask, &settings);
+    }
+
+    for (WrapperVehicle *vehicle : m_vehicles) {
+      vehicle->GetVehicle()->updateAction(collisionWorld, dt);
+      vehicle->GetRaycaster()->EndWheelCasts();
+    }
+  }
+
+  virtual void debugDraw(btIDebugDraw *debugDrawer)
+  {
+    for (WrapperVehicle *vehicle : m_vehicles) {
+      vehicle->GetVehicle()->debugDraw(debugDrawer);
+    }
+  }
+};
+
 void CcdPhysicsEnvironment::SetDebugDrawer(btIDebugDraw *debugDrawer)
 {
   if (debugDrawer && m_dynamicsWorld)
@@ -376,10 +802,16 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
       m_linearDeactivationThreshold(0.8f),
       m_angularDeactivationThreshold(1.0f),
       m_contactBreakingThreshold(0.02f),
+      m_stepCurTime(0.0),
+      m_stepTimeStep(0.0f),
+      m_stepInterval(0.0f),
+      m_nextStateId(1),
       m_solver(nullptr),
       m_filterCallback(nullptr),
       m_ghostPairCallback(nullptr),
-      m_ownDispatcher(nullptr)
+      m_ownDispatcher(nullptr),
+      m_characterBatch(nullptr),
+      m_vehicleBatch(nullptr)
 {
   for (int i = 0; i < PHY_NUM_RESPONSE; i++) {
     m_triggerCallbacks[i] = nullptr;
@@ -391,7 +823,7 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
   btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher);
   m_ownDispatcher = dispatcher;
 
-  m_broadphase = new btDbvtBroadphase();
+  m_broadphase = new CcdDbvtBroadphase();
   // avoid any collision in the culling tree
   if (useDbvtCulling) {
     m_cullingCache = new btNullPairCache();
@@ -414,8 +846,15 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
   // m_dynamicsWorld->getSolverInfo().m_solverMode=	SOLVER_USE_WARMSTARTING +
   // SOLVER_USE_2_FRICTION_DIRECTIONS +	SOLVER_RANDMIZE_ORDER +	SOLVER_USE_FRICTION_WARMSTARTING;
 
+  m_characterBatch = new CcdCharacterBatch();
+  m_dynamicsWorld->addAction(m_characterBatch);
+  m_vehicleBatch = new CcdVehicleBatch();
+  m_dynamicsWorld->addAction(m_vehicleBatch);
+
   m_debugDrawer = nullptr;
   SetGravity(0.0f, 0.0f, -9.81f);
+
+  m_states.resize(8);
 }
 
 void CcdPhysicsEnvironment::AddCcdPhysicsController(CcdPhysicsController *ctrl)
@@ -446,8 +885,7 @@ void CcdPhysicsEnvironment::AddCcdPhysicsController(CcdPhysicsController *ctrl)
     // Handle potential vehicle constraints
     for (WrapperVehicle *wrapperVehicle : m_wrapperVehicles) {
       if (wrapperVehicle->GetChassis() == ctrl) {
-        btRaycastVehicle *vehicle = wrapperVehicle->GetVehicle();
-        m_dynamicsWorld->addVehicle(vehicle);
+        m_vehicleBatch->AddVehicle(wrapperVehicle);
       }
     }
   }
@@ -462,7 +900,7 @@ void CcdPhysicsEnvironment::AddCcdPhysicsController(CcdPhysicsController *ctrl)
             obj, ctrl->GetCollisionFilterGroup(), ctrl->GetCollisionFilterMask());
       }
       if (ctrl->GetCharacterController()) {
-        m_dynamicsWorld->addAction(ctrl->GetCharacterController());
+        m_characterBatch->AddCharacter(static_cast<CcdCharacter *>(ctrl->GetCharacterController()));
       }
     }
   }
@@ -506,7 +944,7 @@ void CcdPhysicsEnvironment::RemoveConstraint(btTypedConstraint *con, bool free)
 
 void CcdPhysicsEnvironment::RemoveVehicle(WrapperVehicle *vehicle, bool free)
 {
-  m_dynamicsWorld->removeVehicle(vehicle->GetVehicle());
+  m_vehicleBatch->RemoveVehicle(vehicle);
   if (free) {
     CM_ListRemoveIfFound(m_wrapperVehicles, vehicle);
     delete vehicle;
@@ -519,7 +957,7 @@ void CcdPhysicsEnvironment::RemoveVehicle(CcdPhysicsController *ctrl, bool free)
        it != m_wrapperVehicles.end();) {
     WrapperVehicle *vehicle = *it;
     if (vehicle->GetChassis() == ctrl) {
-      m_dynamicsWorld->removeVehicle(vehicle->GetVehicle());
+      m_vehicleBatch->RemoveVehicle(vehicle);
       if (free) {
         it = m_wrapperVehicles.erase(it);
         delete vehicle;
@@ -593,7 +1031,8 @@ bool CcdPhysicsEnvironment::RemoveCcdPhysicsController(CcdPhysicsController *ctr
       m_dynamicsWorld->removeCollisionObject(ctrl->GetCollisionObject());
 
       if (ctrl->GetCharacterController()) {
-        m_dynamicsWorld->removeAction(ctrl->GetCharacterController());
+        m_characterBatch->RemoveCharacter(
+            static_cast<CcdCharacter *>(ctrl->GetCharacterController()));
       }
     }
   }
@@ -756,13 +1195,323 @@ bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, flo
   return true;
 }
 
+void CcdPhysicsEnvironment::BeginDeltaTime(double curTime, float timeStep, float interval)
+{
+  m_stepCurTime = curTime;
+  m_stepTimeStep = timeStep;
+  m_stepInterval = interval;
+
+  for (CcdPhysicsController *ctrl : m_controllers) {
+    ctrl->SynchronizeMotionStates(timeStep);
+    // Kinematic objects are read from the motion state during the step.
+    ctrl->BeginAsyncStep();
+  }
+}
+
+void CcdPhysicsEnvironment::StepDeltaTime()
+{
+  /* Update Bullet global variables, the engine never runs the steps of several
+   * environments at the same time. */
+  gDeactivationTime = m_deactivationTime;
+  gContactBreakingThreshold = m_contactBreakingThreshold;
+
+  const float subStep = m_stepTimeStep / float(m_numTimeSubSteps);
+  const int numSubSteps = m_dynamicsWorld->stepSimulation(m_stepInterval, 25, subStep);
+
+  ProcessFhSprings(m_stepCurTime, numSubSteps * subStep);
+
+  // Snapshot of the simulated transforms, applied to the scene graph in EndDeltaTime.
+  m_stepTransforms.clear();
+  for (CcdPhysicsController *ctrl : m_controllers) {
+    btRigidBody *body = ctrl->GetRigidBody();
+    if (body && !body->isStaticObject()) {
+      m_stepTransforms.push_back({ctrl, body->getCenterOfMassTransform()});
+    }
+    // The ghost object of a character is moved by its action, not by the motion state.
+    else if (ctrl->GetCharacterController()) {
+      m_stepTransforms.push_back({ctrl, ctrl->GetCollisionObject()->getWorldTransform()});
+    }
+  }
+}
+
+void CcdPhysicsEnvironment::EndDeltaTime()
+{
+  for (CcdPhysicsController *ctrl : m_controllers) {
+    ctrl->EndAsyncStep();
+  }
+
+  for (const StepTransform &step : m_stepTransforms) {
+    step.m_controller->SetMotionStateTransform(step.m_transform);
+  }
+  m_stepTransforms.clear();
+
+  // Soft bodies are not part of the snapshot.
+  for (CcdPhysicsController *ctrl : m_controllers) {
+    if (ctrl->GetSoftBody()) {
+      ctrl->SynchronizeMotionStates(m_stepTimeStep);
+    }
+  }
+
+  for (WrapperVehicle *veh : m_wrapperVehicles) {
+    veh->SyncWheels();
+  }
+
+  CallbackTriggers();
+}
+
+using SoftBodyUpdate = std::pair<Mesh *, CcdPhysicsController *>;
+
+/// Soft bodies writing to the same mesh, updated in a single task.
+struct SoftBodyUpdateTask {
+  const SoftBodyUpdate *m_begin;
+  const SoftBodyUpdate *m_end;
+};
+
+static void soft_body_update_task(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  const SoftBodyUpdateTask *task = static_cast<const SoftBodyUpdateTask *>(taskdata);
+  for (const SoftBodyUpdate *update = task->m_begin; update != task->m_end; ++update) {
+    update->second->WriteSoftBodyVertices();
+  }
+}
+
 void CcdPhysicsEnvironment::UpdateSoftBodies()
 {
-  std::set<CcdPhysicsController *>::iterator it;
+  std::vector<SoftBodyUpdate> updates;
+  for (CcdPhysicsController *ctrl : m_controllers) {
+    Mesh *me = ctrl->BeginSoftBodyUpdate();
+    if (me) {
+      updates.emplace_back(me, ctrl);
+    }
+  }
 
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    (*it)->UpdateSoftBody();
+  if (updates.empty()) {
+    return;
+  }
+
+  /* Replicas share their mesh, group the soft bodies by mesh so that a mesh is
+   * written by one task at a time, the vertices of a body are written in parallel. */
+  std::stable_sort(updates.begin(),
+                   updates.end(),
+                   [](const SoftBodyUpdate &a, const SoftBodyUpdate &b) {
+                     return std::less<Mesh *>()(a.first, b.first);
+                   });
+
+  std::vector<SoftBodyUpdateTask> tasks;
+  for (unsigned int i = 0, size = updates.size(); i < size;) {
+    unsigned int end = i + 1;
+    while (end < size && updates[end].first == updates[i].first) {
+      ++end;
+    }
+    tasks.push_back({&updates[i], &updates[0] + end});
+    i = end;
+  }
+
+  if (tasks.size() == 1) {
+    soft_body_update_task(nullptr, &tasks.front());
+  }
+  else {
+    TaskPool *pool = BLI_task_pool_create(nullptr, TASK_PRIORITY_HIGH);
+    for (SoftBodyUpdateTask &task : tasks) {
+      BLI_task_pool_push(pool, soft_body_update_task, &task, false, nullptr);
+    }
+    BLI_task_pool_work_and_wait(pool);
+    BLI_task_pool_free(pool);
+  }
+
+  // Tagging the meshes updates the dependency graph, it is not thread safe.
+  for (const SoftBodyUpdate &update : updates) {
+    update.second->EndSoftBodyUpdate();
+  }
+}
+
+/// Return the identifier of the controller owning a collision object, zero if unknown.
+static uint64_t get_state_object_id(const btCollisionObject *object)
+{
+  const CcdPhysicsController *ctrl = static_cast<const CcdPhysicsController *>(
+      object->getUserPointer());
+  return ctrl ? ctrl->GetUniqueId() : 0;
+}
+
+void CcdPhysicsEnvironment::GetStateManifolds(bool withContactsOnly)
+{
+  btDispatcher *dispatcher = m_dynamicsWorld->getDispatcher();
+  std::vector<ManifoldKey> &keys = m_manifoldKeys;
+  keys.clear();
+  for (int i = 0, size = dispatcher->getNumManifolds(); i < size; ++i) {
+    const btPersistentManifold *manifold = dispatcher->getManifoldByIndexInternal(i);
+    if (withContactsOnly && manifold->getNumContacts() == 0) {
+      continue;
+    }
+    keys.push_back({get_state_object_id(manifold->getBody0()),
+                    get_state_object_id(manifold->getBody1()),
+                    0,
+                    i});
+  }
+
+  // The stable sort keeps the dispatcher order for the manifolds of a same pair.
+  std::stable_sort(keys.begin(), keys.end());
+  for (unsigned int i = 1; i < keys.size(); ++i) {
+    if (keys[i].m_id0 == keys[i - 1].m_id0 && keys[i].m_id1 == keys[i - 1].m_id1) {
+      keys[i].m_index = keys[i - 1].m_index + 1;
+    }
+  }
+}
+
+uint64_t CcdPhysicsEnvironment::SaveState()
+{
+  PhysicsState &state = m_states[m_nextStateId % m_states.size()];
+  state.m_id = m_nextStateId++;
+
+  state.m_bodies.clear();
+  for (CcdPhysicsController *ctrl : m_controllers) {
+    btRigidBody *body = ctrl->GetRigidBody();
+    // The kinematic objects follow their game object and are not saved.
+    if (body && !body->isStaticOrKinematicObject()) {
+      state.m_bodies.push_back({ctrl->GetUniqueId(),
+                                body->getCenterOfMassTransform(),
+                                body->getLinearVelocity(),
+                                body->getAngularVelocity(),
+                                body->getActivationState(),
+                                body->getDeactivationTime()});
+    }
+  }
+  std::sort(state.m_bodies.begin(),
+            state.m_bodies.end(),
+            [](const BodyState &a, const BodyState &b) { return a.m_id < b.m_id; });
+
+  state.m_manifolds.clear();
+  state.m_contacts.clear();
+  btDispatcher *dispatcher = m_dynamicsWorld->getDispatcher();
+  GetStateManifolds(true);
+  for (const ManifoldKey &key : m_manifoldKeys) {
+    const btPersistentManifold *manifold = dispatcher->getManifoldByIndexInternal(
+        key.m_dispatcherIndex);
+    const int numContacts = manifold->getNumContacts();
+    state.m_manifolds.push_back({key, int(state.m_contacts.size()), numContacts});
+    for (int j = 0; j < numContacts; ++j) {
+      state.m_contacts.push_back(manifold->getContactPoint(j));
+    }
+  }
+
+  state.m_constraints.clear();
+  for (int i = 0, size = m_dynamicsWorld->getNumConstraints(); i < size; ++i) {
+    btTypedConstraint *con = m_dynamicsWorld->getConstraint(i);
+    const int conId = con->getUserConstraintId();
+    // The constraints without identifier can't be found back.
+    if (conId != 0) {
+      state.m_constraints.push_back({conId, con->internalGetAppliedImpulse()});
+    }
+  }
+
+  return state.m_id;
+}
+
+bool CcdPhysicsEnvironment::RestoreState(uint64_t id)
+{
+  if (id == 0) {
+    return false;
+  }
+
+  const PhysicsState &state = m_states[id % m_states.size()];
+  if (state.m_id != id) {
+    return false;
+  }
+
+  /* The objects are found by identifier, the addresses of the controllers removed since
+   * the snapshot can be reused by new controllers. The objects removed since the snapshot
+   * are ignored. */
+  for (CcdPhysicsController *ctrl : m_controllers) {
+    btRigidBody *body = ctrl->GetRigidBody();
+    if (!body || body->isStaticOrKinematicObject()) {
+      continue;
+    }
+
+    const uint64_t ctrlId = ctrl->GetUniqueId();
+    const auto it = std::lower_bound(
+        state.m_bodies.begin(),
+        state.m_bodies.end(),
+        ctrlId,
+        [](const BodyState &a, uint64_t b) { return a.m_id < b; });
+    // Skip the objects added since the snapshot.
+    if (it == state.m_bodies.end() || it->m_id != ctrlId) {
+      continue;
+    }
+
+    const BodyState &bodyState = *it;
+    const bool moved = !(body->getCenterOfMassTransform() == bodyState.m_transform);
+
+    body->setLinearVelocity(bodyState.m_linearVelocity);
+    body->setAngularVelocity(bodyState.m_angularVelocity);
+    // Also reset the interpolation transform and velocities.
+    body->setCenterOfMassTransform(bodyState.m_transform);
+    body->forceActivationState(bodyState.m_activationState);
+    body->setDeactivationTime(bodyState.m_deactivationTime);
+
+    // Most of the objects are sleeping in a rollback window, avoid to update them.
+    if (moved) {
+      m_dynamicsWorld->updateSingleAabb(body);
+      ctrl->SetMotionStateTransform(bodyState.m_transform);
+    }
+  }
+
+  /* The warm starting impulses are restored in the manifolds still existing, the manifolds
+   * created since the snapshot are emptied and the destroyed ones are recreated without
+   * warm starting by the next collision detection. */
+  btDispatcher *dispatcher = m_dynamicsWorld->getDispatcher();
+  GetStateManifolds(false);
+  for (const ManifoldKey &key : m_manifoldKeys) {
+    btPersistentManifold *manifold = dispatcher->getManifoldByIndexInternal(
+        key.m_dispatcherIndex);
+    manifold->clearManifold();
+
+    const auto it = std::lower_bound(
+        state.m_manifolds.begin(),
+        state.m_manifolds.end(),
+        key,
+        [](const ManifoldState &a, const ManifoldKey &b) { return a.m_key < b; });
+    // The manifolds of the objects without controller can't be found back.
+    if (it == state.m_manifolds.end() || !(it->m_key == key) || key.m_id0 == 0 ||
+        key.m_id1 == 0)
+    {
+      continue;
+    }
+
+    manifold->setNumContacts(it->m_numContacts);
+    for (int j = 0; j < it->m_numContacts; ++j) {
+      btManifoldPoint &point = manifold->getContactPoint(j);
+      point = state.m_contacts[it->m_firstContact + j];
+      point.m_userPersistentData = nullptr;
+    }
+  }
+
+  for (int i = 0, size = m_dynamicsWorld->getNumConstraints(); i < size; ++i) {
+    btTypedConstraint *con = m_dynamicsWorld->getConstraint(i);
+    const int conId = con->getUserConstraintId();
+    if (conId == 0) {
+      continue;
+    }
+    // The constraints are rarely added or removed, look first at the same index.
+    if (i < int(state.m_constraints.size()) && state.m_constraints[i].m_id == conId) {
+      con->internalSetAppliedImpulse(state.m_constraints[i].m_appliedImpulse);
+      continue;
+    }
+    for (const ConstraintState &conState : state.m_constraints) {
+      if (conState.m_id == conId) {
+        con->internalSetAppliedImpulse(conState.m_appliedImpulse);
+        break;
+      }
+    }
   }
+
+  return true;
+}
+
+void CcdPhysicsEnvironment::SetStateBufferSize(int size)
+{
+  // Changing the size invalidates the snapshots as they are indexed by identifier modulo size.
+  m_states.clear();
+  m_states.resize(std::max(size, 1));
 }
 
 class ClosestRayResultCallbackNotMe : public btCollisionWorld::ClosestRayResultCallback {
@@ -1153,6 +1902,11 @@ static bool GetHitTriangle(btCollisionShape *shape,
   return true;
 }
 
+bool CcdPhysicsEnvironment::SupportsParallelQueries() const
+{
+  return world_supports_parallel_queries(m_dynamicsWorld);
+}
+
 PHY_IPhysicsController *CcdPhysicsEnvironment::RayTest(PHY_IRayCastFilterCallback &filterCallback,
                                                        float fromX,
                                                        float fromY,
@@ -1993,6 +2747,8 @@ CcdPhysicsEnvironment::~CcdPhysicsEnvironment()
   // first delete scene, then dispatcher, because pairs have to release manifolds on the dispatcher
   // delete m_dispatcher;
   delete m_dynamicsWorld;
+  delete m_characterBatch;
+  delete m_vehicleBatch;
 
   if (nullptr != m_ownDispatcher)
     delete m_ownDispatcher;
@@ -2616,7 +3372,7 @@ PHY_IVehicle *CcdPhysicsEnvironment::CreateVehicle(PHY_IPhysicsController *ctrl)
   WrapperVehicle *wrapperVehicle = new WrapperVehicle(vehicle, raycaster, ctrl);
   m_wrapperVehicles.push_back(wrapperVehicle);
 
-  m_dynamicsWorld->addVehicle(vehicle);
+  m_vehicleBatch->AddVehicle(wrapperVehicle);
 
   vehicle->setUserConstraintId(gConstraintUid++);
   vehicle->setUserConstraintType(PHY_VEHICLE_CONSTRAINT);
@@ -2671,6 +3427,21 @@ float CcdPhysicsEnvironment::getAppliedImpulse(int constraintid)
   return 0.0f;
 }
 
+void CcdPhysicsEnvironment::BeginObjectsConversion()
+{
+  CcdShapeConstructionInfo::BeginDeferredBvhBuild();
+}
+
+void CcdPhysicsEnvironment::EndObjectsConversion()
+{
+  CcdShapeConstructionInfo::EndDeferredBvhBuild();
+}
+
+void CcdPhysicsEnvironment::SetShapeCacheDirectory(const std::string &path)
+{
+  CcdShapeConstructionInfo::SetBvhCacheDirectory(path);
+}
+
 void CcdPhysicsEnvironment::ExportFile(const std::string &filename)
 {
   btDefaultSerializer *serializer = new btDefaultSerializer();
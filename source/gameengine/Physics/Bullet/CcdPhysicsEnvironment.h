@@ -27,6 +27,7 @@
 #include <set>
 #include <vector>
 
+#include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
 #include "BulletDynamics/ConstraintSolver/btContactSolverInfo.h"
 #include "LinearMath/btTransform.h"
 #include "LinearMath/btVector3.h"
@@ -39,6 +40,8 @@
 class btTypedConstraint;
 class btDispatcher;
 class WrapperVehicle;
+class CcdCharacterBatch;
+class CcdVehicleBatch;
 class btPersistentManifold;
 class btBroadphaseInterface;
 struct btDbvtBroadphase;
@@ -94,6 +97,92 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   void ProcessFhSprings(double curTime, float timeStep);
 
+  struct StepTransform {
+    CcdPhysicsController *m_controller;
+    btTransform m_transform;
+  };
+
+  /// Parameters of the step between BeginDeltaTime and EndDeltaTime.
+  double m_stepCurTime;
+  float m_stepTimeStep;
+  float m_stepInterval;
+  /// Transforms of the dynamic objects and of the characters computed by StepDeltaTime.
+  std::vector<StepTransform> m_stepTransforms;
+
+  /// State of a rigid body in a snapshot.
+  struct BodyState {
+    /// Unique identifier of the controller, see CcdPhysicsController::GetUniqueId().
+    uint64_t m_id;
+    btTransform m_transform;
+    btVector3 m_linearVelocity;
+    btVector3 m_angularVelocity;
+    int m_activationState;
+    btScalar m_deactivationTime;
+  };
+
+  /** Identifier of a manifold stable between snapshots, the identifiers of the controllers of
+   * its objects and its index among the manifolds of the same objects.
+   */
+  struct ManifoldKey {
+    uint64_t m_id0;
+    uint64_t m_id1;
+    int m_index;
+    /// Index of the manifold in the dispatcher, not part of the key.
+    int m_dispatcherIndex;
+
+    bool operator<(const ManifoldKey &other) const
+    {
+      if (m_id0 != other.m_id0) {
+        return m_id0 < other.m_id0;
+      }
+      if (m_id1 != other.m_id1) {
+        return m_id1 < other.m_id1;
+      }
+      return m_index < other.m_index;
+    }
+    bool operator==(const ManifoldKey &other) const
+    {
+      return m_id0 == other.m_id0 && m_id1 == other.m_id1 && m_index == other.m_index;
+    }
+  };
+
+  /// Contact points of a manifold in a snapshot, stored in PhysicsState::m_contacts.
+  struct ManifoldState {
+    ManifoldKey m_key;
+    int m_firstContact;
+    int m_numContacts;
+  };
+
+  struct ConstraintState {
+    /// Constraint user identifier.
+    int m_id;
+    btScalar m_appliedImpulse;
+  };
+
+  /** Snapshot of the simulation, the arrays keep their capacity when the slot is reused
+   * so saving a state doesn't allocate once the ring buffer is filled.
+   */
+  struct PhysicsState {
+    /// Identifier of the snapshot, zero when the slot is unused.
+    uint64_t m_id = 0;
+    /// Bodies sorted by identifier.
+    std::vector<BodyState> m_bodies;
+    /// Manifolds sorted by key.
+    std::vector<ManifoldState> m_manifolds;
+    std::vector<btManifoldPoint> m_contacts;
+    std::vector<ConstraintState> m_constraints;
+  };
+
+  /// Ring buffer of snapshots.
+  std::vector<PhysicsState> m_states;
+  /// Identifier of the next snapshot, starting at one.
+  uint64_t m_nextStateId;
+  /// Sorted keys of the current manifolds, kept to avoid allocations.
+  std::vector<ManifoldKey> m_manifoldKeys;
+
+  /// Fill m_manifoldKeys with the manifolds of the dispatcher.
+  void GetStateManifolds(bool withContactsOnly);
+
  public:
   CcdPhysicsEnvironment(PHY_SolverType solverType, bool useDbvtCulling);
 
@@ -131,9 +220,16 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   /// Perform an integration step of duration 'timeStep'.
   virtual bool ProceedDeltaTime(double curTime, float timeStep, float interval);
+  virtual void BeginDeltaTime(double curTime, float timeStep, float interval);
+  virtual void StepDeltaTime();
+  virtual void EndDeltaTime();
 
   virtual void UpdateSoftBodies();
 
+  virtual uint64_t SaveState();
+  virtual bool RestoreState(uint64_t state);
+  virtual void SetStateBufferSize(int size);
+
   /**
    * Called by Bullet for every physical simulation (sub)tick.
    * Our constructor registers this callback to Bullet, which stores a pointer to 'this' in
@@ -200,6 +296,8 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
                                           float toX,
                                           float toY,
                                           float toZ);
+  /// Return false if the world contains a GImpact shape, its queries modify the shape.
+  virtual bool SupportsParallelQueries() const;
   virtual bool CullingTest(PHY_CullingCallback callback,
                            void *userData,
                            const std::array<MT_Vector4, 6> &planes,
@@ -324,7 +422,16 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   class btDispatcher *m_ownDispatcher;
 
+  /// Action updating all the characters.
+  CcdCharacterBatch *m_characterBatch;
+  /// Action updating all the vehicles.
+  CcdVehicleBatch *m_vehicleBatch;
+
   virtual void ExportFile(const std::string &filename);
+
+  virtual void BeginObjectsConversion();
+  virtual void EndObjectsConversion();
+  virtual void SetShapeCacheDirectory(const std::string &path);
 };
 
 class CcdCollData : public PHY_ICollData {
@@ -38,6 +38,7 @@
 #include "PHY_DynamicTypes.h"
 
 #include <array>
+#include <cstdint>
 
 class PHY_IConstraint;
 class PHY_IVehicle;
@@ -122,8 +123,37 @@ class PHY_IPhysicsEnvironment {
   /// Perform an integration step of duration 'timeStep'.
   virtual bool ProceedDeltaTime(double curTime, float timeStep, float interval) = 0;
 
+  /** Integration step split in three stages to simulate while the previous frame is rendered.
+   * BeginDeltaTime reads the transforms of the scene graph and StepDeltaTime simulates without
+   * accessing the scene graph, it can be called from any thread but the steps of several
+   * environments must not run concurrently as they set Bullet global variables. EndDeltaTime
+   * applies the snapshot of the transforms computed by the simulation and calls the collision
+   * callbacks.
+   */
+  virtual void BeginDeltaTime(double curTime, float timeStep, float interval) = 0;
+  virtual void StepDeltaTime() = 0;
+  virtual void EndDeltaTime() = 0;
+
   virtual void UpdateSoftBodies() = 0;
 
+  /** Save the state of the simulation (transforms, velocities, activation, contacts and
+   * constraints warm starting) in a ring buffer of snapshots, used for rollback.
+   * Return the identifier of the snapshot or zero if not supported.
+   */
+  virtual uint64_t SaveState()
+  {
+    return 0;
+  }
+  /// Restore a snapshot, return false if it was overwritten in the ring buffer.
+  virtual bool RestoreState(uint64_t state)
+  {
+    return false;
+  }
+  /// Set the number of snapshots kept in the ring buffer.
+  virtual void SetStateBufferSize(int size)
+  {
+  }
+
   /// draw debug lines (make sure to call this during the render phase, otherwise lines are not
   /// drawn properly)
   virtual void DebugDrawWorld()
@@ -233,6 +263,10 @@ class PHY_IPhysicsEnvironment {
   // Character physics wrapper
   virtual PHY_ICharacter *GetCharacterController(class KX_GameObject *ob) = 0;
 
+  /** Return the closest object hit by the ray, reported to the callback. Ray tests can run in
+   * several threads at the same time as long as the environment is not modified and
+   * SupportsParallelQueries() returns true.
+   */
   virtual PHY_IPhysicsController *RayTest(PHY_IRayCastFilterCallback &filterCallback,
                                           float fromX,
                                           float fromY,
@@ -241,6 +275,14 @@ class PHY_IPhysicsEnvironment {
                                           float toY,
                                           float toZ) = 0;
 
+  /** Return true if the ray and convex sweep tests can run in several threads at the same
+   * time in the current state of the environment.
+   */
+  virtual bool SupportsParallelQueries() const
+  {
+    return false;
+  }
+
   // culling based on physical broad phase
   // the plane number must be set as follow: near, far, left, right, top, botton
   // the near plane must be the first one and must always be present, it is used to get the
@@ -269,6 +311,12 @@ class PHY_IPhysicsEnvironment {
 
   virtual void ExportFile(const std::string &filename){};
 
+  /// Called before and after the conversion of a set of objects to batch the shapes creation.
+  virtual void BeginObjectsConversion(){};
+  virtual void EndObjectsConversion(){};
+  /// Set the directory used to cache the shape data between runs, empty to disable it.
+  virtual void SetShapeCacheDirectory(const std::string &path){};
+
   virtual void MergeEnvironment(PHY_IPhysicsEnvironment *other_env) = 0;
 
   virtual void ConvertObject(BL_SceneConverter *converter,
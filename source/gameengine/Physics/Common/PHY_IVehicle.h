@@ -57,4 +57,8 @@ class PHY_IVehicle {
 
   virtual void SetRayCastMask(short mask) = 0;
   virtual short GetRayCastMask() const = 0;
+
+  /// Sweep a sphere of the wheel radius along the suspension instead of casting a ray.
+  virtual void SetConvexCast(bool convexCast) = 0;
+  virtual bool GetConvexCast() const = 0;
 };
@@ -52,6 +52,18 @@ bool DummyPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, f
   return true;
 }
 
+void DummyPhysicsEnvironment::BeginDeltaTime(double curTime, float timeStep, float interval)
+{
+}
+
+void DummyPhysicsEnvironment::StepDeltaTime()
+{
+}
+
+void DummyPhysicsEnvironment::EndDeltaTime()
+{
+}
+
 void DummyPhysicsEnvironment::UpdateSoftBodies()
 {
 }
@@ -49,6 +49,9 @@ class DummyPhysicsEnvironment : public PHY_IPhysicsEnvironment {
   virtual ~DummyPhysicsEnvironment();
   // Perform an integration step of duration 'timeStep'.
   virtual bool ProceedDeltaTime(double curTime, float timeStep, float interval);
+  virtual void BeginDeltaTime(double curTime, float timeStep, float interval);
+  virtual void StepDeltaTime();
+  virtual void EndDeltaTime();
   virtual void UpdateSoftBodies();
   virtual void SetFixedTimeStep(bool useFixedTimeStep, float fixedTimeStep);
   virtual float GetFixedTimeStep();
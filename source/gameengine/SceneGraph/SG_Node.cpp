@@ -26,6 +26,7 @@ SG_Node::SG_Node(void *clientobj, void *clientinfo, SG_Callbacks &callbacks)
       m_worldPosition(0.0f, 0.0f, 0.0f),
       m_worldRotation(1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f),
       m_worldScaling(1.0f, 1.0f, 1.0f),
+      m_tick(0),
       m_parent_relation(nullptr),
       m_familly(new SG_Familly()),
       m_modified(true),
@@ -46,6 +47,7 @@ SG_Node::SG_Node(const SG_Node &other)
       m_worldPosition(other.m_worldPosition),
       m_worldRotation(other.m_worldRotation),
       m_worldScaling(other.m_worldScaling),
+      m_tick(0),
       m_parent_relation(other.m_parent_relation->NewCopy()),
       m_familly(new SG_Familly()),
       m_dirty(DIRTY_NONE)
@@ -553,6 +555,38 @@ MT_Transform SG_Node::GetLocalTransform() const
       m_localRotation.scaled(m_localScaling[0], m_localScaling[1], m_localScaling[2]));
 }
 
+void SG_Node::SaveTickTransform(unsigned int tick)
+{
+  m_tickPosition = m_worldPosition;
+  m_tickRotation = m_worldRotation.getRotation();
+  m_tickScaling = m_worldScaling;
+  m_tick = tick;
+}
+
+bool SG_Node::GetInterpolatedWorldTransform(unsigned int tick,
+                                            float factor,
+                                            MT_Vector3 &position,
+                                            MT_Matrix3x3 &orientation,
+                                            MT_Vector3 &scaling) const
+{
+  if (m_tick != tick || factor >= 1.0f) {
+    return false;
+  }
+
+  const MT_Quaternion rotation = m_worldRotation.getRotation();
+  if (m_tickPosition == m_worldPosition && m_tickScaling == m_worldScaling &&
+      m_tickRotation == rotation)
+  {
+    return false;
+  }
+
+  position = m_tickPosition.lerp(m_worldPosition, factor);
+  scaling = m_tickScaling.lerp(m_worldScaling, factor);
+  orientation.setRotation(m_tickRotation.slerp(rotation, factor));
+
+  return true;
+}
+
 bool SG_Node::ComputeWorldTransforms(const SG_Node *parent, bool &parentUpdated)
 {
   return m_parent_relation->UpdateChildCoordinates(this, parent, parentUpdated);
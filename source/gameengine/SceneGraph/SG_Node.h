@@ -315,6 +315,23 @@ class SG_Node : public SG_QList {
   MT_Transform GetWorldTransform() const;
   MT_Transform GetLocalTransform() const;
 
+  /** Store the current world transform as the transform of the previous fixed step.
+   * \param tick The index of the new fixed step.
+   */
+  void SaveTickTransform(unsigned int tick);
+  /** Blend the world transform of the previous fixed step and the current one.
+   * \param tick The index of the current fixed step, nodes saved for an other step
+   * (e.g. created during the step) are not interpolated.
+   * \param factor The blend factor, 0 for the previous step and 1 for the current transform.
+   * The blended transform is set only when the function returns true.
+   * \return True if the node moved during the last step and is interpolated.
+   */
+  bool GetInterpolatedWorldTransform(unsigned int tick,
+                                     float factor,
+                                     MT_Vector3 &position,
+                                     MT_Matrix3x3 &orientation,
+                                     MT_Vector3 &scaling) const;
+
   bool ComputeWorldTransforms(const SG_Node *parent, bool &parentUpdated);
 
   const std::shared_ptr<SG_Familly> &GetFamilly() const;
@@ -370,6 +387,13 @@ class SG_Node : public SG_QList {
   MT_Matrix3x3 m_worldRotation;
   MT_Vector3 m_worldScaling;
 
+  /// World transform at the previous fixed step.
+  MT_Vector3 m_tickPosition;
+  MT_Quaternion m_tickRotation;
+  MT_Vector3 m_tickScaling;
+  /// Index of the fixed step of the saved transform.
+  unsigned int m_tick;
+
   std::unique_ptr<SG_ParentRelation> m_parent_relation;
 
   std::shared_ptr<SG_Familly> m_familly;
@@ -16,12 +16,16 @@
 #    endif
 #  endif
 
+#  include <algorithm>
+#  include <climits>
+#  include <deque>
 #  include <stdint.h>
 #  include <string>
 
 #  include "MEM_guardedalloc.h"
 
 #  include "Exception.h"
+#  include "BLI_task.h"
 #  include "BLI_time.h"
 #  include "movie_util.hh"
 
@@ -68,7 +72,12 @@ VideoFFmpeg::VideoFFmpeg(HRESULT *hRslt)
       m_isThreaded(false),
       m_isStreaming(false),
       m_stopThread(false),
-      m_cacheStarted(false)
+      m_cacheEndOfFile(false),
+      m_cacheStarted(false),
+      m_cacheSize(CACHE_FRAME_SIZE),
+      m_cacheLoop(0),
+      m_cacheStartFrame(0),
+      m_cacheEndFrame(0)
 {
   // set video format
   m_format = RGB24;
@@ -77,9 +86,6 @@ VideoFFmpeg::VideoFFmpeg(HRESULT *hRslt)
   // construction is OK
   *hRslt = S_OK;
   BLI_listbase_clear(&m_thread);
-  pthread_mutex_init(&m_cacheMutex, nullptr);
-  BLI_listbase_clear(&m_frameCacheFree);
-  BLI_listbase_clear(&m_frameCacheBase);
   BLI_listbase_clear(&m_packetCacheFree);
   BLI_listbase_clear(&m_packetCacheBase);
 }
@@ -102,6 +108,7 @@ bool VideoFFmpeg::release()
 {
   // release
   stopCache();
+  freeCachePool();
 
   if (m_codecCtx) {
     avcodec_free_context(&m_codecCtx);
@@ -129,6 +136,8 @@ bool VideoFFmpeg::release()
     sws_freeContext(m_imgConvertCtx);
     m_imgConvertCtx = nullptr;
   }
+  m_keyFrames.clear();
+  m_keyTimestamps.clear();
   m_status = SourceStopped;
   m_lastFrame = -1;
   return true;
@@ -165,6 +174,20 @@ AVFrame *VideoFFmpeg::allocFrameRGB()
   return frame;
 }
 
+struct SwsContext *VideoFFmpeg::createConvertContext()
+{
+  return sws_getContext(m_codecCtx->width,
+                        m_codecCtx->height,
+                        m_codecCtx->pix_fmt,
+                        m_codecCtx->width,
+                        m_codecCtx->height,
+                        (m_format == RGBA32) ? AV_PIX_FMT_RGBA : AV_PIX_FMT_RGB24,
+                        SWS_FAST_BILINEAR,
+                        nullptr,
+                        nullptr,
+                        nullptr);
+}
+
 // set initial parameters
 void VideoFFmpeg::initParams(short width, short height, float rate, bool image)
 {
@@ -287,33 +310,13 @@ int VideoFFmpeg::openStream(const char *filename,
       m_codecCtx->pix_fmt == AV_PIX_FMT_RGB32_1 || m_codecCtx->pix_fmt == AV_PIX_FMT_BGR32_1) {
     // allocate buffer to store final decoded frame
     m_format = RGBA32;
-    // allocate sws context
-    m_imgConvertCtx = sws_getContext(m_codecCtx->width,
-                                     m_codecCtx->height,
-                                     m_codecCtx->pix_fmt,
-                                     m_codecCtx->width,
-                                     m_codecCtx->height,
-                                     AV_PIX_FMT_RGBA,
-                                     SWS_FAST_BILINEAR,
-                                     nullptr,
-                                     nullptr,
-                                     nullptr);
   }
   else {
     // allocate buffer to store final decoded frame
     m_format = RGB24;
-    // allocate sws context
-    m_imgConvertCtx = sws_getContext(m_codecCtx->width,
-                                     m_codecCtx->height,
-                                     m_codecCtx->pix_fmt,
-                                     m_codecCtx->width,
-                                     m_codecCtx->height,
-                                     AV_PIX_FMT_RGB24,
-                                     SWS_FAST_BILINEAR,
-                                     nullptr,
-                                     nullptr,
-                                     nullptr);
   }
+  // allocate sws context
+  m_imgConvertCtx = createConvertContext();
   m_frameRGB = allocFrameRGB();
 
   if (!m_imgConvertCtx) {
@@ -334,17 +337,194 @@ int VideoFFmpeg::openStream(const char *filename,
   return 0;
 }
 
+long VideoFFmpeg::timestampToPosition(int64_t ts)
+{
+  double timeBase = av_q2d(m_formatCtx->streams[m_videoStream]->time_base);
+  int64_t startTs = m_formatCtx->streams[m_videoStream]->start_time;
+
+  if (startTs == AV_NOPTS_VALUE)
+    startTs = 0;
+
+  return (long)((ts - startTs) * (m_baseFrameRate * timeBase) + 0.5);
+}
+
+int64_t VideoFFmpeg::positionToTimestamp(long position)
+{
+  double timeBase = av_q2d(m_formatCtx->streams[m_videoStream]->time_base);
+  int64_t startTs = m_formatCtx->streams[m_videoStream]->start_time;
+
+  if (startTs == AV_NOPTS_VALUE)
+    startTs = 0;
+
+  return (int64_t)(position / (m_baseFrameRate * timeBase)) + startTs;
+}
+
+// get the key frames of the file to seek exactly on them
+void VideoFFmpeg::buildKeyFrameIndex()
+{
+  AVStream *stream = m_formatCtx->streams[m_videoStream];
+
+  m_keyFrames.clear();
+  m_keyTimestamps.clear();
+
+#  if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(58, 78, 100)
+  // most containers provide an index, use it as it doesn't need to read the file
+  for (int i = 0, count = avformat_index_get_entries_count(stream); i < count; i++) {
+    const AVIndexEntry *entry = avformat_index_get_entry(stream, i);
+    if (entry->flags & AVINDEX_KEYFRAME) {
+      m_keyTimestamps.push_back(entry->timestamp);
+    }
+  }
+#  endif
+
+  if (m_keyTimestamps.empty()) {
+    // no index, read all the packets of the file, they are not decoded
+    AVPacket packet;
+    while (av_read_frame(m_formatCtx, &packet) >= 0) {
+      if (packet.stream_index == m_videoStream && (packet.flags & AV_PKT_FLAG_KEY)) {
+        m_keyTimestamps.push_back((packet.pts != AV_NOPTS_VALUE) ? packet.pts : packet.dts);
+      }
+      av_packet_unref(&packet);
+    }
+    // go back to the beginning of the file
+    int64_t startTs = stream->start_time;
+    av_seek_frame(
+        m_formatCtx, m_videoStream, (startTs == AV_NOPTS_VALUE) ? 0 : startTs, AVSEEK_FLAG_BACKWARD);
+    avcodec_flush_buffers(m_codecCtx);
+  }
+
+  std::sort(m_keyTimestamps.begin(), m_keyTimestamps.end());
+  m_keyTimestamps.erase(std::unique(m_keyTimestamps.begin(), m_keyTimestamps.end()),
+                        m_keyTimestamps.end());
+  m_keyFrames.reserve(m_keyTimestamps.size());
+  for (int64_t ts : m_keyTimestamps) {
+    m_keyFrames.push_back(timestampToPosition(ts));
+  }
+}
+
+int VideoFFmpeg::findKeyFrame(long position)
+{
+  std::vector<long>::iterator it = std::upper_bound(m_keyFrames.begin(), m_keyFrames.end(), position);
+  if (it == m_keyFrames.begin())
+    return -1;
+  return (int)(it - m_keyFrames.begin()) - 1;
+}
+
+bool VideoFFmpeg::seekKeyFrame(long position)
+{
+  const int key = findKeyFrame(position);
+  int64_t pos;
+  if (key != -1) {
+    // seek exactly on the key frame, the frames up to position are then decoded
+    pos = m_keyTimestamps[key];
+  }
+  else {
+    // no index, seek some frames before and hope to find a key frame there
+    pos = positionToTimestamp(std::max(position - m_preseek, 0L));
+  }
+
+  if (av_seek_frame(m_formatCtx, m_videoStream, pos, AVSEEK_FLAG_BACKWARD) < 0)
+    return false;
+
+  avcodec_flush_buffers(m_codecCtx);
+  return true;
+}
+
+VideoFFmpeg::FrameRing::FrameRing() : m_head(0), m_tail(0)
+{
+}
+
+void VideoFFmpeg::FrameRing::reset(unsigned int capacity)
+{
+  // one more item to distinguish a full ring from an empty one
+  m_items.assign(capacity + 1, nullptr);
+  m_head = 0;
+  m_tail = 0;
+}
+
+bool VideoFFmpeg::FrameRing::push(CacheFrame *frame)
+{
+  const unsigned int tail = m_tail.load(std::memory_order_relaxed);
+  const unsigned int next = (tail + 1) % m_items.size();
+  if (next == m_head.load(std::memory_order_acquire))
+    return false;
+  m_items[tail] = frame;
+  m_tail.store(next, std::memory_order_release);
+  return true;
+}
+
+VideoFFmpeg::CacheFrame *VideoFFmpeg::FrameRing::front()
+{
+  const unsigned int head = m_head.load(std::memory_order_relaxed);
+  if (head == m_tail.load(std::memory_order_acquire))
+    return nullptr;
+  return m_items[head];
+}
+
+void VideoFFmpeg::FrameRing::pop()
+{
+  const unsigned int head = m_head.load(std::memory_order_relaxed);
+  m_head.store((head + 1) % m_items.size(), std::memory_order_release);
+}
+
+// convert a decoded frame to RGB, run on the task scheduler threads
+void VideoFFmpeg::convertFrameTask(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  CacheFrame *cacheFrame = (CacheFrame *)taskdata;
+  VideoFFmpeg *video = cacheFrame->video;
+  AVFrame *input = cacheFrame->source;
+
+  if (video->m_deinterlace) {
+    if (!cacheFrame->deinterlaced) {
+      cacheFrame->deinterlaced = av_frame_alloc();
+      av_image_fill_arrays(cacheFrame->deinterlaced->data,
+                           cacheFrame->deinterlaced->linesize,
+                           (uint8_t *)MEM_callocN(av_image_get_buffer_size(video->m_codecCtx->pix_fmt,
+                                                                           video->m_codecCtx->width,
+                                                                           video->m_codecCtx->height,
+                                                                           1),
+                                                  "ffmpeg deinterlace"),
+                           video->m_codecCtx->pix_fmt,
+                           video->m_codecCtx->width,
+                           video->m_codecCtx->height,
+                           1);
+    }
+    if (ffmpeg_deinterlace(cacheFrame->deinterlaced,
+                           (const AVFrame *)cacheFrame->source,
+                           video->m_codecCtx->pix_fmt,
+                           video->m_codecCtx->width,
+                           video->m_codecCtx->height) >= 0) {
+      input = cacheFrame->deinterlaced;
+    }
+  }
+  // convert to RGB24
+  sws_scale(cacheFrame->convertCtx,
+            input->data,
+            input->linesize,
+            0,
+            video->m_codecCtx->height,
+            cacheFrame->frame->data,
+            cacheFrame->frame->linesize);
+  av_frame_unref(cacheFrame->source);
+  cacheFrame->converted.store(true, std::memory_order_release);
+}
+
 /*
  * This thread is used to load video frame asynchronously.
  * It provides a frame caching service.
  * The main thread is responsible for positioning the frame pointer in the
  * file correctly before calling startCache() which starts this thread.
  * The cache is organized in two layers: 1) a cache of 20-30 undecoded packets to keep
- * memory and CPU low 2) a cache of 5 decoded frames.
- * If the main thread does not find the frame in the cache (because the video has restarted
- * or because the GE is lagging), it stops the cache with StopCache() (this is a synchronous
- * function: it sends a signal to stop the cache thread and wait for confirmation), then
- * change the position in the stream and restarts the cache thread.
+ * memory and CPU low 2) a pool of m_cacheSize decoded frames.
+ * Decoded frames are converted to RGB by the task scheduler and handed to the main thread
+ * in decoding order through a lock free ring, the main thread gives them back through
+ * another ring once displayed.
+ * For files, the thread restarts at the beginning of the range when it reaches its end,
+ * the frames are tagged with the loop number so that a repeat doesn't need to flush the cache.
+ * If the main thread does not find the frame in the cache (because the video has been
+ * rewound or because the GE is lagging), it stops the cache with StopCache() (this is a
+ * synchronous function: it sends a signal to stop the cache thread and wait for confirmation),
+ * then change the position in the stream and restarts the cache thread.
  */
 void *VideoFFmpeg::cacheThread(void *data)
 {
@@ -352,39 +532,60 @@ void *VideoFFmpeg::cacheThread(void *data)
   // holds the frame that is being decoded
   CacheFrame *currentFrame = nullptr;
   CachePacket *cachePacket;
+  // frames being converted, they are handed to the main thread in decoding order
+  std::deque<CacheFrame *> convertFrames;
+  TaskPool *pool = BLI_task_pool_create(nullptr, TASK_PRIORITY_HIGH);
+  unsigned int loop = 0;
   bool endOfFile = false;
-  int frameFinished = 0;
-  double timeBase = av_q2d(video->m_formatCtx->streams[video->m_videoStream]->time_base);
-  int64_t startTs = video->m_formatCtx->streams[video->m_videoStream]->start_time;
-
-  if (startTs == AV_NOPTS_VALUE)
-    startTs = 0;
+  bool draining = false;
+  // the range can't be decoded again, only the converted frames are still handed out
+  bool stopped = false;
+  int skippedPackets;
+
+  // restart decoding at the beginning of the range for the next loop
+  auto restartRange = [&]() {
+    if (!video->seekKeyFrame(video->m_cacheStartFrame)) {
+      stopped = true;
+      return;
+    }
+    while ((cachePacket = (CachePacket *)video->m_packetCacheBase.first) != nullptr) {
+      BLI_remlink(&video->m_packetCacheBase, cachePacket);
+      av_packet_unref(&cachePacket->packet);
+      BLI_addtail(&video->m_packetCacheFree, cachePacket);
+    }
+    endOfFile = false;
+    draining = false;
+    loop++;
+  };
 
   while (!video->m_stopThread) {
+    bool progress = false;
     // packet cache is used solely by this thread, no need to lock
     // In case the stream/file contains other stream than the one we are looking for,
     // allow a bit of cycling to get rid quickly of those frames
-    frameFinished = 0;
-    while (!endOfFile &&
+    skippedPackets = 0;
+    while (!stopped && !endOfFile &&
            (cachePacket = (CachePacket *)video->m_packetCacheFree.first) != nullptr &&
-           frameFinished < 25) {
+           skippedPackets < 25) {
       // free packet => packet cache is not full yet, just read more
       if (av_read_frame(video->m_formatCtx, &cachePacket->packet) >= 0) {
         if (cachePacket->packet.stream_index == video->m_videoStream) {
           // make sure fresh memory is allocated for the packet and move it to queue
           AVPacket newPacket;
           av_packet_ref(&newPacket, &cachePacket->packet);
+          av_packet_unref(&cachePacket->packet);
           cachePacket->packet = newPacket;
 
           BLI_remlink(&video->m_packetCacheFree, cachePacket);
           BLI_addtail(&video->m_packetCacheBase, cachePacket);
+          progress = true;
           break;
         }
         else {
           // this is not a good packet for us, just leave it on free queue
           // Note: here we could handle sound packet
           av_packet_unref(&cachePacket->packet);
-          frameFinished++;
+          skippedPackets++;
         }
       }
       else {
@@ -395,82 +596,104 @@ void *VideoFFmpeg::cacheThread(void *data)
         break;
       }
     }
-    // frame cache is also used by main thread, lock
-    if (currentFrame == nullptr) {
-      // no current frame being decoded, take free one
-      pthread_mutex_lock(&video->m_cacheMutex);
-      if ((currentFrame = (CacheFrame *)video->m_frameCacheFree.first) != nullptr)
-        BLI_remlink(&video->m_frameCacheFree, currentFrame);
-      pthread_mutex_unlock(&video->m_cacheMutex);
+
+    // hand the converted frames to the main thread
+    while (!convertFrames.empty() &&
+           convertFrames.front()->converted.load(std::memory_order_acquire)) {
+      // the ready ring is as large as the pool, it can't be full
+      video->m_frameReady.push(convertFrames.front());
+      convertFrames.pop_front();
+      progress = true;
     }
-    if (currentFrame != nullptr) {
-      // this frame is out of free and busy queue, we can manipulate it without locking
-      frameFinished = 0;
-      while (!frameFinished &&
-             (cachePacket = (CachePacket *)video->m_packetCacheBase.first) != nullptr) {
-        BLI_remlink(&video->m_packetCacheBase, cachePacket);
-        // use m_frame because when caching, it is not used in main thread
-        // we can't use currentFrame directly because we need to convert to RGB first
-        avcodec_send_packet(video->m_codecCtx, &cachePacket->packet);
-        frameFinished = avcodec_receive_frame(video->m_codecCtx, video->m_frame) == 0;
-
-        if (frameFinished) {
-          AVFrame *input = video->m_frame;
-
-          /* This means the data wasnt read properly, this check stops crashing */
-          if (input->data[0] != 0 || input->data[1] != 0 || input->data[2] != 0 ||
-              input->data[3] != 0) {
-            if (video->m_deinterlace) {
-              if (ffmpeg_deinterlace((AVFrame *)video->m_frameDeinterlaced,
-                                       (const AVFrame *)video->m_frame,
-                                       video->m_codecCtx->pix_fmt,
-                                       video->m_codecCtx->width,
-                                       video->m_codecCtx->height) >= 0) {
-                input = video->m_frameDeinterlaced;
-              }
-            }
-            // convert to RGB24
-            sws_scale(video->m_imgConvertCtx,
-                      input->data,
-                      input->linesize,
-                      0,
-                      video->m_codecCtx->height,
-                      currentFrame->frame->data,
-                      currentFrame->frame->linesize);
-            // move frame to queue, this frame is necessarily the next one
-            video->m_curPosition = (long)((cachePacket->packet.dts - startTs) *
-                                              (video->m_baseFrameRate * timeBase) +
-                                          0.5);
-            currentFrame->framePosition = video->m_curPosition;
-            pthread_mutex_lock(&video->m_cacheMutex);
-            BLI_addtail(&video->m_frameCacheBase, currentFrame);
-            pthread_mutex_unlock(&video->m_cacheMutex);
-            currentFrame = nullptr;
-          }
+
+    if (stopped && convertFrames.empty()) {
+      break;
+    }
+
+    while (!stopped && !video->m_stopThread) {
+      if (currentFrame == nullptr) {
+        // no current frame being decoded, take free one
+        if ((currentFrame = video->m_frameFree.front()) == nullptr)
+          break;
+        video->m_frameFree.pop();
+      }
+
+      // this frame is out of the rings, we can manipulate it without locking
+      const int ret = avcodec_receive_frame(video->m_codecCtx, currentFrame->source);
+      if (ret == AVERROR(EAGAIN)) {
+        // the decoder needs more packets
+        if ((cachePacket = (CachePacket *)video->m_packetCacheBase.first) != nullptr) {
+          BLI_remlink(&video->m_packetCacheBase, cachePacket);
+          avcodec_send_packet(video->m_codecCtx, &cachePacket->packet);
+          av_packet_unref(&cachePacket->packet);
+          BLI_addtail(&video->m_packetCacheFree, cachePacket);
+          progress = true;
+          continue;
         }
-        av_packet_unref(&cachePacket->packet);
-        BLI_addtail(&video->m_packetCacheFree, cachePacket);
+        if (endOfFile && !draining) {
+          // no more packet, get the frames delayed in the decoder
+          avcodec_send_packet(video->m_codecCtx, nullptr);
+          draining = true;
+          continue;
+        }
+        break;
       }
-      if (currentFrame && endOfFile) {
-        // no more packet and end of file => put a special frame that indicates that
-        currentFrame->framePosition = -1;
-        pthread_mutex_lock(&video->m_cacheMutex);
-        BLI_addtail(&video->m_frameCacheBase, currentFrame);
-        pthread_mutex_unlock(&video->m_cacheMutex);
-        currentFrame = nullptr;
-        // no need to stay any longer in this thread
+      if (ret < 0) {
+        if (ret == AVERROR_EOF && video->m_isFile) {
+          // end of the file before the end of the range
+          restartRange();
+          progress = true;
+        }
         break;
       }
+
+      AVFrame *input = currentFrame->source;
+      /* This means the data wasnt read properly, this check stops crashing */
+      if (input->data[0] == 0 && input->data[1] == 0 && input->data[2] == 0 &&
+          input->data[3] == 0) {
+        av_frame_unref(input);
+        continue;
+      }
+
+      // frame position from the presentation timestamp of the frame, not of the last packet
+      const int64_t ts = (input->best_effort_timestamp != AV_NOPTS_VALUE) ?
+                             input->best_effort_timestamp :
+                             input->pkt_dts;
+      const long position = video->timestampToPosition(ts);
+      if (video->m_isFile) {
+        if (position >= video->m_cacheEndFrame) {
+          // end of the range: decode the next loop
+          av_frame_unref(input);
+          restartRange();
+          progress = true;
+          break;
+        }
+        if (position < video->m_cacheStartFrame) {
+          // frame between the key frame and the beginning of the range
+          av_frame_unref(input);
+          continue;
+        }
+      }
+
+      video->m_curPosition = position;
+      currentFrame->framePosition = position;
+      currentFrame->loop = loop;
+      currentFrame->converted.store(false, std::memory_order_relaxed);
+      BLI_task_pool_push(pool, convertFrameTask, currentFrame, false, nullptr);
+      convertFrames.push_back(currentFrame);
+      currentFrame = nullptr;
+      progress = true;
     }
+
     // small sleep to avoid unnecessary looping
-    BLI_time_sleep_ms(10);
-  }
-  // before quitting, put back the current frame to queue to allow freeing
-  if (currentFrame) {
-    pthread_mutex_lock(&video->m_cacheMutex);
-    BLI_addtail(&video->m_frameCacheFree, currentFrame);
-    pthread_mutex_unlock(&video->m_cacheMutex);
+    if (!progress)
+      BLI_time_sleep_ms(convertFrames.empty() ? 10 : 1);
   }
+  // the frames are put back in the free ring by stopCache()
+  BLI_task_pool_work_and_wait(pool);
+  BLI_task_pool_free(pool);
+  // set after the last frames are handed out, the main thread sees it once they are displayed
+  video->m_cacheEndOfFile.store(stopped, std::memory_order_release);
   return 0;
 }
 
@@ -481,15 +704,38 @@ bool VideoFFmpeg::startCache()
 {
   if (!m_cacheStarted && m_isThreaded) {
     m_stopThread = false;
-    for (int i = 0; i < CACHE_FRAME_SIZE; i++) {
-      CacheFrame *frame = new CacheFrame();
-      frame->frame = allocFrameRGB();
-      BLI_addtail(&m_frameCacheFree, frame);
+    m_cacheEndOfFile = false;
+    // the frame buffers are kept between restarts of the cache, unless the size changed
+    if (m_framePool.size() != (size_t)m_cacheSize) {
+      freeCachePool();
+      for (int i = 0; i < m_cacheSize; i++) {
+        CacheFrame *frame = new CacheFrame();
+        frame->video = this;
+        frame->framePosition = -1;
+        frame->loop = 0;
+        frame->source = av_frame_alloc();
+        frame->deinterlaced = nullptr;
+        frame->frame = allocFrameRGB();
+        frame->convertCtx = createConvertContext();
+        frame->converted = false;
+        m_framePool.push_back(frame);
+      }
     }
-    for (int i = 0; i < CACHE_PACKET_SIZE; i++) {
-      CachePacket *packet = new CachePacket();
-      BLI_addtail(&m_packetCacheFree, packet);
+    m_frameReady.reset(m_framePool.size());
+    m_frameFree.reset(m_framePool.size());
+    for (CacheFrame *frame : m_framePool) {
+      m_frameFree.push(frame);
+    }
+    if (BLI_listbase_is_empty(&m_packetCacheFree)) {
+      for (int i = 0; i < CACHE_PACKET_SIZE; i++) {
+        CachePacket *packet = new CachePacket();
+        BLI_addtail(&m_packetCacheFree, packet);
+      }
     }
+    // the cache thread loops over the range by itself
+    m_cacheLoop = 0;
+    m_cacheStartFrame = long(m_range[0] * m_baseFrameRate);
+    m_cacheEndFrame = (m_range[1] > m_range[0]) ? long(m_range[1] * m_baseFrameRate) : LONG_MAX;
     BLI_threadpool_init(&m_thread, cacheThread, 1);
     BLI_threadpool_insert(&m_thread, this);
     m_cacheStarted = true;
@@ -502,34 +748,42 @@ void VideoFFmpeg::stopCache()
   if (m_cacheStarted) {
     m_stopThread = true;
     BLI_threadpool_end(&m_thread);
-    // now delete the cache
-    CacheFrame *frame;
-    CachePacket *packet;
-    while ((frame = (CacheFrame *)m_frameCacheBase.first) != nullptr) {
-      BLI_remlink(&m_frameCacheBase, frame);
-      MEM_freeN(frame->frame->data[0]);
-      av_free(frame->frame);
-      delete frame;
-    }
-    while ((frame = (CacheFrame *)m_frameCacheFree.first) != nullptr) {
-      BLI_remlink(&m_frameCacheFree, frame);
-      MEM_freeN(frame->frame->data[0]);
-      av_free(frame->frame);
-      delete frame;
+    // the frames go back to the pool, the buffers are reused by the next start
+    for (CacheFrame *frame : m_framePool) {
+      av_frame_unref(frame->source);
     }
+    CachePacket *packet;
     while ((packet = (CachePacket *)m_packetCacheBase.first) != nullptr) {
       BLI_remlink(&m_packetCacheBase, packet);
       av_packet_unref(&packet->packet);
-      delete packet;
-    }
-    while ((packet = (CachePacket *)m_packetCacheFree.first) != nullptr) {
-      BLI_remlink(&m_packetCacheFree, packet);
-      delete packet;
+      BLI_addtail(&m_packetCacheFree, packet);
     }
     m_cacheStarted = false;
   }
 }
 
+void VideoFFmpeg::freeCachePool()
+{
+  for (CacheFrame *frame : m_framePool) {
+    av_frame_free(&frame->source);
+    if (frame->deinterlaced) {
+      MEM_freeN(frame->deinterlaced->data[0]);
+      av_frame_free(&frame->deinterlaced);
+    }
+    MEM_freeN(frame->frame->data[0]);
+    av_frame_free(&frame->frame);
+    sws_freeContext(frame->convertCtx);
+    delete frame;
+  }
+  m_framePool.clear();
+
+  CachePacket *packet;
+  while ((packet = (CachePacket *)m_packetCacheFree.first) != nullptr) {
+    BLI_remlink(&m_packetCacheFree, packet);
+    delete packet;
+  }
+}
+
 void VideoFFmpeg::releaseFrame(AVFrame *frame)
 {
   if (frame == m_frameRGB) {
@@ -537,12 +791,10 @@ void VideoFFmpeg::releaseFrame(AVFrame *frame)
     return;
   }
   // this frame MUST be the first one of the queue
-  pthread_mutex_lock(&m_cacheMutex);
-  CacheFrame *cacheFrame = (CacheFrame *)m_frameCacheBase.first;
+  CacheFrame *cacheFrame = m_frameReady.front();
   assert(cacheFrame != nullptr && cacheFrame->frame == frame);
-  BLI_remlink(&m_frameCacheBase, cacheFrame);
-  BLI_addtail(&m_frameCacheFree, cacheFrame);
-  pthread_mutex_unlock(&m_cacheMutex);
+  m_frameReady.pop();
+  m_frameFree.push(cacheFrame);
 }
 
 // open video file
@@ -590,6 +842,10 @@ void VideoFFmpeg::openFile(char *filename)
     m_avail = false;
     play();
   }
+  if (m_isFile) {
+    // seeks go exactly to the key frame before the requested frame
+    buildKeyFrameIndex();
+  }
   // check if we should do multi-threading?
   if (!m_isImage && BLI_system_thread_count() > 1) {
     // never thread image: there are no frame to read ahead
@@ -742,6 +998,8 @@ void VideoFFmpeg::setRange(double start, double stop)
   try {
     // set range
     if (m_isFile) {
+      // the cache thread decodes the previous range
+      stopCache();
       VideoBase::setRange(start, stop);
       // set range for video
       setPositions();
@@ -781,8 +1039,6 @@ void VideoFFmpeg::calcImage(unsigned int texId, double ts)
     }
     // if video has ended
     if (m_isFile && actTime * m_frameRate >= m_range[1]) {
-      // in any case, this resets the cache
-      stopCache();
       // if repeats are set, decrease them
       if (m_repeat > 0)
         --m_repeat;
@@ -791,9 +1047,12 @@ void VideoFFmpeg::calcImage(unsigned int texId, double ts)
         // reset its position
         actTime -= (m_range[1] - m_range[0]) / m_frameRate;
         m_startTime += (m_range[1] - m_range[0]) / m_frameRate;
+        // the cache thread already decodes the next loop, keep its frames
+        ++m_cacheLoop;
       }
       // if video has to be stopped, stop it
       else {
+        stopCache();
         m_status = SourceStopped;
         return;
       }
@@ -862,118 +1121,84 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
   int frameFinished;
   int posFound = 1;
   bool frameLoaded = false;
-  int64_t targetTs = 0;
   CacheFrame *frame;
   int64_t dts = 0;
 
   if (m_cacheStarted) {
+    // position of the last frame skipped
+    long skippedPosition = -1;
     // when cache is active, we must not read the file directly
     do {
-      pthread_mutex_lock(&m_cacheMutex);
-      frame = (CacheFrame *)m_frameCacheBase.first;
-      pthread_mutex_unlock(&m_cacheMutex);
-      // no need to remove the frame from the queue: the cache thread does not touch the head, only
-      // the tail
+      // no need to remove the frame from the ring: the cache thread does not touch the head,
+      // only the tail
+      frame = m_frameReady.front();
       if (frame == nullptr) {
-        // no frame in cache, in case of file it is an abnormal situation
-        if (m_isFile) {
-          // go back to no threaded reading
-          stopCache();
-          break;
+        // the cache thread stopped at the end of the file, the ring is checked again as the
+        // thread could have handed out its last frame before
+        if (m_cacheEndOfFile.load(std::memory_order_acquire) &&
+            m_frameReady.front() == nullptr) {
+          m_eof = true;
+          return nullptr;
+        }
+        // no frame in cache, the decoding is late
+        if (m_isFile && skippedPosition != -1) {
+          const int key = findKeyFrame(position);
+          if (key != -1 && m_keyFrames[key] > skippedPosition + 1) {
+            // seeking to the next key frame is faster than decoding up to it
+            stopCache();
+            break;
+          }
         }
         return nullptr;
       }
-      if (frame->framePosition == -1) {
-        // this frame mark the end of the file (only used for file)
-        // leave in cache to make sure we don't miss it
-        m_eof = true;
-        return nullptr;
-      }
-      // for streaming, always return the next frame,
-      // that's what grabFrame does in non cache mode anyway.
-      if (m_isStreaming || frame->framePosition == position) {
-        return frame->frame;
+      if (frame->loop != m_cacheLoop) {
+        if ((int)(frame->loop - m_cacheLoop) > 0) {
+          // the cache thread is already decoding the next loop, the current one is not finished
+          return nullptr;
+        }
+        // the frame is from a previous loop, skip it
       }
-      // for cam, skip old frames to keep image realtime.
-      // There should be no risk of clock drift since it all happens on the same CPU
-      if (frame->framePosition > position) {
-        // this can happen after rewind if the seek didn't find the first frame
-        // the frame in the buffer is ahead of time, just leave it there
-        return nullptr;
+      else {
+        // for streaming, always return the next frame,
+        // that's what grabFrame does in non cache mode anyway.
+        if (m_isStreaming || frame->framePosition == position) {
+          return frame->frame;
+        }
+        // for cam, skip old frames to keep image realtime.
+        // There should be no risk of clock drift since it all happens on the same CPU
+        if (frame->framePosition > position) {
+          // this can happen after rewind if the seek didn't find the first frame
+          // the frame in the buffer is ahead of time, just leave it there
+          return nullptr;
+        }
+        skippedPosition = frame->framePosition;
       }
       // this frame is not useful, release it
-      pthread_mutex_lock(&m_cacheMutex);
-      BLI_remlink(&m_frameCacheBase, frame);
-      BLI_addtail(&m_frameCacheFree, frame);
-      pthread_mutex_unlock(&m_cacheMutex);
+      m_frameReady.pop();
+      m_frameFree.push(frame);
     } while (true);
   }
-  double timeBase = av_q2d(m_formatCtx->streams[m_videoStream]->time_base);
-  int64_t startTs = m_formatCtx->streams[m_videoStream]->start_time;
-  if (startTs == AV_NOPTS_VALUE)
-    startTs = 0;
 
   // come here when there is no cache or cache has been stopped
   // locate the frame, by seeking if necessary (seeking is only possible for files)
   if (m_isFile) {
-    // first check if the position that we are looking for is in the preseek range
-    // if so, just read the frame until we get there
-    if (position > m_curPosition + 1 && m_preseek && position - (m_curPosition + 1) < m_preseek) {
-      while (av_read_frame(m_formatCtx, &packet) >= 0) {
-        if (packet.stream_index == m_videoStream) {
-          avcodec_send_packet(m_codecCtx, &packet);
-          frameFinished = avcodec_receive_frame(m_codecCtx, m_frame) == 0;
-
-          if (frameFinished) {
-            m_curPosition = (long)((packet.dts - startTs) * (m_baseFrameRate * timeBase) + 0.5);
-          }
-        }
-        av_packet_unref(&packet);
-        if (position == m_curPosition + 1)
-          break;
-      }
-    }
-    // if the position is not in preseek, do a direct jump
     if (position != m_curPosition + 1) {
-      int64_t pos = (int64_t)((position - m_preseek) / (m_baseFrameRate * timeBase));
-
-      if (pos < 0)
-        pos = 0;
-
-      pos += startTs;
-
-      if (position <= m_curPosition || !m_eof) {
-#  if 0
-				// Tried to make this work but couldn't: seeking on byte is ignored by the
-				// format plugin and it will generally continue to read from last timestamp.
-				// Too bad because frame seek is not always able to get the first frame
-				// of the file.
-				if (position <= m_preseek)
-				{
-					// we can safely go the beginning of the file
-					if (av_seek_frame(m_formatCtx, m_videoStream, 0, AVSEEK_FLAG_BYTE) >= 0)
-					{
-						// binary seek does not reset the timestamp, must do it now
-						av_update_cur_dts(m_formatCtx, m_formatCtx->streams[m_videoStream], startTs);
-						m_curPosition = 0;
-					}
-				}
-				else
-#  endif
-        {
+      const int key = findKeyFrame(position);
+      // decoding up to the position is cheaper than seeking when there is no key frame between
+      bool decodeForward = position > m_curPosition + 1;
+      if (decodeForward) {
+        decodeForward = (key != -1) ? m_keyFrames[key] <= m_curPosition + 1 :
+                                      (m_preseek && position - (m_curPosition + 1) < m_preseek);
+      }
+      if (!decodeForward && (position <= m_curPosition || !m_eof)) {
+        if (seekKeyFrame(position)) {
           // current position is now lost, guess a value.
-          if (av_seek_frame(m_formatCtx, m_videoStream, pos, AVSEEK_FLAG_BACKWARD) >= 0) {
-            // current position is now lost, guess a value.
-            // It's not important because it will be set at this end of this function
-            m_curPosition = position - m_preseek - 1;
-          }
+          // It's not important because it will be set at this end of this function
+          m_curPosition = ((key != -1) ? m_keyFrames[key] : position - m_preseek) - 1;
         }
       }
-      // this is the timestamp of the frame we're looking for
-      targetTs = (int64_t)(position / (m_baseFrameRate * timeBase)) + startTs;
-
+      // the frames before the one we're looking for are decoded but not converted
       posFound = 0;
-      avcodec_flush_buffers(m_codecCtx);
     }
   }
   else if (m_isThreaded) {
@@ -1003,10 +1228,13 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
                 input->data[3] == 0) &&
                counter < 10 && m_isImage);
 
-      // remember dts to compute exact frame number
-      dts = packet.dts;
+      // remember the frame timestamp to compute exact frame number
+      if (frameFinished) {
+        dts = (m_frame->best_effort_timestamp != AV_NOPTS_VALUE) ? m_frame->best_effort_timestamp :
+                                                                   packet.dts;
+      }
       if (frameFinished && !posFound) {
-        if (dts >= targetTs) {
+        if (timestampToPosition(dts) >= position) {
           posFound = 1;
         }
       }
@@ -1048,7 +1276,7 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
   }
   m_eof = m_isFile && !frameLoaded;
   if (frameLoaded) {
-    m_curPosition = (long)((dts - startTs) * (m_baseFrameRate * timeBase) + 0.5);
+    m_curPosition = timestampToPosition(dts);
     if (m_isThreaded) {
       // normal case for file: first locate, then start cache
       if (!startCache()) {
@@ -1160,6 +1388,26 @@ static int VideoFFmpeg_setDeinterlace(PyImage *self, PyObject *value, void *clos
   return 0;
 }
 
+// get cache size
+static PyObject *VideoFFmpeg_getCacheSize(PyImage *self, void *closure)
+{
+  return Py_BuildValue("i", getFFmpeg(self)->getCacheSize());
+}
+
+// set cache size
+static int VideoFFmpeg_setCacheSize(PyImage *self, PyObject *value, void *closure)
+{
+  // check validity of parameter
+  if (value == nullptr || !PyLong_Check(value) || PyLong_AsLong(value) < 1) {
+    PyErr_SetString(PyExc_TypeError, "The value must be a positive integer");
+    return -1;
+  }
+  // set cache size
+  getFFmpeg(self)->setCacheSize(PyLong_AsLong(value));
+  // success
+  return 0;
+}
+
 // methods structure
 static PyMethodDef videoMethods[] = {  // methods from VideoBase class
     {"play", (PyCFunction)Video_play, METH_NOARGS, "Play (restart) video"},
@@ -1218,6 +1466,11 @@ static PyGetSetDef videoGetSets[] = {  // methods from VideoBase class
      (setter)VideoFFmpeg_setDeinterlace,
      (char *)"deinterlace image",
      nullptr},
+    {(char *)"cacheSize",
+     (getter)VideoFFmpeg_getCacheSize,
+     (setter)VideoFFmpeg_setCacheSize,
+     (char *)"nb of frames decoded ahead",
+     nullptr},
     {nullptr}};
 
 // python type declaration
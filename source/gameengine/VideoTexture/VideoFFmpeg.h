@@ -15,6 +15,9 @@
 
 #  include <pthread.h>
 
+#  include <atomic>
+#  include <vector>
+
 #  include "BLI_blenlib.h"
 #  include "BLI_threads.h"
 #  include "DNA_listBase.h"
@@ -27,6 +30,9 @@ extern "C" {
 
 #  include "VideoBase.h"
 
+struct TaskPool;
+
+/// default number of decoded frames read ahead by the cache thread
 #  define CACHE_FRAME_SIZE 10
 #  define CACHE_PACKET_SIZE 30
 
@@ -81,6 +87,16 @@ class VideoFFmpeg : public VideoBase {
   {
     return (m_isImage) ? (char *)m_imageName.c_str() : nullptr;
   }
+  int getCacheSize(void)
+  {
+    return m_cacheSize;
+  }
+  /// set the number of frames read ahead, applied when the cache is (re)started
+  void setCacheSize(int size)
+  {
+    if (size > 0)
+      m_cacheSize = size;
+  }
 
  protected:
   AVFormatContext *m_formatCtx;
@@ -139,6 +155,11 @@ class VideoFFmpeg : public VideoBase {
   /// keep last image name
   std::string m_imageName;
 
+  /// position in frames of the key frames of the file, sorted
+  std::vector<long> m_keyFrames;
+  /// timestamp in stream time base of the key frames
+  std::vector<int64_t> m_keyTimestamps;
+
   /// image calculation
   virtual void calcImage(unsigned int texId, double ts);
 
@@ -154,6 +175,20 @@ class VideoFFmpeg : public VideoBase {
   /// common function to video file and capture
   int openStream(const char *filename, const AVInputFormat *inputFormat, AVDictionary **formatParams);
 
+  /// create a context converting decoded frames to RGB
+  struct SwsContext *createConvertContext();
+
+  /// convert a timestamp in stream time base to a frame position and inversely
+  long timestampToPosition(int64_t ts);
+  int64_t positionToTimestamp(long position);
+
+  /// read the key frames of the file from the container index or by scanning the packets
+  void buildKeyFrameIndex();
+  /// return the index of the last key frame at or before position, -1 if unknown
+  int findKeyFrame(long position);
+  /// seek to the last key frame at or before position and flush the decoder
+  bool seekKeyFrame(long position);
+
   /// check if a frame is available and load it in pFrame, return true if a frame could be
   /// retrieved
   AVFrame *grabFrame(long frame);
@@ -166,27 +201,68 @@ class VideoFFmpeg : public VideoBase {
   void stopCache();
 
  private:
-  typedef struct {
-    Link link;
+  struct CacheFrame {
+    VideoFFmpeg *video;
     long framePosition;
+    /// loop of the cache thread the frame was decoded in
+    unsigned int loop;
+    /// frame as returned by the decoder, converted to RGB on a worker thread
+    AVFrame *source;
+    AVFrame *deinterlaced;
+    /// RGB frame
     AVFrame *frame;
-  } CacheFrame;
+    /// sws contexts are not thread safe, each frame has its own
+    struct SwsContext *convertCtx;
+    std::atomic<bool> converted;
+  };
   typedef struct {
     Link link;
     AVPacket packet;
   } CachePacket;
 
-  bool m_stopThread;
+  /// Lock free ring of frames between a single producer thread and a single consumer thread.
+  class FrameRing {
+   private:
+    std::vector<CacheFrame *> m_items;
+    std::atomic<unsigned int> m_head;
+    std::atomic<unsigned int> m_tail;
+
+   public:
+    FrameRing();
+    /// empty the ring, only when no thread is using it
+    void reset(unsigned int capacity);
+    /// called by the producer, return false if the ring is full
+    bool push(CacheFrame *frame);
+    /// called by the consumer, return nullptr if the ring is empty
+    CacheFrame *front();
+    void pop();
+  };
+
+  std::atomic<bool> m_stopThread;
+  /// set by the cache thread when it stopped because the range can't be decoded again
+  std::atomic<bool> m_cacheEndOfFile;
   bool m_cacheStarted;
+  /// number of frames read ahead
+  int m_cacheSize;
   ListBase m_thread;
-  ListBase m_frameCacheBase;   // list of frames that are ready
-  ListBase m_frameCacheFree;   // list of frames that are unused
+  /// all the frames of the cache, kept when the cache is restarted
+  std::vector<CacheFrame *> m_framePool;
+  /// frames ready to display, filled by the cache thread
+  FrameRing m_frameReady;
+  /// frames unused, filled by the main thread
+  FrameRing m_frameFree;
   ListBase m_packetCacheBase;  // list of packets that are ready for decoding
   ListBase m_packetCacheFree;  // list of packets that are unused
-  pthread_mutex_t m_cacheMutex;
+  /// loop of the frames displayed, the cache thread restarts the range itself
+  unsigned int m_cacheLoop;
+  /// range in frames decoded by the cache thread
+  long m_cacheStartFrame;
+  long m_cacheEndFrame;
 
   AVFrame *allocFrameRGB();
+  void freeCachePool();
   static void *cacheThread(void *);
+  static void convertFrameTask(TaskPool *__restrict pool, void *taskdata);
 };
 
 inline VideoFFmpeg *getFFmpeg(PyImage *self)
@@ -0,0 +1,106 @@
+# SPDX-FileCopyrightText: 2026 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import json
+import pathlib
+import tempfile
+
+from .test import Test
+
+# Python module shared by the game logic of the tests, added to the blend files by
+# add_game_module and imported by their game scripts.
+GAME_MODULE_NAME = "bge_bench"
+GAME_MODULE = '''
+import bge
+import json
+import time
+
+
+def read_config():
+    # Configuration written by the test next to the blend file.
+    with open(bge.logic.expandPath("//config.json")) as f:
+        return json.load(f)
+
+
+def write_result(result):
+    # Result read by the test once the game ended.
+    with open(bge.logic.expandPath("//result.json"), "w") as f:
+        json.dump(result, f)
+
+    bge.logic.endGame()
+
+
+def measure(func, iterations, repeat=3):
+    # Best time in seconds per iteration of func(iterations) over several runs.
+    best_time = None
+    for _ in range(repeat):
+        start_time = time.perf_counter()
+        func(iterations)
+        run_time = (time.perf_counter() - start_time) / iterations
+        if best_time is None or run_time < best_time:
+            best_time = run_time
+    return best_time
+'''
+
+
+def add_game_module():
+    # Add the shared game module to the current blend file, called from Blender.
+    import bpy
+
+    text = bpy.data.texts.new(GAME_MODULE_NAME + ".py")
+    text.from_string(GAME_MODULE)
+
+
+def executable(env) -> pathlib.Path:
+    # The blenderplayer is installed next to Blender.
+    blender = pathlib.Path(env.blender_executable)
+    name = "blenderplayer.exe" if blender.suffix == ".exe" else "blenderplayer"
+    return blender.parent / name
+
+
+def create_game(env, dirpath: pathlib.Path, create_blend, args: dict, config: dict) -> pathlib.Path:
+    # Create the blend file of a game in dirpath with create_blend(args) run in Blender,
+    # and write the configuration read by its game logic.
+    filepath = dirpath / "game.blend"
+    env.run_in_blender(create_blend, dict(args, filepath=str(filepath)))
+    if not filepath.exists():
+        raise Exception("Blend file of the game not created")
+
+    with open(dirpath / "config.json", "w") as f:
+        json.dump(config, f)
+
+    return filepath
+
+
+def run_game(env, filepath: pathlib.Path, player_args: list = []) -> None:
+    # Run the game until it ends, a failure of the blenderplayer raises an exception.
+    env.call([executable(env)] + player_args + [str(filepath)], cwd=filepath.parent)
+
+
+def read_result(dirpath: pathlib.Path) -> dict:
+    # Read the result written by the game logic with write_result.
+    result_path = dirpath / "result.json"
+    if not result_path.exists():
+        raise Exception("Game ended without writing a result")
+
+    with open(result_path) as f:
+        result = json.load(f)
+    if not result:
+        raise Exception("Game wrote an empty result")
+    return result
+
+
+def run_game_test(env, create_blend, args: dict, config: dict, player_args: list = []) -> dict:
+    # Create a game in a temporary directory, run it and return its result.
+    with tempfile.TemporaryDirectory() as tmpdir:
+        dirpath = pathlib.Path(tmpdir)
+        filepath = create_game(env, dirpath, create_blend, args, config)
+        run_game(env, filepath, player_args)
+        return read_result(dirpath)
+
+
+class PlayerTest(Test):
+    def use_background(self):
+        # The blenderplayer always opens a window.
+        return False
@@ -0,0 +1,173 @@
+# SPDX-FileCopyrightText: 2026 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+from api import blenderplayer
+
+# Game logic module measuring walking characters, run by the blenderplayer.
+GAME_SCRIPT = '''
+import bge
+import math
+import time
+from bge import constraints
+from bge_bench import read_config, write_result
+
+# Frames simulated before measuring, to get the characters on the ground.
+SETTLE_FRAMES = 30
+
+
+def _characters(scene):
+    return [o for o in scene.objects if o.name.startswith("Character")]
+
+
+def run(cont):
+    ob = cont.owner
+    scene = bge.logic.getCurrentScene()
+    ob["frame"] = ob.get("frame", 0) + 1
+
+    if ob["frame"] == 1:
+        bge.logic.benchConfig = read_config()
+        bge.logic.benchTimes = []
+        # Each character walks in its own direction, going up and down the heightfield.
+        for i, character in enumerate(_characters(scene)):
+            angle = i * 2.399963
+            walk = (math.cos(angle) * 0.05, math.sin(angle) * 0.05, 0.0)
+            constraints.getCharacter(character).walkDirection = walk
+        return
+
+    if ob["frame"] < SETTLE_FRAMES:
+        return
+
+    now = time.perf_counter()
+    if ob["frame"] == SETTLE_FRAMES:
+        bge.logic.benchStart = [c.worldPosition.copy() for c in _characters(scene)]
+    else:
+        bge.logic.benchTimes.append(now - bge.logic.benchLastTime)
+    bge.logic.benchLastTime = now
+
+    if len(bge.logic.benchTimes) < bge.logic.benchConfig["frames"]:
+        return
+
+    # Distance walked read from the scene graph, the characters must be moved by the physics
+    # whatever the frame pipeline.
+    distances = [(c.worldPosition - start).length
+                 for c, start in zip(_characters(scene), bge.logic.benchStart)]
+    times = sorted(bge.logic.benchTimes)
+    write_result({
+        "time": sum(times) / len(times),
+        "time_median": times[len(times) // 2],
+        "physics_time": bge.logic.getProfileInfo()["Physics:"][0] / 1000.0,
+        "walked_distance": sum(distances) / len(distances),
+    })
+'''
+
+CHARACTER_COUNTS = (100, 300)
+# Frame pipelines of the blenderplayer and their test name suffix, the threaded pipeline
+# simulates the characters while the frame is rendered.
+FRAME_PIPELINES = ((0, ""), (1, "_pipelined"))
+# Minimal average distance walked by the characters during the measured frames.
+MIN_WALKED_DISTANCE = 1.0
+# Number of quads along a side of the heightfield.
+HEIGHTFIELD_RESOLUTION = 128
+HEIGHTFIELD_SIZE = 200.0
+
+
+def _create_blend(args):
+    import bpy
+    import math
+
+    blenderplayer.add_game_module()
+    text = bpy.data.texts.new("bge_character_bench.py")
+    text.from_string(args["script"])
+
+    scene = bpy.context.scene
+    scene.game_settings.use_frame_rate = False
+
+    # Logic owner, without collision to not disturb the characters.
+    ob = bpy.data.objects["Cube"]
+    ob.location = (0.0, 0.0, -100.0)
+    ob.game.physics_type = 'NO_COLLISION'
+
+    # Static heightfield made of rolling hills.
+    res = args["resolution"]
+    size = args["size"]
+    step = size / res
+    verts = []
+    for y in range(res + 1):
+        for x in range(res + 1):
+            px = x * step - size / 2.0
+            py = y * step - size / 2.0
+            verts.append((px, py, math.sin(px * 0.15) * math.cos(py * 0.1) * 2.0))
+    faces = []
+    for y in range(res):
+        for x in range(res):
+            i = y * (res + 1) + x
+            faces.append((i, i + 1, i + res + 2, i + res + 1))
+    mesh = bpy.data.meshes.new("Heightfield")
+    mesh.from_pydata(verts, [], faces)
+    ground = bpy.data.objects.new("Heightfield", mesh)
+    ground.game.physics_type = 'STATIC'
+    ground.game.use_collision_bounds = True
+    ground.game.collision_bounds_type = 'TRIANGLE_MESH'
+    scene.collection.objects.link(ground)
+
+    # Characters spread on a grid above the heightfield.
+    side = math.ceil(math.sqrt(args["characters"]))
+    spacing = size * 0.8 / side
+    for i in range(args["characters"]):
+        character = bpy.data.objects.new("Character%d" % i, ob.data)
+        character.location = ((i % side) * spacing - size * 0.4,
+                              (i // side) * spacing - size * 0.4,
+                              5.0)
+        character.scale = (0.3, 0.3, 0.9)
+        character.game.physics_type = 'CHARACTER'
+        character.game.use_collision_bounds = True
+        character.game.collision_bounds_type = 'CAPSULE'
+        scene.collection.objects.link(character)
+
+    with bpy.context.temp_override(object=ob, active_object=ob):
+        bpy.ops.logic.sensor_add(type='ALWAYS', object=ob.name)
+        bpy.ops.logic.controller_add(type='PYTHON', object=ob.name)
+
+    sensor = ob.game.sensors[-1]
+    sensor.use_pulse_true_level = True
+    controller = ob.game.controllers[-1]
+    controller.mode = 'MODULE'
+    controller.module = "bge_character_bench.run"
+    sensor.link(controller)
+
+    bpy.ops.wm.save_as_mainfile(filepath=args["filepath"])
+    return {}
+
+
+class BGECharacterTest(blenderplayer.PlayerTest):
+    def __init__(self, characters, pipeline, suffix):
+        self.characters = characters
+        self.pipeline = pipeline
+        self.suffix = suffix
+
+    def name(self):
+        return "characters_%d%s" % (self.characters, self.suffix)
+
+    def category(self):
+        return "bge_physics"
+
+    def run(self, env, device_id):
+        result = blenderplayer.run_game_test(env,
+                                             _create_blend,
+                                             {"script": GAME_SCRIPT,
+                                              "characters": self.characters,
+                                              "resolution": HEIGHTFIELD_RESOLUTION,
+                                              "size": HEIGHTFIELD_SIZE},
+                                             {"frames": 300},
+                                             ["-g", "frame_pipeline", "=", str(self.pipeline)])
+        if result["walked_distance"] < MIN_WALKED_DISTANCE:
+            raise Exception("Characters walked %.3f on average, expected at least %.3f" %
+                            (result["walked_distance"], MIN_WALKED_DISTANCE))
+        return result
+
+
+def generate(env):
+    return [BGECharacterTest(characters, pipeline, suffix)
+            for characters in CHARACTER_COUNTS
+            for pipeline, suffix in FRAME_PIPELINES]
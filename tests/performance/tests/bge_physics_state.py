@@ -0,0 +1,112 @@
+# SPDX-FileCopyrightText: 2026 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+from api import blenderplayer
+
+# Game logic module measuring physics snapshots, run by the blenderplayer.
+GAME_SCRIPT = '''
+from bge import constraints
+from bge_bench import measure, read_config, write_result
+
+# Frames simulated before measuring, to get sleeping bodies and contacts.
+SETTLE_FRAMES = 30
+
+
+def _repeat(func):
+    def loop(iterations):
+        for _ in range(iterations):
+            func()
+    return loop
+
+
+def run(cont):
+    ob = cont.owner
+    ob["frame"] = ob.get("frame", 0) + 1
+    if ob["frame"] < SETTLE_FRAMES:
+        return
+    if ob["frame"] == SETTLE_FRAMES:
+        # State of the previous frame, restored alternately with the current one.
+        ob["previous_state"] = constraints.saveState()
+        return
+
+    iterations = read_config()["iterations"]
+
+    states = (ob["previous_state"], constraints.saveState())
+    restore_index = 0
+
+    def restore():
+        nonlocal restore_index
+        restore_index ^= 1
+        constraints.restoreState(states[restore_index])
+
+    # Measured first as saving overwrites the states in the ring buffer.
+    restore_time = measure(_repeat(restore), iterations)
+    save_time = measure(_repeat(constraints.saveState), iterations)
+
+    # The time of a rollback step, restoring a state and saving the new one.
+    write_result({"time": save_time + restore_time,
+                  "save_time": save_time,
+                  "restore_time": restore_time})
+'''
+
+BODY_COUNTS = (1000, 10000)
+
+
+def _create_blend(args):
+    import bpy
+    import math
+
+    blenderplayer.add_game_module()
+    text = bpy.data.texts.new("bge_physics_state_bench.py")
+    text.from_string(args["script"])
+
+    scene = bpy.context.scene
+    ob = bpy.data.objects["Cube"]
+    ob.location = (0.0, 0.0, -10.0)
+    ob.scale = (1000.0, 1000.0, 1.0)
+
+    # Stacks of rigid bodies falling on the ground cube.
+    mesh = bpy.data.meshes.new_from_object(ob)
+    side = math.ceil(math.sqrt(args["bodies"] / 10))
+    for i in range(args["bodies"]):
+        body = bpy.data.objects.new("Body%d" % i, mesh)
+        body.location = ((i % side) * 3.0, ((i // side) % side) * 3.0, (i // (side * side)) * 2.1)
+        body.scale = (0.5, 0.5, 0.5)
+        body.game.physics_type = 'RIGID_BODY'
+        scene.collection.objects.link(body)
+
+    with bpy.context.temp_override(object=ob, active_object=ob):
+        bpy.ops.logic.sensor_add(type='ALWAYS', object=ob.name)
+        bpy.ops.logic.controller_add(type='PYTHON', object=ob.name)
+
+    sensor = ob.game.sensors[-1]
+    sensor.use_pulse_true_level = True
+    controller = ob.game.controllers[-1]
+    controller.mode = 'MODULE'
+    controller.module = "bge_physics_state_bench.run"
+    sensor.link(controller)
+
+    bpy.ops.wm.save_as_mainfile(filepath=args["filepath"])
+    return {}
+
+
+class BGEPhysicsStateTest(blenderplayer.PlayerTest):
+    def __init__(self, bodies):
+        self.bodies = bodies
+
+    def name(self):
+        return "save_restore_%d" % self.bodies
+
+    def category(self):
+        return "bge_physics"
+
+    def run(self, env, device_id):
+        return blenderplayer.run_game_test(env,
+                                           _create_blend,
+                                           {"script": GAME_SCRIPT, "bodies": self.bodies},
+                                           {"iterations": 100})
+
+
+def generate(env):
+    return [BGEPhysicsStateTest(bodies) for bodies in BODY_COUNTS]
@@ -0,0 +1,135 @@
+# SPDX-FileCopyrightText: 2026 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+from api import blenderplayer
+
+# Game logic module measuring python attribute access, run by the blenderplayer.
+GAME_SCRIPT = '''
+from bge_bench import measure, read_config, write_result
+
+
+def _world_position_read(ob, iterations):
+    for _ in range(iterations):
+        ob.worldPosition
+
+
+def _world_position_write(ob, iterations):
+    pos = ob.worldPosition.copy()
+    for _ in range(iterations):
+        ob.worldPosition = pos
+
+
+def _world_position_component_read(ob, iterations):
+    for _ in range(iterations):
+        ob.worldPosition.x
+
+
+def _local_orientation_read(ob, iterations):
+    for _ in range(iterations):
+        ob.localOrientation
+
+
+def _name_read(ob, iterations):
+    for _ in range(iterations):
+        ob.name
+
+
+def _property_read(ob, iterations):
+    for _ in range(iterations):
+        ob["health"]
+
+
+def _property_write(ob, iterations):
+    for i in range(iterations):
+        ob["health"] = i
+
+
+def _property_contains(ob, iterations):
+    for _ in range(iterations):
+        "health" in ob
+
+
+CASES = {
+    "world_position_read": _world_position_read,
+    "world_position_write": _world_position_write,
+    "world_position_component_read": _world_position_component_read,
+    "local_orientation_read": _local_orientation_read,
+    "name_read": _name_read,
+    "property_read": _property_read,
+    "property_write": _property_write,
+    "property_contains": _property_contains,
+}
+
+
+def run(cont):
+    ob = cont.owner
+    # A few properties to get a realistic property table.
+    for i in range(16):
+        ob["prop%d" % i] = i
+    ob["health"] = 100
+
+    config = read_config()
+    func = CASES[config["case"]]
+    iterations = config["iterations"]
+
+    # Warm up.
+    func(ob, iterations // 10)
+    time_per_op = measure(lambda n: func(ob, n), iterations)
+
+    write_result({"time": time_per_op, "ops_per_second": 1.0 / time_per_op})
+'''
+
+CASES = (
+    "world_position_read",
+    "world_position_write",
+    "world_position_component_read",
+    "local_orientation_read",
+    "name_read",
+    "property_read",
+    "property_write",
+    "property_contains",
+)
+
+
+def _create_blend(args):
+    import bpy
+
+    blenderplayer.add_game_module()
+    text = bpy.data.texts.new("bge_python_bench.py")
+    text.from_string(args["script"])
+
+    ob = bpy.data.objects["Cube"]
+    with bpy.context.temp_override(object=ob, active_object=ob):
+        bpy.ops.logic.sensor_add(type='ALWAYS', object=ob.name)
+        bpy.ops.logic.controller_add(type='PYTHON', object=ob.name)
+
+    sensor = ob.game.sensors[-1]
+    controller = ob.game.controllers[-1]
+    controller.mode = 'MODULE'
+    controller.module = "bge_python_bench.run"
+    sensor.link(controller)
+
+    bpy.ops.wm.save_as_mainfile(filepath=args["filepath"])
+    return {}
+
+
+class BGEPythonTest(blenderplayer.PlayerTest):
+    def __init__(self, case):
+        self.case = case
+
+    def name(self):
+        return self.case
+
+    def category(self):
+        return "bge_python"
+
+    def run(self, env, device_id):
+        return blenderplayer.run_game_test(env,
+                                           _create_blend,
+                                           {"script": GAME_SCRIPT},
+                                           {"case": self.case, "iterations": 100000})
+
+
+def generate(env):
+    return [BGEPythonTest(case) for case in CASES]
@@ -0,0 +1,478 @@
+# SPDX-FileCopyrightText: 2026 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+from api import blenderplayer
+import json
+import os
+import pathlib
+import statistics
+import struct
+import tempfile
+
+# Game logic module running the per frame work of a scene, run by the blenderplayer.
+GAME_SCRIPT = '''
+import bge
+import math
+from bge_bench import read_config
+
+# Lifetime in logic frames of the added objects.
+OBJECT_LIFETIME = 30
+
+
+def _setup_streaming(scene, owner, config):
+    streaming = scene.streaming
+    for x in range(config["cells_x"]):
+        for y in range(-1, 2):
+            streaming.addCell(x, y, "//cells/cell_%i_%i.blend" % (x, y))
+    streaming.cellSize = config["cell_size"]
+    streaming.loadRadius = config["cell_size"] * 1.5
+    streaming.unloadRadius = config["cell_size"] * 2.0
+    streaming.focus = owner
+
+
+def _update_add_end_object(scene, owner, config, frame):
+    for i in range(config["count"]):
+        ob = scene.addObject("Template", owner, OBJECT_LIFETIME)
+        ob.worldPosition = ((i % 50) * 2.0, (i // 50) * 2.0, (frame % 10) * 2.0)
+
+
+def _update_scenegraph(scene, owner, config, frame):
+    for root in bge.logic.benchRoots:
+        root.applyRotation((0.0, 0.0, 0.01), True)
+
+
+def _update_raycast(scene, owner, config, frame):
+    origin = owner.worldPosition
+    for i in range(config["count"]):
+        angle = (i + frame * 0.37) * 2.399963
+        target = (math.cos(angle) * 100.0, math.sin(angle) * 100.0, (i % 7) - 3.0)
+        owner.rayCast(target, origin, 100.0)
+
+
+def _update_lod_forest(scene, owner, config, frame):
+    # Fly over the forest to switch the levels of detail.
+    camera = scene.active_camera
+    camera.worldPosition = (frame * 0.5 - 80.0, math.sin(frame * 0.02) * 40.0, 10.0)
+
+
+def _update_streaming(scene, owner, config, frame):
+    owner.worldPosition = (frame * config["speed"], 0.0, 0.0)
+
+
+SETUPS = {
+    "libload_streaming": _setup_streaming,
+}
+
+UPDATES = {
+    "add_end_object": _update_add_end_object,
+    "scenegraph_depth": _update_scenegraph,
+    "scenegraph_width": _update_scenegraph,
+    "raycast_storm": _update_raycast,
+    "lod_forest": _update_lod_forest,
+    "libload_streaming": _update_streaming,
+}
+
+
+def run(cont):
+    ob = cont.owner
+    scene = bge.logic.getCurrentScene()
+    ob["frame"] = ob.get("frame", 0) + 1
+
+    if ob["frame"] == 1:
+        bge.logic.benchConfig = read_config()
+        bge.logic.benchRoots = [o for o in scene.objects if o.name.startswith("Root")]
+        setup = SETUPS.get(bge.logic.benchConfig["scenario"])
+        if setup:
+            setup(scene, ob, bge.logic.benchConfig)
+
+    # The frames are replayed at a fixed rate, the game ends after the last one.
+    update = UPDATES.get(bge.logic.benchConfig["scenario"])
+    if update:
+        update(scene, ob, bge.logic.benchConfig, ob["frame"])
+'''
+
+# Python component of the python_components scene.
+COMPONENT_SCRIPT = '''
+import bge
+from collections import OrderedDict
+
+
+class Spinner(bge.types.KX_PythonComponent):
+    args = OrderedDict()
+
+    def start(self, args):
+        pass
+
+    def update(self):
+        self.object.applyRotation((0.0, 0.0, 0.01), True)
+'''
+
+# Scene name and object counts (or rays per frame) of each test.
+SCENES = (
+    ("physics_stack", (1000, 4000)),
+    ("add_end_object", (50, 200)),
+    ("scenegraph_depth", (100, 500)),
+    ("scenegraph_width", (1000, 10000)),
+    ("logic_bricks", (1000, 5000)),
+    ("python_components", (1000, 5000)),
+    ("raycast_storm", (1000, 10000)),
+    ("lod_forest", (2000, 8000)),
+    ("libload_streaming", (200, 1000)),
+)
+
+# Scenes needing the real render, the other ones only consume the transforms.
+RENDER_SCENES = {"lod_forest"}
+
+TICRATE = 60.0
+# Version of the input record files written by _write_input_record.
+INPUT_RECORD_VERSION = 1
+# Frames skipped before measuring, to get the caches and physics contacts warm.
+WARMUP_FRAMES = 30
+MEASURE_FRAMES = 300
+
+# Chains of objects in the scenegraph_depth scene.
+SCENEGRAPH_CHAINS = 10
+# Streaming cells along the X axis, and their size.
+STREAMING_CELLS_X = 14
+STREAMING_CELL_SIZE = 20.0
+
+# Relative slowdown of a category over its baseline reported as a regression.
+BASELINE_TOLERANCE = 0.15
+# Categories faster than this in seconds per frame are too noisy to be compared.
+BASELINE_MIN_TIME = 0.0002
+
+
+def _new_object(collection, name, data, location=(0.0, 0.0, 0.0), physics_type='NO_COLLISION'):
+    import bpy
+
+    ob = bpy.data.objects.new(name, data)
+    ob.location = location
+    ob.game.physics_type = physics_type
+    collection.objects.link(ob)
+    return ob
+
+
+def _icosphere(name, subdivisions):
+    import bmesh
+    import bpy
+
+    mesh = bpy.data.meshes.new(name)
+    bm = bmesh.new()
+    bmesh.ops.create_icosphere(bm, subdivisions=subdivisions, radius=1.0)
+    bm.to_mesh(mesh)
+    bm.free()
+    return mesh
+
+
+def _build_physics_stack(scene, mesh, templates, args):
+    ground = _new_object(scene.collection, "Ground", mesh, (0.0, 0.0, -1.0), 'STATIC')
+    ground.scale = (200.0, 200.0, 1.0)
+    # Towers of ten boxes.
+    side = max(1, int((args["count"] / 10) ** 0.5))
+    for i in range(args["count"]):
+        tower = i // 10
+        location = ((tower % side) * 3.0 - side * 1.5,
+                    (tower // side) * 3.0 - side * 1.5,
+                    (i % 10) * 1.05 + 0.5)
+        box = _new_object(scene.collection, "Box%d" % i, mesh, location, 'RIGID_BODY')
+        box.scale = (0.5, 0.5, 0.5)
+
+
+def _build_add_end_object(scene, mesh, templates, args):
+    template = _new_object(templates, "Template", mesh)
+    template.scale = (0.5, 0.5, 0.5)
+
+
+def _build_scenegraph_depth(scene, mesh, templates, args):
+    for chain in range(SCENEGRAPH_CHAINS):
+        parent = _new_object(scene.collection, "Root%d" % chain, mesh, (chain * 4.0, 0.0, 0.0))
+        for i in range(args["count"]):
+            child = _new_object(scene.collection, "Chain%d_%d" % (chain, i), mesh,
+                                (0.1, 0.0, 1.0))
+            child.parent = parent
+            parent = child
+
+
+def _build_scenegraph_width(scene, mesh, templates, args):
+    root = _new_object(scene.collection, "Root", mesh)
+    side = max(1, int(args["count"] ** 0.5))
+    for i in range(args["count"]):
+        child = _new_object(scene.collection, "Child%d" % i, mesh,
+                            ((i % side) * 2.0, (i // side) * 2.0, 0.0))
+        child.parent = root
+
+
+def _build_copies(scene, source, count):
+    # Copies keep the logic bricks, components and levels of detail of the source.
+    side = max(1, int(count ** 0.5))
+    for i in range(1, count):
+        copy = source.copy()
+        copy.name = "%s%d" % (source.name.rstrip("0123456789"), i)
+        copy.location = ((i % side) * 2.0, (i // side) * 2.0, 0.0)
+        if len(copy.lod_levels):
+            copy.lod_levels[0].object = copy
+        scene.collection.objects.link(copy)
+
+
+def _build_logic_bricks(scene, mesh, templates, args):
+    import bpy
+
+    source = _new_object(scene.collection, "Spinner0", mesh)
+    with bpy.context.temp_override(object=source, active_object=source):
+        bpy.ops.logic.sensor_add(type='ALWAYS', object=source.name)
+        bpy.ops.logic.controller_add(type='LOGIC_AND', object=source.name)
+        bpy.ops.logic.actuator_add(type='MOTION', object=source.name)
+
+    sensor = source.game.sensors[-1]
+    sensor.use_pulse_true_level = True
+    controller = source.game.controllers[-1]
+    actuator = source.game.actuators[-1]
+    actuator.offset_rotation = (0.0, 0.0, 0.01)
+    sensor.link(controller)
+    actuator.link(controller)
+
+    _build_copies(scene, source, args["count"])
+
+
+def _build_python_components(scene, mesh, templates, args):
+    import bpy
+
+    text = bpy.data.texts.new("bge_scenes_component.py")
+    text.from_string(args["component_script"])
+
+    source = _new_object(scene.collection, "Spinner0", mesh)
+    with bpy.context.temp_override(object=source, active_object=source):
+        bpy.ops.logic.python_component_register(component_name="bge_scenes_component.Spinner")
+
+    _build_copies(scene, source, args["count"])
+
+
+def _build_raycast_storm(scene, mesh, templates, args):
+    # Grid of static obstacles around the ray origin.
+    for x in range(-15, 16):
+        for y in range(-15, 16):
+            if abs(x) < 2 and abs(y) < 2:
+                continue
+            _new_object(scene.collection, "Obstacle%d_%d" % (x, y), mesh,
+                        (x * 6.0, y * 6.0, 0.0), 'STATIC')
+
+
+def _build_lod_forest(scene, mesh, templates, args):
+    import bpy
+
+    mid = _new_object(templates, "TreeMid", _icosphere("TreeMid", 2))
+    low = _new_object(templates, "TreeLow", _icosphere("TreeLow", 0))
+
+    source = _new_object(scene.collection, "Tree0", _icosphere("TreeHigh", 4))
+    with bpy.context.temp_override(object=source, active_object=source):
+        bpy.ops.object.lod_add()
+        bpy.ops.object.lod_add()
+    source.lod_levels[1].object = mid
+    source.lod_levels[1].distance = 20.0
+    source.lod_levels[2].object = low
+    source.lod_levels[2].distance = 60.0
+
+    _build_copies(scene, source, args["count"])
+
+    camera = scene.camera
+    camera.location = (-80.0, 0.0, 10.0)
+    camera.rotation_euler = (1.3, 0.0, -1.5708)
+
+
+def _build_libload_streaming(scene, mesh, templates, args):
+    import bpy
+
+    cell_scene = bpy.data.scenes.new("Cell")
+    objects = [_new_object(cell_scene.collection, "CellObject%d" % i, mesh, physics_type='STATIC')
+               for i in range(args["count"])]
+
+    cells_dir = pathlib.Path(args["filepath"]).parent / "cells"
+    cells_dir.mkdir(exist_ok=True)
+    size = args["cell_size"]
+    side = max(1, int(args["count"] ** 0.5))
+    for x in range(args["cells_x"]):
+        for y in range(-1, 2):
+            for i, ob in enumerate(objects):
+                ob.location = (x * size + (i % side) * size / side,
+                               y * size + (i // side) * size / side,
+                               0.0)
+            bpy.data.libraries.write(str(cells_dir / ("cell_%i_%i.blend" % (x, y))),
+                                     {cell_scene}, fake_user=True)
+
+    # Only the cell files contain the streamed objects.
+    bpy.data.scenes.remove(cell_scene)
+
+
+BUILDERS = {
+    "physics_stack": _build_physics_stack,
+    "add_end_object": _build_add_end_object,
+    "scenegraph_depth": _build_scenegraph_depth,
+    "scenegraph_width": _build_scenegraph_width,
+    "logic_bricks": _build_logic_bricks,
+    "python_components": _build_python_components,
+    "raycast_storm": _build_raycast_storm,
+    "lod_forest": _build_lod_forest,
+    "libload_streaming": _build_libload_streaming,
+}
+
+
+def _create_blend(args):
+    import bpy
+
+    blenderplayer.add_game_module()
+    text = bpy.data.texts.new("bge_scenes_bench.py")
+    text.from_string(args["script"])
+
+    scene = bpy.context.scene
+    scene.game_settings.use_frame_rate = False
+
+    cube = bpy.data.objects["Cube"]
+    mesh = cube.data
+    bpy.data.objects.remove(cube)
+
+    # Objects in a collection disabled in the viewport are inactive, used by AddObject and LoD.
+    templates = bpy.data.collections.new("Templates")
+    scene.collection.children.link(templates)
+    templates.hide_viewport = True
+
+    BUILDERS[args["scenario"]](scene, mesh, templates, args)
+
+    # Logic owner running the per frame work.
+    ob = _new_object(scene.collection, "Driver", None)
+    with bpy.context.temp_override(object=ob, active_object=ob):
+        bpy.ops.logic.sensor_add(type='ALWAYS', object=ob.name)
+        bpy.ops.logic.controller_add(type='PYTHON', object=ob.name)
+
+    sensor = ob.game.sensors[-1]
+    sensor.use_pulse_true_level = True
+    controller = ob.game.controllers[-1]
+    controller.mode = 'MODULE'
+    controller.module = "bge_scenes_bench.run"
+    sensor.link(controller)
+
+    bpy.ops.wm.save_as_mainfile(filepath=args["filepath"])
+    return {}
+
+
+def _write_input_record(filepath, frames):
+    # Input record without any input at a fixed frame rate, in the layout of the version
+    # INPUT_RECORD_VERSION of KX_InputRecorder. The player refuses a record of another version,
+    # and _read_timings checks that all the frames were replayed.
+    step = 1.0 / TICRATE
+    with open(filepath, "wb") as f:
+        f.write(struct.pack("=4sI", b"BGEI", INPUT_RECORD_VERSION))
+        for i in range(frames):
+            # Clock time, logic frames, time step, frame step and interpolation, followed by
+            # the number of input events, text characters and joystick logic frames.
+            f.write(struct.pack("=didddHHH", (i + 1) * step, 1, step, step, 1.0, 0, 0, 0))
+
+
+def _read_timings(filepath):
+    # Average time in seconds per frame of each profiling category, after the warmup.
+    if not filepath.exists():
+        raise Exception("Game ended without writing the timings")
+    with open(filepath) as f:
+        timings = json.load(f)
+
+    # A record not matching the layout of the player is replayed partially or not at all.
+    num_frames = len(timings["frames"])
+    if num_frames < WARMUP_FRAMES + MEASURE_FRAMES:
+        raise Exception("Replayed %d frames of %d, check the input record layout" %
+                        (num_frames, WARMUP_FRAMES + MEASURE_FRAMES))
+
+    frames = timings["frames"][WARMUP_FRAMES:]
+
+    totals = [frame["total"] / 1000.0 for frame in frames]
+    result = {
+        "time": statistics.mean(totals),
+        "time_median": statistics.median(totals),
+    }
+    for category in timings["categories"]:
+        result[category + "_time"] = statistics.mean(frame[category] for frame in frames) / 1000.0
+
+    return result
+
+
+def _check_baseline(env, name, result):
+    # The baselines are stored in the benchmark directory as they depend on the machine.
+    # The first run of a test, or a run with BGE_BENCHMARK_UPDATE_BASELINES set, stores
+    # its result as baseline.
+    filepath = pathlib.Path(env.base_dir) / "bge_baselines.json"
+    baselines = {}
+    if filepath.exists():
+        with open(filepath) as f:
+            baselines = json.load(f)
+
+    baseline = baselines.get(name)
+    if baseline is None or os.environ.get("BGE_BENCHMARK_UPDATE_BASELINES"):
+        baselines[name] = result
+        with open(filepath, "w") as f:
+            json.dump(baselines, f, indent=2, sort_keys=True)
+        # Not compared, reported to not be mistaken for a passing comparison.
+        print("\n%s: %s, result stored as baseline in %s" %
+              (name, "no baseline" if baseline is None else "baseline updated", filepath))
+        return
+
+    regressions = []
+    for key, value in sorted(result.items()):
+        base = baseline.get(key)
+        if base is None or max(value, base) < BASELINE_MIN_TIME:
+            continue
+        if value > base * (1.0 + BASELINE_TOLERANCE):
+            regressions.append("%s %.3fms > %.3fms" % (key, value * 1000.0, base * 1000.0))
+
+    if regressions:
+        raise Exception("regression over baseline: " + ", ".join(regressions))
+
+
+class BGESceneTest(blenderplayer.PlayerTest):
+    def __init__(self, scenario, count):
+        self.scenario = scenario
+        self.count = count
+
+    def name(self):
+        return "%s_%d" % (self.scenario, self.count)
+
+    def category(self):
+        return "bge"
+
+    def run(self, env, device_id):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            tmpdir = pathlib.Path(tmpdir)
+            config = {"scenario": self.scenario,
+                      "count": self.count,
+                      "cells_x": STREAMING_CELLS_X,
+                      "cell_size": STREAMING_CELL_SIZE,
+                      # Cross the cells during the replayed frames.
+                      "speed": STREAMING_CELLS_X * STREAMING_CELL_SIZE /
+                      (WARMUP_FRAMES + MEASURE_FRAMES)}
+            filepath = blenderplayer.create_game(env,
+                                                 tmpdir,
+                                                 _create_blend,
+                                                 {"script": GAME_SCRIPT,
+                                                  "component_script": COMPONENT_SCRIPT,
+                                                  "scenario": self.scenario,
+                                                  "count": self.count,
+                                                  "cells_x": STREAMING_CELLS_X,
+                                                  "cell_size": STREAMING_CELL_SIZE},
+                                                 config)
+
+            # The replayed frame clock runs the same logic frames on every machine and ends
+            # the game after the last frame.
+            record_path = tmpdir / "frames.bgei"
+            _write_input_record(record_path, WARMUP_FRAMES + MEASURE_FRAMES)
+            timings_path = tmpdir / "timings.json"
+
+            blenderplayer.run_game(env, filepath, [
+                "-g", "replay_input", "=", str(record_path),
+                "-g", "input_timings", "=", str(timings_path),
+                "-g", "fake_render", "=", "0" if self.scenario in RENDER_SCENES else "1"])
+            result = _read_timings(timings_path)
+
+        _check_baseline(env, self.name(), result)
+        return result
+
+
+def generate(env):
+    return [BGESceneTest(scenario, count) for scenario, counts in SCENES for count in counts]